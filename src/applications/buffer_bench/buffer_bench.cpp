@@ -0,0 +1,230 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Benchmark of the large buffer allocator.
+ *
+ * Streams samples through a ring buffer the size of the FFT ring, the way
+ * rx_fft_c does, and then reads it at random positions. This is done once
+ * with a buffer from the heap and once with one from large_buffer::alloc().
+ * For each stage the time and the number of page faults are printed, and on
+ * Linux the amount of memory backed by transparent huge pages.
+ *
+ * Build with -DBUILD_BUFFER_BENCH=ON. --prefault and --lock select the
+ * large_buffer flags; locking needs a sufficient memlock limit.
+ */
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "interfaces/large_buffer.h"
+
+typedef std::complex<float> sample_t;
+
+struct bench_options
+{
+    size_t  size_mb = 64;       /* same as the rx_fft_c ring */
+    int     chunk = 8192;       /* samples per work() call */
+    int     passes = 20;
+    int     reads = 10000000;
+    int     flags = 0;
+};
+
+struct stage_result
+{
+    double  ms;
+    long    faults;
+};
+
+static double now_ms(void)
+{
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static long minor_faults(void)
+{
+#ifndef _WIN32
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+#else
+    return 0;
+#endif
+}
+
+/* Memory backed by transparent huge pages in kB, -1 if unknown */
+static long anon_huge_kb(void)
+{
+    std::ifstream smaps("/proc/self/smaps_rollup");
+    std::string key;
+    long value;
+    while (smaps >> key >> value)
+    {
+        if (key == "AnonHugePages:")
+            return value;
+        smaps.ignore(256, '\n');
+    }
+    return -1;
+}
+
+template <typename F>
+static stage_result run_stage(F fn)
+{
+    long faults = minor_faults();
+    double start = now_ms();
+    fn();
+    return { now_ms() - start, minor_faults() - faults };
+}
+
+static void bench_buffer(const char *name, sample_t *ring, size_t nitems,
+                         const bench_options &opt, const stage_result &alloc)
+{
+    std::vector<sample_t> chunk(opt.chunk);
+    for (int i = 0; i < opt.chunk; i++)
+        chunk[i] = sample_t((float)i, -(float)i);
+
+    auto stream = [&]() {
+        for (size_t pos = 0; pos < nitems; pos += opt.chunk)
+        {
+            size_t n = std::min((size_t)opt.chunk, nitems - pos);
+            std::memcpy(ring + pos, chunk.data(), n * sizeof(sample_t));
+        }
+    };
+
+    stage_result first = run_stage(stream);
+    stage_result steady = run_stage([&]() {
+        for (int p = 0; p < opt.passes; p++)
+            stream();
+    });
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<size_t> dist(0, nitems - 1);
+    std::vector<size_t> offsets(4096);
+    for (auto &o : offsets)
+        o = dist(rng);
+
+    volatile float sink = 0.0f;
+    stage_result random = run_stage([&]() {
+        float acc = 0.0f;
+        for (int i = 0; i < opt.reads; i++)
+            acc += ring[(offsets[i & 4095] + (size_t)i * 4099) % nitems].real();
+        sink = acc;
+    });
+    (void) sink;
+
+    double bytes = (double)nitems * sizeof(sample_t) * opt.passes;
+    long huge_kb = anon_huge_kb();
+
+    std::printf("%-6s %10.2f %8ld %10.2f %8ld %10.2f %10.2f",
+                name, alloc.ms, alloc.faults, first.ms, first.faults,
+                bytes / steady.ms / 1e6, random.ms * 1e6 / opt.reads);
+    if (huge_kb >= 0)
+        std::printf(" %10ld", huge_kb / 1024);
+    std::printf("\n");
+}
+
+static void usage(const char *argv0)
+{
+    std::printf("Usage: %s [--size MB] [--chunk SAMPLES] [--passes N] "
+                "[--reads N] [--prefault] [--lock]\n", argv0);
+}
+
+int main(int argc, char *argv[])
+{
+    bench_options opt;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool has_value = (i + 1 < argc);
+
+        if (arg == "--size" && has_value)
+            opt.size_mb = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--chunk" && has_value)
+            opt.chunk = std::atoi(argv[++i]);
+        else if (arg == "--passes" && has_value)
+            opt.passes = std::atoi(argv[++i]);
+        else if (arg == "--reads" && has_value)
+            opt.reads = std::atoi(argv[++i]);
+        else if (arg == "--prefault")
+            opt.flags |= large_buffer::PREFAULT;
+        else if (arg == "--lock")
+            opt.flags |= large_buffer::LOCK;
+        else
+        {
+            usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (opt.size_mb == 0 || opt.chunk <= 0 || opt.passes <= 0 || opt.reads <= 0)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    size_t size = opt.size_mb * 1024 * 1024;
+    size_t nitems = size / sizeof(sample_t);
+    large_buffer::set_flags(opt.flags);
+
+    std::printf("ring %zu MB, %d samples per chunk, %d passes, %d random reads\n\n",
+                opt.size_mb, opt.chunk, opt.passes, opt.reads);
+    std::printf("%-6s %10s %8s %10s %8s %10s %10s %10s\n", "buffer",
+                "alloc ms", "faults", "first ms", "faults", "GB/s", "ns/read", "THP MB");
+
+    sample_t *heap = nullptr;
+    stage_result alloc = run_stage([&]() {
+        heap = static_cast<sample_t *>(std::malloc(size));
+    });
+    if (!heap)
+    {
+        std::fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    bench_buffer("heap", heap, nitems, opt, alloc);
+    std::free(heap);
+
+    sample_t *large = nullptr;
+    alloc = run_stage([&]() {
+        large = static_cast<sample_t *>(large_buffer::alloc(size));
+    });
+    if (!large)
+    {
+        std::fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    bench_buffer("large", large, nitems, opt, alloc);
+    large_buffer::dealloc(large, size);
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <QDebug>
+#include <QFileInfo>
+
+#include "applications/gqrx/decoder_plugins.h"
+
+#define POLL_INTERVAL_MS    100
+
+DecoderPlugins::DecoderPlugins(receiver *rx, QObject *parent) :
+    QObject(parent),
+    d_rx(rx)
+{
+    connect(&d_timer, SIGNAL(timeout()), this, SLOT(poll()));
+    d_timer.start(POLL_INTERVAL_MS);
+}
+
+DecoderPlugins::~DecoderPlugins()
+{
+    unloadAll();
+}
+
+void DecoderPlugins::readSettings(QSettings *settings)
+{
+    QStringList paths = settings->value("decoders/plugins").toStringList();
+    QString     error;
+
+    unloadAll();
+    for (const QString &path : paths)
+        if (load(path, &error) < 0)
+            qWarning() << "Decoder plugin" << path << ":" << error;
+}
+
+/**
+ * @brief Load a plugin library and start its decoder.
+ * @param path Path of the shared library.
+ * @param error Set to the reason if the plugin can not be loaded.
+ * @return The plugin id, -1 on error.
+ */
+int DecoderPlugins::load(const QString &path, QString *error)
+{
+    QLibrary   *lib = new QLibrary(path, this);
+    QString     reason;
+    int         id = -1;
+
+    auto create = (decoder_create_fn)lib->resolve("gqrx_decoder_create");
+    auto destroy = (decoder_destroy_fn)lib->resolve("gqrx_decoder_destroy");
+
+    if (!create || !destroy)
+    {
+        reason = lib->isLoaded() ? "Not a decoder plugin" : lib->errorString();
+    }
+    else
+    {
+        decoder_plugin *plugin = create(GQRX_DECODER_API_VERSION);
+
+        if (!plugin)
+        {
+            reason = QString("Plugin does not support API version %1")
+                     .arg(GQRX_DECODER_API_VERSION);
+        }
+        else
+        {
+            Plugin p;
+
+            p.name = QString::fromUtf8(plugin->name());
+            id = d_rx->add_decoder(plugin, destroy);
+            if (id < 0)
+            {
+                reason = "Plugin failed to start";
+                destroy(plugin);
+            }
+            else
+            {
+                p.id = id;
+                p.path = QFileInfo(path).absoluteFilePath();
+                p.lib = lib;
+                d_plugins.append(p);
+                qInfo() << "Loaded decoder plugin" << p.name << "from" << p.path;
+                return id;
+            }
+        }
+    }
+
+    if (error)
+        *error = reason;
+    lib->unload();
+    delete lib;
+
+    return -1;
+}
+
+/** Stop a plugin and unload its library. */
+bool DecoderPlugins::unload(int id)
+{
+    for (int i = 0; i < d_plugins.size(); i++)
+    {
+        if (d_plugins[i].id != id)
+            continue;
+
+        Plugin p = d_plugins.takeAt(i);
+
+        // The plugin is destroyed by code in the library
+        d_rx->remove_decoder(p.id);
+        p.lib->unload();
+        delete p.lib;
+
+        return true;
+    }
+
+    return false;
+}
+
+void DecoderPlugins::unloadAll()
+{
+    while (!d_plugins.isEmpty())
+        unload(d_plugins.first().id);
+}
+
+/** Loaded plugins as "<id> <name> <path>". */
+QStringList DecoderPlugins::list() const
+{
+    QStringList result;
+
+    for (const Plugin &p : d_plugins)
+        result << QString("%1 %2 %3").arg(p.id).arg(p.name).arg(p.path);
+
+    return result;
+}
+
+void DecoderPlugins::poll()
+{
+    decoder_pool::event ev;
+
+    while (d_rx->get_decoder_event(ev))
+        emit decoderEvent(ev.time_ms, QString::fromStdString(ev.name),
+                          QString::fromStdString(ev.type),
+                          QString::fromStdString(ev.text));
+}
@@ -0,0 +1,81 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef DECODER_PLUGINS_H
+#define DECODER_PLUGINS_H
+
+#include <QLibrary>
+#include <QList>
+#include <QObject>
+#include <QSettings>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include "applications/gqrx/receiver.h"
+
+/*! \brief Load decoder plugins from shared libraries.
+ *
+ * A plugin library exports gqrx_decoder_create() and gqrx_decoder_destroy()
+ * as declared in interfaces/decoder_plugin.h. The plugins run in the worker
+ * threads of the receiver; their events are polled from the GUI thread and
+ * emitted as decoderEvent().
+ *
+ * Settings in [decoders]: plugins, a list of library paths loaded at start.
+ */
+class DecoderPlugins : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DecoderPlugins(receiver *rx, QObject *parent = 0);
+    ~DecoderPlugins();
+
+    void readSettings(QSettings *settings);
+
+    int         load(const QString &path, QString *error = 0);
+    bool        unload(int id);
+    void        unloadAll();
+    QStringList list() const;
+
+signals:
+    void decoderEvent(qint64 time_ms, const QString &name, const QString &type,
+                      const QString &text);
+
+private slots:
+    void poll();
+
+private:
+    struct Plugin
+    {
+        int         id;     /*!< Id in the receiver. */
+        QString     name;
+        QString     path;
+        QLibrary   *lib;
+    };
+
+    receiver       *d_rx;
+    QList<Plugin>   d_plugins;
+    QTimer          d_timer;
+};
+
+#endif // DECODER_PLUGINS_H
@@ -0,0 +1,385 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include "applications/gqrx/input_frontend.h"
+#include "applications/gqrx/receiver.h"
+#include "interfaces/trace.h"
+
+#define SOURCE_BRIDGE_SIZE 262144
+
+/** Dummy device used when there is no input or it fails to open. */
+static std::string zero_device()
+{
+    return "file=" + receiver::escape_filename(receiver::get_zero_file()) +
+           ",freq=428e6,rate=96000,repeat=true,throttle=true";
+}
+
+/** Value of a key=value argument in a device string, empty if not present. */
+static std::string device_arg(const std::string &device, const std::string &key)
+{
+    size_t pos = 0;
+    while ((pos = device.find(key + "=", pos)) != std::string::npos)
+    {
+        if (pos == 0 || device[pos - 1] == ',')
+            break;
+        pos++;
+    }
+    if (pos == std::string::npos)
+        return "";
+
+    std::string value = device.substr(pos + key.size() + 1);
+    if (!value.empty() && value[0] == '\'')
+    {
+        /* undo escape_filename() */
+        std::string once, twice;
+        std::istringstream ss1(value);
+        ss1 >> std::quoted(once, '\'', '\\');
+        std::istringstream ss2(once);
+        ss2 >> std::quoted(twice, '\'', '\\');
+        return twice;
+    }
+
+    return value.substr(0, value.find(','));
+}
+
+/**
+ * @brief Create a front end.
+ * @param device Input device specifier, empty for a dummy source.
+ * @param decim Input decimation.
+ */
+input_frontend::input_frontend(const std::string &device, unsigned int decim)
+    : d_running(false),
+      d_input_rate(96000.0),
+      d_decim(decim),
+      d_int_format(0)
+{
+    d_tb = gr::make_top_block("gqrx_source");
+
+    if (device.empty())
+    {
+        d_src = osmosdr::source::make(zero_device());
+    }
+    else
+    {
+        d_devstr = device;
+        d_src = osmosdr::source::make(device);
+        open_int_source(device);
+    }
+
+    if (d_decim < 2)
+        d_decim = 1;
+
+    d_bridge = std::make_shared<source_bridge>(SOURCE_BRIDGE_SIZE);
+    d_bridge_sink = make_source_bridge_sink(d_bridge);
+    d_bridge_src = make_source_bridge_source(d_bridge);
+    connect_source();
+}
+
+input_frontend::~input_frontend()
+{
+    d_tb->stop();
+}
+
+/**
+ * @brief Select new input device.
+ * @param device The device specifier.
+ * @throws std::runtime_error if the device could not be opened. The front
+ *         end then runs on a dummy source.
+ *
+ * Only the front end flow graph is stopped and rebuilt; the new rate is
+ * applied with set_input_rate() before it is restarted.
+ */
+void input_frontend::set_device(const std::string &device)
+{
+    std::string error = "";
+
+    if (device.empty())
+        return;
+
+    d_devstr = device;
+
+    // d_tb->lock() can hang occasionally
+    if (d_running)
+    {
+        d_tb->stop();
+        d_tb->wait();
+    }
+
+    d_tb->disconnect_all();
+
+#if GNURADIO_VERSION < 0x030802
+    //Work around GNU Radio bug #3184
+    //temporarily connect dummy source to ensure that previous device is closed
+    d_src = osmosdr::source::make(zero_device());
+    d_tb->connect(d_src, 0, d_bridge_sink, 0);
+    d_tb->start();
+    d_tb->stop();
+    d_tb->wait();
+    d_tb->disconnect(d_src, 0, d_bridge_sink, 0);
+#else
+    d_src.reset();
+#endif
+
+    try
+    {
+        d_src = osmosdr::source::make(device);
+    }
+    catch (std::exception &x)
+    {
+        error = x.what();
+        d_src = osmosdr::source::make(zero_device());
+    }
+    open_int_source(error.empty() ? device : "");
+
+    if (d_src->get_sample_rate() != 0)
+        set_input_rate(d_src->get_sample_rate());
+
+    connect_source();
+    d_bridge->flush();
+
+    if (d_running)
+        d_tb->start();
+
+    if (error != "")
+    {
+        throw std::runtime_error(error);
+    }
+}
+
+/**
+ * @brief Set new input sample rate.
+ * @param rate The desired input rate
+ * @return The actual sample rate.
+ */
+double input_frontend::set_input_rate(double rate)
+{
+    double  current_rate;
+    bool    rate_has_changed;
+
+    current_rate = d_src->get_sample_rate();
+    rate_has_changed = !(rate == current_rate ||
+            std::abs(rate - current_rate) < std::abs(std::min(rate, current_rate))
+            * std::numeric_limits<double>::epsilon());
+
+    {
+        TRACE_SCOPE("src_tb->lock", "receiver");
+        d_tb->lock();
+    }
+    try
+    {
+        d_input_rate = d_src->set_sample_rate(rate);
+    }
+    catch (std::runtime_error &e)
+    {
+        d_input_rate = 0;
+    }
+
+    if (d_input_rate == 0)
+    {
+        // This can be the case when no device is attached and gr-osmosdr
+        // puts in a null_source with rate 100 ksps or if the rate has not
+        // changed
+        if (rate_has_changed)
+        {
+            std::cerr << std::endl;
+            std::cerr << "Failed to set RX input rate to " << rate << std::endl;
+            std::cerr << "Your device may not be working properly." << std::endl;
+            std::cerr << std::endl;
+        }
+        d_input_rate = rate;
+    }
+    if (d_int_throttle)
+        d_int_throttle->set_sample_rate(d_input_rate);
+    d_tb->unlock();
+
+    return d_input_rate;
+}
+
+/** Rebuild the front end with a new decimation. */
+void input_frontend::set_decim(unsigned int decim)
+{
+    if (d_running)
+    {
+        d_tb->stop();
+        d_tb->wait();
+    }
+
+    d_tb->disconnect_all();
+
+    d_decim = (decim >= 2) ? decim : 1;
+    connect_source();
+
+#ifdef CUSTOM_AIRSPY_KERNELS
+    if (d_devstr.find("airspy") != std::string::npos)
+        d_src->set_bandwidth(decim_rate());
+#endif
+
+    if (d_running)
+        d_tb->start();
+}
+
+void input_frontend::start()
+{
+    if (!d_running)
+    {
+        d_tb->start();
+        d_running = true;
+    }
+}
+
+void input_frontend::stop()
+{
+    if (d_running)
+    {
+        d_tb->stop();
+        d_tb->wait();
+        d_running = false;
+    }
+}
+
+/** Tune the device and tag the next sample delivered, see source_bridge. */
+void input_frontend::set_center_freq(double freq_hz)
+{
+    d_src->set_center_freq(freq_hz);
+    d_bridge->mark_retune(freq_hz);
+}
+
+/**
+ * @brief Seek in the input file.
+ * @param pos Sample position from the start of the file.
+ * @return False if the device is not a file or the seek failed.
+ */
+bool input_frontend::seek(long pos)
+{
+    bool ok;
+
+    {
+        TRACE_SCOPE("src_tb->lock", "receiver");
+        d_tb->lock();
+    }
+    ok = d_int_src ? d_int_src->seek(pos, SEEK_SET) : d_src->seek(pos, SEEK_SET);
+    d_bridge->flush();
+    d_tb->unlock();
+
+    return ok;
+}
+
+/**
+ * Connect device, input decimator and bridge.
+ *
+ * Only the decimator of the path in use is created. If the decimation can
+ * not be split into the available filter stages, decimation 1 is used.
+ */
+void input_frontend::connect_source()
+{
+    d_input_decim.reset();
+    d_int_decim.reset();
+
+    if (d_int_src)
+    {
+        /* the integer decimator also does the conversion to gr_complex */
+        try
+        {
+            d_int_decim = make_fir_decim_sc(d_int_format, d_decim);
+        }
+        catch (std::range_error &e)
+        {
+            std::cout << "Error creating input decimator " << d_decim
+                      << ": " << e.what() << std::endl
+                      << "Using decimation 1." << std::endl;
+            d_decim = 1;
+            d_int_decim = make_fir_decim_sc(d_int_format, 1);
+        }
+        d_tb->connect(d_int_src, 0, d_int_throttle, 0);
+        d_tb->connect(d_int_throttle, 0, d_int_decim, 0);
+        d_tb->connect(d_int_decim, 0, d_bridge_sink, 0);
+        return;
+    }
+
+    if (d_decim >= 2)
+    {
+        try
+        {
+            d_input_decim = make_fir_decim_cc(d_decim);
+        }
+        catch (std::range_error &e)
+        {
+            std::cout << "Error creating input decimator " << d_decim
+                      << ": " << e.what() << std::endl
+                      << "Using decimation 1." << std::endl;
+            d_decim = 1;
+        }
+    }
+
+    if (d_input_decim)
+    {
+        d_tb->connect(d_src, 0, d_input_decim, 0);
+        d_tb->connect(d_input_decim, 0, d_bridge_sink, 0);
+    }
+    else
+    {
+        d_tb->connect(d_src, 0, d_bridge_sink, 0);
+    }
+}
+
+/**
+ * Set up the integer front end for file=...,format=cs8|cu8|cs16 devices.
+ *
+ * gr-osmosdr only delivers gr_complex, so osmosdr's file source is kept as
+ * the control object while these samples are read by d_int_src and widened
+ * to gr_complex only after the first decimation stage. Any other device
+ * clears the integer front end.
+ */
+void input_frontend::open_int_source(const std::string &device)
+{
+    d_int_src.reset();
+    d_int_throttle.reset();
+    d_int_decim.reset();
+    d_int_format = 0;
+
+    std::string filename = device_arg(device, "file");
+    int format = fir_decim_int::format_from_string(device_arg(device, "format"));
+    if (filename.empty() || format < 0)
+        return;
+
+    size_t item_size = fir_decim_int::item_size(format);
+    double rate = d_src->get_sample_rate() > 0 ? d_src->get_sample_rate() : d_input_rate;
+    try
+    {
+        d_int_src = gr::blocks::file_source::make(item_size, filename.c_str(),
+                                                  device_arg(device, "repeat") == "true");
+    }
+    catch (std::exception &x)
+    {
+        std::cout << "Error opening " << filename << ": " << x.what() << std::endl;
+        return;
+    }
+    d_int_throttle = gr::blocks::throttle::make(item_size, rate);
+    d_int_format = format;
+}
@@ -0,0 +1,103 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INPUT_FRONTEND_H
+#define INPUT_FRONTEND_H
+
+#include <gnuradio/blocks/file_source.h>
+#include <gnuradio/blocks/throttle.h>
+#include <gnuradio/top_block.h>
+#include <osmosdr/source.h>
+#include <string>
+
+#include "dsp/filter/fir_decim.h"
+#include "interfaces/source_bridge.h"
+
+
+/**
+ * @brief One input source with its front end.
+ * @ingroup DSP
+ *
+ * Owns the device, the input decimator and the source_bridge, all running
+ * in a small flow graph of their own. The decimated samples are read from
+ * output() by a consumer flow graph, which keeps running while the device,
+ * rate or decimation are changed.
+ *
+ * The receiver has one front end for the demodulator chain and can run
+ * further ones for additional spectrum displays.
+ */
+class input_frontend
+{
+public:
+    input_frontend(const std::string &device, unsigned int decim);
+    ~input_frontend();
+
+    input_frontend(const input_frontend &) = delete;
+    input_frontend &operator=(const input_frontend &) = delete;
+
+    void set_device(const std::string &device);
+    const std::string &device() const { return d_devstr; }
+
+    /*! \brief The device, for settings not handled here. */
+    osmosdr::source::sptr src() const { return d_src; }
+    gr::top_block_sptr graph() const { return d_tb; }
+
+    double set_input_rate(double rate);
+    double input_rate() const { return d_input_rate; }
+    void set_decim(unsigned int decim);
+    unsigned int decim() const { return d_decim; }
+    double decim_rate() const { return d_input_rate / (double)d_decim; }
+
+    void start();
+    void stop();
+    bool is_running() const { return d_running; }
+
+    void set_center_freq(double freq_hz);
+    bool seek(long pos);
+    void flush() { d_bridge->flush(); }
+    uint64_t overflows() const { return d_bridge->overflows(); }
+    double backlog() const { return d_bridge->backlog(); }
+
+    source_bridge_source_sptr output() const { return d_bridge_src; }
+
+private:
+    void open_int_source(const std::string &device);
+    void connect_source();
+
+    bool            d_running;
+    std::string     d_devstr;
+    double          d_input_rate;
+    unsigned int    d_decim;
+
+    gr::top_block_sptr        d_tb;          /*!< src -> input_decim -> bridge. */
+    osmosdr::source::sptr     d_src;         /*!< Real time I/Q source. */
+    fir_decim_cc_sptr         d_input_decim; /*!< Input decimator. */
+    int                       d_int_format;  /*!< fir_decim_int format of d_int_src. */
+    gr::blocks::file_source::sptr d_int_src;      /*!< 8/16 bit I/Q file, replaces d_src. */
+    gr::blocks::throttle::sptr    d_int_throttle; /*!< Paces d_int_src at the input rate. */
+    fir_decim_sc_sptr         d_int_decim;   /*!< Integer front end of d_int_src. */
+    source_bridge_ptr         d_bridge;      /*!< FIFO to the consumer flow graph. */
+    source_bridge_sink_sptr   d_bridge_sink; /*!< End of the front end. */
+    source_bridge_source_sptr d_bridge_src;  /*!< Start of the consumer flow graph. */
+};
+
+#endif // INPUT_FRONTEND_H
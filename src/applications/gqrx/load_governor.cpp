@@ -0,0 +1,137 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include "applications/gqrx/load_governor.h"
+
+#define SETTLE_MS           2000    /* ignore the load for this long after a change */
+#define MIN_RESTORE_MS      10000
+#define MAX_RESTORE_MS      300000
+#define RESTORE_PROBE_MS    30000   /* pressure this soon after a restore backs off */
+#define BACKLOG_HIGH        0.5
+#define BACKLOG_LOW         0.1
+#define SLOW_RATIO          0.9f
+#define SLOW_UPDATES        3
+#define CALM_RATIO          0.97f
+#define MIN_FPS             5
+#define MIN_FFT_SIZE        2048
+
+LoadGovernor::LoadGovernor()
+    : d_enabled(true),
+      d_restore_delay_ms(MIN_RESTORE_MS)
+{
+    reset();
+}
+
+void LoadGovernor::readSettings(QSettings *settings)
+{
+    if (!settings)
+        return;
+
+    settings->beginGroup("load_governor");
+    d_enabled = settings->value("enabled", true).toBool();
+    settings->endGroup();
+
+    reset();
+}
+
+/*! \brief Back to full quality, e.g. when the DSP is started. */
+void LoadGovernor::reset()
+{
+    d_level = 0;
+    d_last_losses = ~(quint64)0;    // no losses counted on the first update
+    d_slow_updates = 0;
+    d_hold_until_ms = 0;
+    d_calm_since_ms = -1;
+    d_last_restore_ms = 0;
+}
+
+/*!
+ * \brief Feed the latest load indicators, about twice per second.
+ * \returns The new level.
+ */
+int LoadGovernor::update(const sample &s, qint64 now_ms)
+{
+    if (!d_enabled)
+        return d_level;
+
+    // Counters start over when the device or the recorder is replaced
+    bool loss = s.losses > d_last_losses;
+    d_last_losses = s.losses;
+
+    d_slow_updates = (s.frame_ratio < SLOW_RATIO) ? d_slow_updates + 1 : 0;
+
+    bool pressure = loss || s.backlog > BACKLOG_HIGH || d_slow_updates >= SLOW_UPDATES;
+    bool calm = !loss && s.backlog < BACKLOG_LOW && s.frame_ratio > CALM_RATIO;
+
+    // Losses are acted on at once, the other indicators need time to
+    // follow the last change.
+    if (pressure && d_level < MAX_LEVEL && (loss || now_ms >= d_hold_until_ms))
+    {
+        if (d_last_restore_ms > 0 && now_ms - d_last_restore_ms < RESTORE_PROBE_MS)
+            d_restore_delay_ms = qMin(d_restore_delay_ms * 2, (qint64)MAX_RESTORE_MS);
+
+        d_level++;
+        d_slow_updates = 0;
+        d_calm_since_ms = -1;
+        d_hold_until_ms = now_ms + SETTLE_MS;
+        return d_level;
+    }
+
+    if (!calm)
+    {
+        d_calm_since_ms = -1;
+        return d_level;
+    }
+    if (d_calm_since_ms < 0)
+        d_calm_since_ms = now_ms;
+
+    if (d_level > 0 && now_ms - d_calm_since_ms >= d_restore_delay_ms)
+    {
+        d_level--;
+        d_last_restore_ms = now_ms;
+        d_calm_since_ms = now_ms;
+        d_hold_until_ms = now_ms + SETTLE_MS;
+    }
+    else if (d_level == 0 && now_ms - d_calm_since_ms >= MAX_RESTORE_MS)
+    {
+        // Stable for long enough, forget the earlier back-offs
+        d_restore_delay_ms = MIN_RESTORE_MS;
+    }
+
+    return d_level;
+}
+
+/*! \brief Spectrum frame rate to use instead of the one set by the user. */
+int LoadGovernor::frameRate(int fps) const
+{
+    int div = (d_level >= 2) ? 4 : (d_level >= 1) ? 2 : 1;
+
+    return qMax(fps / div, qMin(fps, MIN_FPS));
+}
+
+/*! \brief FFT size to use instead of the one set by the user. */
+int LoadGovernor::fftSize(int size) const
+{
+    int div = (d_level >= 4) ? 4 : (d_level >= 3) ? 2 : 1;
+
+    return qMax(size / div, qMin(size, MIN_FFT_SIZE));
+}
@@ -0,0 +1,86 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef LOAD_GOVERNOR_H
+#define LOAD_GOVERNOR_H
+
+#include <QSettings>
+#include <QtGlobal>
+
+/*! \brief Shed display load when the DSP does not keep up.
+ *
+ * The audio, the recorders and the display all compete for the same CPU.
+ * When the DSP falls behind the input, samples are dropped at the input
+ * FIFO and the audio underruns, so the governor gives up display quality
+ * first, one level at a time, in this order:
+ *
+ *   1, 2  spectrum frame rate halved, quartered (not below 5 fps)
+ *   3, 4  FFT size halved, quartered (not below 2048)
+ *   5     histogram plot mode and peak detection off
+ *   6     fewer waterfall lines
+ *
+ * Pressure is input or recorder samples lost, an input FIFO more than half
+ * full, or the spectrum missing its frame rate for several updates in a
+ * row. A level is given back after the load has been low for a while; if
+ * the pressure returns soon after, the next attempt waits twice as long.
+ *
+ * Settings in [load_governor]: enabled.
+ */
+class LoadGovernor
+{
+public:
+    static const int MAX_LEVEL = 6;
+
+    /*! \brief Load indicators, sampled by update(). */
+    struct sample
+    {
+        float   frame_ratio;  /*!< Spectrum frame rate relative to the wanted one. */
+        double  backlog;      /*!< Fraction of the input FIFO in use. */
+        quint64 losses;       /*!< Samples or blocks lost so far, any counter. */
+    };
+
+    LoadGovernor();
+
+    void readSettings(QSettings *settings);
+    bool isEnabled() const { return d_enabled; }
+
+    void reset();
+    int  update(const sample &s, qint64 now_ms);
+    int  level() const { return d_level; }
+
+    int  frameRate(int fps) const;
+    int  fftSize(int size) const;
+    bool shedHistogram() const { return d_level >= 5; }
+    bool shedWaterfall() const { return d_level >= 6; }
+
+private:
+    bool    d_enabled;
+    int     d_level;
+    quint64 d_last_losses;
+    int     d_slow_updates;     /*!< Consecutive updates below the frame rate. */
+    qint64  d_hold_until_ms;    /*!< Let the last change settle until then. */
+    qint64  d_calm_since_ms;    /*!< Start of the current low load period, -1 if none. */
+    qint64  d_last_restore_ms;
+    qint64  d_restore_delay_ms; /*!< Low load time needed to give back a level. */
+};
+
+#endif // LOAD_GOVERNOR_H
@@ -39,6 +39,7 @@
 
 #include "mainwindow.h"
 #include "gqrx.h"
+#include "interfaces/large_buffer.h"
 
 #include <iostream>
 
@@ -86,6 +87,7 @@ int main(int argc, char *argv[])
         {{"c", "conf"}, "Start with this config file", "file"},
         {{"e", "edit"}, "Edit the config file before using it"},
         {{"r", "reset"}, "Reset configuration file"},
+        {"lock-buffers", "Pre-fault and lock the large sample buffers in memory"},
     });
     parser.process(app);
 
@@ -98,6 +100,9 @@ int main(int argc, char *argv[])
         return 0;
     }
 
+    if (parser.isSet("lock-buffers"))
+        large_buffer::set_flags(large_buffer::PREFAULT | large_buffer::LOCK);
+
     // check whether audio backend is functional
 #ifdef WITH_PORTAUDIO
     PaError     err = Pa_Initialize();
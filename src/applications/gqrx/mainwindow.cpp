@@ -21,6 +21,7 @@
  * the Free Software Foundation, Inc., 51 Franklin Street,
  * Boston, MA 02110-1301, USA.
  */
+#include <limits>
 #include <string>
 #include <vector>
 #include <volk/volk.h>
@@ -32,6 +33,7 @@
 #include <QDialogButtonBox>
 #include <QFile>
 #include <QGroupBox>
+#include <QInputDialog>
 #include <QJsonDocument>
 #include <QKeySequence>
 #include <QLineEdit>
@@ -57,6 +59,7 @@
 
 /* DSP */
 #include "receiver.h"
+#include "interfaces/trace.h"
 #include "remote_control_settings.h"
 
 #include "qtgui/bookmarkstaglist.h"
@@ -117,12 +120,31 @@ MainWindow::MainWindow(const QString& cfgfile, bool edit_conf, QWidget *parent)
     // remote controller
     remote = new RemoteControl();
 
+    /* decoder plugins, loaded in loadConfig() */
+    decoder_plugins = new DecoderPlugins(rx);
+    connect(decoder_plugins, SIGNAL(decoderEvent(qint64,QString,QString,QString)),
+            this, SLOT(logDecoderEvent(qint64,QString,QString,QString)));
+    connect(decoder_plugins, SIGNAL(decoderEvent(qint64,QString,QString,QString)),
+            remote, SLOT(addDecoderEvent(qint64,QString,QString,QString)));
+
+    /* spectrum aggregation, configured in loadConfig() */
+    spectrum_pub = new SpectrumPublisher(this);
+    spectrum_col = new SpectrumCollector(this);
+    d_mergedDock = nullptr;
+    d_mergedPlotter = nullptr;
+    connect(spectrum_col, SIGNAL(newSpectrum(qint64,double,QVector<float>)),
+            this, SLOT(setMergedSpectrum(qint64,double,QVector<float>)));
+    connect(spectrum_col, SIGNAL(newEvent(QString,qint64,float,bool)),
+            this, SLOT(logSpectrumEvent(QString,qint64,float,bool)));
+
     /* meter timer */
     meter_timer = new QTimer(this);
     connect(meter_timer, SIGNAL(timeout()), this, SLOT(meterTimeout()));
 
     /* FFT timer & data */
     d_iqFftData.resize(receiver::DEFAULT_FFT_SIZE);
+    d_fftSize = receiver::DEFAULT_FFT_SIZE;
+    d_fps = 0.0f;
     iq_fft_timer = new QTimer(this);
     iq_fft_timer->setTimerType(Qt::PreciseTimer);
     connect(iq_fft_timer, SIGNAL(timeout()), this, SLOT(iqFftTimeout()));
@@ -134,6 +156,14 @@ MainWindow::MainWindow(const QString& cfgfile, bool edit_conf, QWidget *parent)
     audio_fft_timer = new QTimer(this);
     connect(audio_fft_timer, SIGNAL(timeout()), this, SLOT(audioFftTimeout()));
 
+    /* time domain scope, runs only while it is shown */
+    scope_timer = new QTimer(this);
+    connect(scope_timer, SIGNAL(timeout()), this, SLOT(scopeTimeout()));
+
+    /* load governor, runs while the DSP is running */
+    governor_timer = new QTimer(this);
+    connect(governor_timer, SIGNAL(timeout()), this, SLOT(governorTimeout()));
+
     /* timer for data decoders */
     dec_timer = new QTimer(this);
     connect(dec_timer, SIGNAL(timeout()), this, SLOT(decoderTimeout()));
@@ -150,6 +180,7 @@ MainWindow::MainWindow(const QString& cfgfile, bool edit_conf, QWidget *parent)
     uiDockAudio = new DockAudio();
     uiDockInputCtl = new DockInputCtl();
     uiDockFft = new DockFft();
+    uiDockScope = new DockScope();
     BandPlan::Get().setConfigDir(m_cfg_dir);
     Bookmarks::Get().setConfigDir(m_cfg_dir);
     BandPlan::Get().load();
@@ -200,10 +231,12 @@ MainWindow::MainWindow(const QString& cfgfile, bool edit_conf, QWidget *parent)
     uiDockAudio->raise();
 
     addDockWidget(Qt::BottomDockWidgetArea, uiDockBookmarks);
+    addDockWidget(Qt::BottomDockWidgetArea, uiDockScope);
 
     /* hide docks that we don't want to show initially */
     uiDockBookmarks->hide();
     uiDockRDS->hide();
+    uiDockScope->hide();
 
     /* Add dock widget actions to View menu. By doing it this way all signal/slot
        connections will be established automagially.
@@ -211,6 +244,7 @@ MainWindow::MainWindow(const QString& cfgfile, bool edit_conf, QWidget *parent)
     ui->menu_View->addAction(uiDockInputCtl->toggleViewAction());
     ui->menu_View->addAction(uiDockRxOpt->toggleViewAction());
     ui->menu_View->addAction(uiDockRDS->toggleViewAction());
+    ui->menu_View->addAction(uiDockScope->toggleViewAction());
     ui->menu_View->addAction(uiDockAudio->toggleViewAction());
     ui->menu_View->addAction(uiDockFft->toggleViewAction());
     ui->menu_View->addAction(uiDockBookmarks->toggleViewAction());
@@ -299,6 +333,8 @@ MainWindow::MainWindow(const QString& cfgfile, bool edit_conf, QWidget *parent)
     connect(uiDockFft, SIGNAL(fftMinHoldToggled(bool)), ui->plotter, SLOT(enableMinHold(bool)));
     connect(uiDockFft, SIGNAL(peakDetectToggled(bool)), ui->plotter, SLOT(enablePeakDetect(bool)));
     connect(uiDockRDS, SIGNAL(rdsDecoderToggled(bool)), this, SLOT(setRdsDecoder(bool)));
+    connect(uiDockScope, SIGNAL(sourceChanged(int)), this, SLOT(setScopeSource(int)));
+    connect(uiDockScope, SIGNAL(visibilityChanged(bool)), this, SLOT(scopeVisibilityChanged(bool)));
 
     // Plotter
     connect(ui->plotter, SIGNAL(pandapterRangeChanged(float,float)),
@@ -320,7 +356,7 @@ MainWindow::MainWindow(const QString& cfgfile, bool edit_conf, QWidget *parent)
     // I/Q playback
     connect(iq_tool, SIGNAL(startRecording(QString, QString)), this, SLOT(startIqRecording(QString, QString)));
     connect(iq_tool, SIGNAL(stopRecording()), this, SLOT(stopIqRecording()));
-    connect(iq_tool, SIGNAL(startPlayback(QString,float,qint64)), this, SLOT(startIqPlayback(QString,float,qint64)));
+    connect(iq_tool, SIGNAL(startPlayback(QString,float,qint64,QString)), this, SLOT(startIqPlayback(QString,float,qint64,QString)));
     connect(iq_tool, SIGNAL(stopPlayback()), this, SLOT(stopIqPlayback()));
     connect(iq_tool, SIGNAL(seek(qint64)), this,SLOT(seekIqFile(qint64)));
 
@@ -343,6 +379,17 @@ MainWindow::MainWindow(const QString& cfgfile, bool edit_conf, QWidget *parent)
     connect(remote, SIGNAL(newPassband(int)), this, SLOT(setPassband(int)));
     connect(remote, SIGNAL(gainChanged(QString, double)), uiDockInputCtl, SLOT(setGain(QString,double)));
     connect(remote, SIGNAL(dspChanged(bool)), this, SLOT(on_actionDSP_triggered(bool)));
+    connect(remote, SIGNAL(batchChanged(bool)), this, SLOT(setBatchUpdate(bool)));
+    connect(remote, SIGNAL(traceChanged(bool)), this, SLOT(setTracing(bool)));
+    connect(remote, SIGNAL(newInputSource(QString)), this, SLOT(addInputSource(QString)));
+    connect(remote, SIGNAL(removeInputSource(int)), this, SLOT(removeInputSource(int)));
+    connect(remote, SIGNAL(newSourceFrequency(int,qint64)), this, SLOT(setSourceFrequency(int,qint64)));
+    connect(remote, SIGNAL(newSnapshot(int,qint64,double)), this, SLOT(saveIqSnapshot(int,qint64,double)));
+    connect(remote, SIGNAL(removeDecoder(int)), this, SLOT(unloadDecoder(int)));
+    connect(remote, SIGNAL(newVfoChannel(qint64,int,double,bool)), this, SLOT(addVfoChannel(qint64,int,double,bool)));
+    connect(remote, SIGNAL(removeVfoChannel(int)), this, SLOT(removeVfoChannel(int)));
+    connect(remote, SIGNAL(newFreqRamp(double,double,double)), this, SLOT(setFreqRamp(double,double,double)));
+    connect(remote, SIGNAL(stopFreqRamp()), this, SLOT(stopFreqRamp()));
     connect(uiDockRDS, SIGNAL(rdsPI(QString)), remote, SLOT(rdsPI(QString)));
 
     rds_timer = new QTimer(this);
@@ -408,6 +455,12 @@ MainWindow::~MainWindow()
     audio_fft_timer->stop();
     delete audio_fft_timer;
 
+    scope_timer->stop();
+    delete scope_timer;
+
+    governor_timer->stop();
+    delete governor_timer;
+
     if (m_settings)
     {
         m_settings->setValue("configversion", 4);
@@ -440,6 +493,8 @@ MainWindow::~MainWindow()
     delete uiDockFft;
     delete uiDockInputCtl;
     delete uiDockRDS;
+    delete uiDockScope;
+    delete decoder_plugins;
     delete rx;
     delete remote;
     delete qsvg_dummy;
@@ -464,6 +519,7 @@ bool MainWindow::loadConfig(const QString& cfgfile, bool check_crash,
                             bool restore_mainwindow)
 {
     double      actual_rate;
+    double      double_val;
     qint64      int64_val;
     int         int_val;
     bool        bool_val;
@@ -518,6 +574,9 @@ bool MainWindow::loadConfig(const QString& cfgfile, bool check_crash,
     if (skip_loading_cfg)
         return false;
 
+    // Apply flow graph changes once at the end
+    rx->begin_update();
+
     // manual reconf (FIXME: check status)
     conv_ok = false;
 
@@ -658,6 +717,7 @@ bool MainWindow::loadConfig(const QString& cfgfile, bool check_crash,
     uiDockInputCtl->readSettings(m_settings); // this will also update freq range
     uiDockRxOpt->readSettings(m_settings);
     uiDockFft->readSettings(m_settings);
+    uiDockScope->readSettings(m_settings);
     uiDockAudio->readSettings(m_settings);
     dxc_options->readSettings(m_settings);
 
@@ -695,8 +755,56 @@ bool MainWindow::loadConfig(const QString& cfgfile, bool check_crash,
         }
     }
 
+    // Split I/Q and audio recordings into files of this many seconds
+    double_val = m_settings->value("receiver/record_rollover", 0.0).toDouble(&conv_ok);
+    rx->set_recording_rollover(conv_ok ? double_val : 0.0);
+
+    // Time for the tuner to settle after a retune, the spectrum ignores it
+    double_val = m_settings->value("input/retune_settle", 0.0).toDouble(&conv_ok);
+    rx->set_retune_settle(conv_ok ? double_val : 0.0);
+
+    rx->commit_update();
+
+    // The device only gets the rate at the commit and may have adjusted it
+    if (actual_rate > 0.)
+    {
+        double committed_rate = rx->get_input_rate() / (double)rx->get_input_decim();
+
+        if (committed_rate != actual_rate)
+        {
+            uiDockRxOpt->setFilterOffsetRange((qint64)(committed_rate));
+            uiDockFft->setSampleRate(committed_rate);
+            ui->plotter->setSampleRate(committed_rate);
+            ui->plotter->setSpanFreq((quint32)committed_rate);
+            remote->setBandwidth((qint64)committed_rate);
+            iq_tool->setSampleRate((qint64)committed_rate);
+        }
+    }
+
+    // Size of the I/Q snapshot rings, optionally shared with other programs
+    {
+        qint64 bb_size = m_settings->value("snapshot/baseband_size",
+                                           (qint64)receiver::DEFAULT_SNAPSHOT_BB).toLongLong();
+        qint64 ch_size = m_settings->value("snapshot/channel_size",
+                                           (qint64)receiver::DEFAULT_SNAPSHOT_CH).toLongLong();
+        bool shared = m_settings->value("snapshot/shared_memory", false).toBool();
+
+        rx->set_snapshot_buffers((size_t)qMax(bb_size, (qint64)1),
+                                 (size_t)qMax(ch_size, (qint64)1), shared);
+    }
+
     iq_tool->readSettings(m_settings);
 
+    spectrum_pub->readSettings(m_settings);
+    spectrum_col->readSettings(m_settings);
+
+    decoder_plugins->readSettings(m_settings);
+    remote->setDecoders(decoder_plugins->list());
+
+    int_val = governor.level();
+    governor.readSettings(m_settings);
+    applyLoadLevel(int_val);
+
     /*
      * Initialization the remote control at the end.
      * We must be sure that all variables initialized before starting RC server.
@@ -785,6 +893,7 @@ void MainWindow::storeSession()
         uiDockRxOpt->saveSettings(m_settings);
         uiDockFft->saveSettings(m_settings);
         uiDockAudio->saveSettings(m_settings);
+        uiDockScope->saveSettings(m_settings);
 
         remote->saveSettings(m_settings);
         iq_tool->saveSettings(m_settings);
@@ -1462,16 +1571,21 @@ double MainWindow::setSqlLevelAuto()
 /** Signal strength meter timeout. */
 void MainWindow::meterTimeout()
 {
+    TRACE_SCOPE("MainWindow::meterTimeout", "timer");
     float level;
 
     level = rx->get_signal_pwr();
     ui->sMeter->setLevel(level);
     remote->setSignalLevel(level);
+    remote->setSettleTime(rx->get_retune_settle_time());
+    if (rx->num_vfo_channels() > 0)
+        updateRemoteChannels();
 }
 
 /** Baseband FFT plot timeout. */
 void MainWindow::iqFftTimeout()
 {
+    TRACE_SCOPE("MainWindow::iqFftTimeout", "timer");
     const unsigned int fftsize = rx->iq_fft_size();
 
     if (fftsize == 0)
@@ -1504,12 +1618,25 @@ void MainWindow::iqFftTimeout()
     d_last_fft_ms = now_ms;
 
     if (rx->get_iq_fft_data(d_iqFftData.data()) >= 0)
+    {
         ui->plotter->setNewFftData(d_iqFftData.data(), fftsize);
+        if (spectrum_pub->isEnabled())
+            spectrum_pub->publish(d_lnb_lo + d_hw_freq, rx->get_quad_rate(),
+                                  d_iqFftData.data(), fftsize);
+    }
+
+    for (int i = 0; i < d_sourcePlotters.size(); i++)
+    {
+        if (d_sourceDocks[i]->isVisible() &&
+            rx->get_source_fft_data(i + 1, d_iqFftData.data()) >= 0)
+            d_sourcePlotters[i]->setNewFftData(d_iqFftData.data(), fftsize);
+    }
 }
 
 /** Audio FFT plot timeout. */
 void MainWindow::audioFftTimeout()
 {
+    TRACE_SCOPE("MainWindow::audioFftTimeout", "timer");
     const unsigned int fftsize = rx->audio_fft_size();
 
     if (fftsize == 0)
@@ -1526,9 +1653,29 @@ void MainWindow::audioFftTimeout()
         uiDockAudio->setNewFftData(d_audioFftData.data(), fftsize);
 }
 
+/** Time domain scope timeout. */
+void MainWindow::scopeTimeout()
+{
+    TRACE_SCOPE("MainWindow::scopeTimeout", "timer");
+
+    if (!uiDockScope->isVisible())
+        return;
+
+    const int pixels = uiDockScope->pixels();
+    d_scopeMins.resize(pixels);
+    d_scopeMaxs.resize(pixels);
+
+    int n = rx->get_scope_data(uiDockScope->span(), pixels, d_scopeMins.data(),
+                               d_scopeMaxs.data(), uiDockScope->triggerMode(),
+                               uiDockScope->triggerLevel());
+    if (n > 0)
+        uiDockScope->setData(d_scopeMins.data(), d_scopeMaxs.data(), n);
+}
+
 /** RDS message display timeout. */
 void MainWindow::rdsTimeout()
 {
+    TRACE_SCOPE("MainWindow::rdsTimeout", "timer");
     std::string buffer;
     int num;
 
@@ -1646,25 +1793,7 @@ void MainWindow::startIqRecording(const QString& recdir, const QString& format)
     QFile metaFile(filenameTemplate.arg("sigmf-meta"));
     bool ok = true;
     if (sigmf) {
-        auto meta = QJsonDocument { QJsonObject {
-            {"global", QJsonObject {
-#if Q_BYTE_ORDER == Q_BIG_ENDIAN
-                {"core:datatype", "cf32_be"},
-#else
-                {"core:datatype", "cf32_le"},
-#endif
-                {"core:sample_rate", sr/dec},
-                {"core:version", "1.0.0"},
-                {"core:recorder", "Gqrx " VERSION},
-                {"core:hw", QString("OsmoSDR: ") + m_settings->value("input/device", "").toString()},
-            }}, {"captures", QJsonArray {
-                QJsonObject {
-                    {"core:sample_start", 0},
-                    {"core:frequency", freq},
-                    {"core:datetime", currentDate.toString(Qt::ISODateWithMs)},
-                },
-            }}, {"annotations", QJsonArray {}},
-        }}.toJson();
+        auto meta = sigmfMeta(sr/dec, freq, currentDate);
 
         if (!metaFile.open(QIODevice::WriteOnly) || metaFile.write(meta) != meta.size()) {
             ok = false;
@@ -1696,6 +1825,76 @@ void MainWindow::startIqRecording(const QString& recdir, const QString& format)
     }
 }
 
+/** SigMF metadata for a cf32 recording starting at the given time. */
+QByteArray MainWindow::sigmfMeta(qint64 sample_rate, qint64 freq, const QDateTime &start) const
+{
+    return QJsonDocument { QJsonObject {
+        {"global", QJsonObject {
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+            {"core:datatype", "cf32_be"},
+#else
+            {"core:datatype", "cf32_le"},
+#endif
+            {"core:sample_rate", sample_rate},
+            {"core:version", "1.0.0"},
+            {"core:recorder", "Gqrx " VERSION},
+            {"core:hw", QString("OsmoSDR: ") + m_settings->value("input/device", "").toString()},
+        }}, {"captures", QJsonArray {
+            QJsonObject {
+                {"core:sample_start", 0},
+                {"core:frequency", freq},
+                {"core:datetime", start.toString(Qt::ISODateWithMs)},
+            },
+        }}, {"annotations", QJsonArray {}},
+    }}.toJson();
+}
+
+/**
+ * Save recent I/Q samples from a snapshot ring as a SigMF recording in the
+ * I/Q recording directory, and tell the remote control where it went.
+ *
+ * @param source A receiver::snapshot_source.
+ * @param samples Number of samples.
+ * @param time UNIX time in seconds to center the snapshot on, negative for
+ *             the latest samples.
+ */
+void MainWindow::saveIqSnapshot(int source, qint64 samples, double time)
+{
+    std::vector<gr_complex> iq;
+    iq_ring::info meta;
+
+    remote->setSnapshotFile(QString());
+    if (!rx->get_snapshot((receiver::snapshot_source)source, (size_t)samples,
+                          time < 0.0 ? -1 : (int64_t)(time * 1.e9), iq, meta))
+        return;
+
+    auto recdir = m_settings->value("baseband/rec_dir", QDir::homePath()).toString();
+    auto start = QDateTime::fromMSecsSinceEpoch(meta.time_ns / 1000000, Qt::UTC);
+    auto freq = qRound64(meta.center_freq);
+    auto sr = qRound64(meta.sample_rate);
+    auto filenameTemplate = start.toString("%1/gqrx_yyyyMMdd_hhmmss_zzz_%2_%3_snap.%4")
+                                 .arg(recdir).arg(freq).arg(sr);
+    auto dataPath = filenameTemplate.arg("sigmf-data");
+
+    QFile metaFile(filenameTemplate.arg("sigmf-meta"));
+    QFile dataFile(dataPath);
+    auto metaData = sigmfMeta(sr, freq, start);
+    qint64 size = (qint64)(iq.size() * sizeof(gr_complex));
+
+    if (!dataFile.open(QIODevice::WriteOnly) ||
+        dataFile.write((const char *)iq.data(), size) != size ||
+        !metaFile.open(QIODevice::WriteOnly) ||
+        metaFile.write(metaData) != metaData.size())
+    {
+        qWarning() << "Failed to save I/Q snapshot to" << dataPath;
+        dataFile.remove();
+        metaFile.remove();
+        return;
+    }
+
+    remote->setSnapshotFile(dataPath);
+}
+
 /** Stop current I/Q recording. */
 void MainWindow::stopIqRecording()
 {
@@ -1707,8 +1906,27 @@ void MainWindow::stopIqRecording()
         ui->statusBar->showMessage(tr("I/Q data recoding stopped"), 5000);
 }
 
-void MainWindow::startIqPlayback(const QString& filename, float samprate, qint64 center_freq)
+void MainWindow::startIqPlayback(const QString& filename, float samprate, qint64 center_freq,
+                                 const QString& datatype)
 {
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    const char *native_cf32 = "cf32_be";
+#else
+    const char *native_cf32 = "cf32_le";
+#endif
+    // 8 and 16 bit files are read by the integer front end of the receiver,
+    // everything else is read as native complex float
+    bool is_int = (datatype == "ci8" || datatype == "cu8" || datatype == "ci16_le");
+
+    if (!is_int && !datatype.isEmpty() && datatype != "cf32" && datatype != native_cf32)
+    {
+        QMessageBox::warning(this, tr("I/Q playback"),
+                             tr("Can not play %1: the sample format %2 is not supported.")
+                             .arg(filename).arg(datatype));
+        iq_tool->cancelPlayback();
+        return;
+    }
+
     if (ui->actionDSP->isChecked())
     {
         // suspend DSP while we reload settings
@@ -1723,6 +1941,8 @@ void MainWindow::startIqPlayback(const QString& filename, float samprate, qint64
     QString escapedFilename = receiver::escape_filename(filename.toStdString()).c_str();
     auto devstr = QString("file=%1,rate=%2,freq=%3,throttle=true,repeat=false")
             .arg(escapedFilename).arg(sri).arg(cf);
+    if (is_int)
+        devstr += QString(",format=%1").arg(datatype);
 
     qDebug() << __func__ << ":" << devstr;
 
@@ -1815,6 +2035,9 @@ void MainWindow::seekIqFile(qint64 seek_pos)
 /** FFT size has changed. */
 void MainWindow::setIqFftSize(int size)
 {
+    d_fftSize = size;
+    size = governor.fftSize(size);
+
     qDebug() << "Changing baseband FFT size to" << size;
     d_iqFftData.resize(size);
     d_iqFftData.shrink_to_fit();
@@ -1827,6 +2050,7 @@ void MainWindow::setIqFftRate(int fps)
     int interval;
 
     d_fps = fps;
+    fps = governor.frameRate(fps);
 
     if (fps == 0)
     {
@@ -1842,10 +2066,20 @@ void MainWindow::setIqFftRate(int fps)
             ui->plotter->setRunningState(true);
     }
 
+    for (auto *plotter : d_sourcePlotters)
+    {
+        if (fps > 0)
+            plotter->setFftRate(fps);
+        plotter->setRunningState(fps > 0 && iq_fft_timer->isActive());
+    }
+
     // Limit to 500 fps
     if (interval > 1 && iq_fft_timer->isActive())
         iq_fft_timer->setInterval(interval);
 
+    // The timer runs at whole milliseconds
+    rx->set_iq_fft_rate(fps == 0 ? 0.0f : 1000.0f / qMax(interval, 2));
+
     uiDockFft->setWfResolution(ui->plotter->getWfTimeRes());
 
     // Invalidate average frame rate
@@ -1941,9 +2175,15 @@ void MainWindow::on_actionDSP_triggered(bool checked)
         /* start GUI timers */
         meter_timer->start(100);
 
+        int level = governor.level();
+        governor.reset();
+        applyLoadLevel(level);
+        if (governor.isEnabled())
+            governor_timer->start(500);
+
         if (uiDockFft->fftRate())
         {
-            iq_fft_timer->start(1000/uiDockFft->fftRate());
+            iq_fft_timer->start(1000/governor.frameRate(uiDockFft->fftRate()));
             ui->plotter->setRunningState(true);
         }
         else
@@ -1953,6 +2193,8 @@ void MainWindow::on_actionDSP_triggered(bool checked)
         }
 
         audio_fft_timer->start(40);
+        if (uiDockScope->source() != receiver::SCOPE_OFF && uiDockScope->isVisible())
+            scope_timer->start(40);
 
         /* update menu text and button tooltip */
         ui->actionDSP->setToolTip(tr("Stop DSP processing"));
@@ -1964,7 +2206,9 @@ void MainWindow::on_actionDSP_triggered(bool checked)
         meter_timer->stop();
         iq_fft_timer->stop();
         audio_fft_timer->stop();
+        scope_timer->stop();
         rds_timer->stop();
+        governor_timer->stop();
 
         /* stop receiver */
         rx->stop();
@@ -1976,6 +2220,9 @@ void MainWindow::on_actionDSP_triggered(bool checked)
         ui->plotter->setRunningState(false);
     }
 
+    for (auto *plotter : d_sourcePlotters)
+        plotter->setRunningState(checked && uiDockFft->fftRate() > 0);
+
     ui->actionDSP->setChecked(checked); //for remote control
 
 }
@@ -2035,6 +2282,24 @@ int MainWindow::firstTimeConfig()
     return confres;
 }
 
+/** Ask for a device string and open it as an additional input source. */
+void MainWindow::on_actionAddSource_triggered()
+{
+    bool ok;
+    QString device = QInputDialog::getText(this, tr("Add Input Source"),
+                                           tr("Device string, e.g. rtl=1 or file=/path/to/iq.raw,rate=2e6:"),
+                                           QLineEdit::Normal, QString(), &ok);
+
+    if (!ok || device.trimmed().isEmpty())
+        return;
+
+    int num = rx->num_input_sources();
+    addInputSource(device.trimmed());
+    if (rx->num_input_sources() == num)
+        QMessageBox::warning(this, tr("Add Input Source"),
+                             tr("Failed to open input source %1").arg(device.trimmed()));
+}
+
 
 /** Load configuration activated by user. */
 void MainWindow::on_actionLoadSettings_triggered()
@@ -2230,12 +2495,353 @@ void MainWindow::on_actionDX_Cluster_triggered()
     dxc_options->show();
 }
 
+/** Start or stop the timeline trace recorder. */
+void MainWindow::on_actionTrace_triggered(bool checked)
+{
+    if (checked)
+    {
+        if (trace::start())
+        {
+            ui->statusBar->showMessage(tr("Recording timeline trace"));
+        }
+        else
+        {
+            ui->actionTrace->setChecked(false);
+            ui->statusBar->showMessage(tr("Tracing is not enabled in this build"), 5000);
+        }
+    }
+    else
+    {
+        QString filename = QDir::homePath() + "/gqrx_" +
+                QDateTime::currentDateTimeUtc().toString("yyyyMMdd_hhmmss") +
+                ".trace.json";
+
+        if (trace::stop(filename.toStdString()))
+            ui->statusBar->showMessage(tr("Timeline trace saved to %1").arg(filename), 5000);
+        else
+            ui->statusBar->showMessage(tr("Error saving timeline trace"), 5000);
+    }
+}
+
+/** Feed the load governor and apply its decision. */
+void MainWindow::governorTimeout()
+{
+    LoadGovernor::sample s;
+    const float expected_rate = 1000.0f / (float)iq_fft_timer->interval();
+
+    s.frame_ratio = (d_fps > 0 && d_avg_fft_rate > 0.0f) ? d_avg_fft_rate / expected_rate : 1.0f;
+    s.backlog = rx->get_input_backlog();
+    s.losses = rx->get_input_overflows() + rx->get_recorder_drops();
+
+    int old_level = governor.level();
+    if (governor.update(s, QDateTime::currentMSecsSinceEpoch()) != old_level)
+        applyLoadLevel(old_level);
+}
+
+/**
+ * Apply the current load governor level to the spectrum. The settings made
+ * by the user are kept and reapplied in full when the level drops to 0.
+ */
+void MainWindow::applyLoadLevel(int old_level)
+{
+    int level = governor.level();
+
+    if (level == old_level)
+        return;
+
+    setIqFftRate((int)d_fps);
+    if (governor.fftSize(d_fftSize) != (int)rx->iq_fft_size())
+        setIqFftSize(d_fftSize);
+
+    int flags = (governor.shedHistogram() ? CPlotter::SHED_HISTOGRAM_PEAKS : 0) |
+                (governor.shedWaterfall() ? CPlotter::SHED_WATERFALL : 0);
+    ui->plotter->setLoadShed(flags);
+    for (auto *plotter : d_sourcePlotters)
+        plotter->setLoadShed(flags);
+
+    if (level > old_level)
+        ui->statusBar->showMessage(tr("Reduced spectrum quality to keep up with the input (level %1 of %2)")
+                                   .arg(level).arg(LoadGovernor::MAX_LEVEL), 5000);
+    else if (level < old_level)
+        ui->statusBar->showMessage(level == 0 ? tr("Spectrum quality restored")
+                                              : tr("Restoring spectrum quality (level %1 of %2)")
+                                                .arg(level).arg(LoadGovernor::MAX_LEVEL), 5000);
+}
+
+/**
+ * Select the signal shown by the scope, see receiver::scope_source. The scope
+ * is disconnected from the flow graph while its dock is hidden.
+ */
+void MainWindow::setScopeSource(int source)
+{
+    if (!uiDockScope->isVisible())
+        source = receiver::SCOPE_OFF;
+
+    rx->set_scope_source((receiver::scope_source)source);
+
+    if (source != receiver::SCOPE_OFF && ui->actionDSP->isChecked())
+        scope_timer->start(40);
+    else
+        scope_timer->stop();
+}
+
+void MainWindow::scopeVisibilityChanged(bool visible)
+{
+    int source = visible ? uiDockScope->source() : (int)receiver::SCOPE_OFF;
+
+    rx->set_scope_source((receiver::scope_source)source);
+
+    if (source != receiver::SCOPE_OFF && ui->actionDSP->isChecked())
+        scope_timer->start(40);
+    else
+        scope_timer->stop();
+}
+
+/** Start or stop tracing from the remote control. */
+void MainWindow::setTracing(bool enabled)
+{
+    if (enabled != ui->actionTrace->isChecked())
+    {
+        ui->actionTrace->setChecked(enabled);
+        on_actionTrace_triggered(enabled);
+    }
+}
+
+/**
+ * Open an additional input source and show its spectrum in a new dock.
+ * The source is tuned and closed through the remote control.
+ */
+void MainWindow::addInputSource(const QString& device)
+{
+    int id;
+
+    try
+    {
+        id = rx->add_input_source(device.toStdString());
+    }
+    catch (std::exception &x)
+    {
+        qWarning() << "Failed to open input source" << device << ":" << x.what();
+        return;
+    }
+
+    auto *plotter = new CPlotter(this);
+    plotter->setTooltipsEnabled(true);
+    plotter->setFilterBoxEnabled(false);
+    plotter->setCenterLineEnabled(false);
+    plotter->setBookmarksEnabled(false);
+    plotter->setSampleRate(rx->get_source_rate(id));
+    plotter->setSpanFreq((quint32)rx->get_source_rate(id));
+    plotter->setCenterFreq((quint64)rx->get_source_freq(id));
+    plotter->setFftRate(governor.frameRate((int)d_fps));
+    plotter->setRunningState(ui->actionDSP->isChecked() && d_fps > 0);
+    connect(uiDockFft, SIGNAL(pandapterRangeChanged(float,float)),
+            plotter, SLOT(setPandapterRange(float,float)));
+    connect(uiDockFft, SIGNAL(waterfallRangeChanged(float,float)),
+            plotter, SLOT(setWaterfallRange(float,float)));
+
+    // named after the device, not the number, so the saved layout stays
+    // with the device when other sources are closed
+    auto *dock = new QDockWidget(tr("Source %1").arg(id), this);
+    dock->setObjectName(QString("DockSource_%1").arg(device));
+    dock->setWidget(plotter);
+    if (!restoreDockWidget(dock))
+        addDockWidget(Qt::BottomDockWidgetArea, dock);
+
+    d_sourceDocks.append(dock);
+    d_sourcePlotters.append(plotter);
+    updateRemoteSources();
+}
+
+/** Close an additional input source and its spectrum dock. */
+void MainWindow::removeInputSource(int id)
+{
+    if (rx->remove_input_source(id) != receiver::STATUS_OK)
+        return;
+
+    d_sourceDocks.takeAt(id - 1)->deleteLater();
+    d_sourcePlotters.removeAt(id - 1);
+
+    // sources after the removed one have moved down
+    for (int i = id - 1; i < d_sourceDocks.size(); i++)
+        d_sourceDocks[i]->setWindowTitle(tr("Source %1").arg(i + 1));
+    updateRemoteSources();
+    updateRemoteChannels();
+}
+
+/** Tune an additional input source. */
+void MainWindow::setSourceFrequency(int id, qint64 freq_hz)
+{
+    if (rx->set_source_freq(id, (double)freq_hz) != receiver::STATUS_OK)
+        return;
+
+    d_sourcePlotters[id - 1]->setCenterFreq((quint64)rx->get_source_freq(id));
+    updateRemoteSources();
+}
+
+/** Tell the remote control about the additional input sources. */
+void MainWindow::updateRemoteSources()
+{
+    QStringList devices;
+    QList<qint64> freqs;
+
+    for (int id = 1; id <= rx->num_input_sources(); id++)
+    {
+        devices.append(QString::fromStdString(rx->get_source_device(id)));
+        freqs.append((qint64)rx->get_source_freq(id));
+    }
+    remote->setInputSources(devices, freqs);
+}
+
+/** Show the spectrum merged from other nodes, the dock is created with the first one. */
+void MainWindow::setMergedSpectrum(qint64 center_hz, double span_hz, const QVector<float> &fft)
+{
+    if (!d_mergedDock)
+    {
+        d_mergedPlotter = new CPlotter(this);
+        d_mergedPlotter->setTooltipsEnabled(true);
+        d_mergedPlotter->setFilterBoxEnabled(false);
+        d_mergedPlotter->setCenterLineEnabled(false);
+        d_mergedPlotter->setBookmarksEnabled(false);
+        d_mergedPlotter->setRunningState(true);
+        connect(uiDockFft, SIGNAL(pandapterRangeChanged(float,float)),
+                d_mergedPlotter, SLOT(setPandapterRange(float,float)));
+        connect(uiDockFft, SIGNAL(waterfallRangeChanged(float,float)),
+                d_mergedPlotter, SLOT(setWaterfallRange(float,float)));
+
+        d_mergedDock = new QDockWidget(tr("Merged spectrum"), this);
+        d_mergedDock->setObjectName("DockMergedSpectrum");
+        d_mergedDock->setWidget(d_mergedPlotter);
+        addDockWidget(Qt::BottomDockWidgetArea, d_mergedDock);
+
+        // next to the other docks in the View menu, so it can be reopened
+        QList<QAction *> actions = ui->menu_View->actions();
+        int pos = actions.indexOf(uiDockBookmarks->toggleViewAction());
+        ui->menu_View->insertAction(actions.value(pos + 1), d_mergedDock->toggleViewAction());
+    }
+
+    if (!d_mergedDock->isVisible())
+        return;
+
+    // the axis changes when nodes join, leave or retune; the span comes
+    // from the network and may not fit the plotter
+    const double span = qBound(1.0, span_hz, (double)std::numeric_limits<quint32>::max());
+    if (d_mergedPlotter->getSampleRate() != (float)span)
+    {
+        d_mergedPlotter->setSampleRate(span);
+        d_mergedPlotter->setSpanFreq((quint32)span);
+    }
+    d_mergedPlotter->setCenterFreq(center_hz);
+    d_mergedPlotter->setNewFftData(fft.constData(), fft.size());
+}
+
+void MainWindow::logSpectrumEvent(const QString &node, qint64 freq_hz, float level_db, bool active)
+{
+    qInfo() << "Spectrum event from" << node << ":" << freq_hz << "Hz"
+            << level_db << "dBFS" << (active ? "appeared" : "disappeared");
+}
+
+/**
+ * Follow a frequency ramp from the remote control.
+ * @param offset Offset from the tuned frequency [Hz].
+ * @param rate Rate of change [Hz/s].
+ * @param time UNIX time in seconds the ramp starts at, negative for now.
+ */
+void MainWindow::setFreqRamp(double offset, double rate, double time)
+{
+    auto status = rx->set_freq_ramp(offset, rate, time < 0.0 ? -1 : (int64_t)(time * 1.e9));
+
+    remote->setFreqRampStatus(status == receiver::STATUS_OK, offset);
+}
+
+/**
+ * Stop the frequency ramp. The remote control then tunes to the frequency
+ * reached, which also stops the ramp, so it is only stopped here if the
+ * ramp is back at the tuned frequency.
+ */
+void MainWindow::stopFreqRamp()
+{
+    double offset, rate;
+
+    rx->get_freq_ramp(offset, rate);
+    if (qRound64(offset) == 0)
+        rx->clear_freq_ramp();
+    remote->setFreqRampStatus(true, offset);
+}
+
+/** Unload a decoder plugin, see DecoderPlugins. */
+void MainWindow::unloadDecoder(int id)
+{
+    decoder_plugins->unload(id);
+    remote->setDecoders(decoder_plugins->list());
+}
+
+/**
+ * Demodulate a channel besides the main one, optionally recording it to the
+ * audio recording directory while its squelch is open.
+ */
+void MainWindow::addVfoChannel(qint64 freq, int demod, double squelch, bool record)
+{
+    int id = rx->add_vfo_channel((double)freq, demod, (float)squelch);
+
+    if (id < 0)
+    {
+        ui->statusBar->showMessage(tr("Channel %1 Hz is outside the baseband of every source").arg(freq), 5000);
+        return;
+    }
+
+    if (record)
+    {
+        auto recdir = m_settings->value("audio/rec_dir", QDir::homePath()).toString();
+        auto file_name = QDateTime::currentDateTimeUtc().toString("gqrx_yyyyMMdd_hhmmss");
+        auto path = QString("%1/%2_%3_ch%4.wav").arg(recdir).arg(file_name).arg(freq).arg(id);
+
+        if (rx->start_vfo_recording(id, path.toStdString()) != receiver::STATUS_OK)
+            ui->statusBar->showMessage(tr("Failed to record channel to %1").arg(path), 5000);
+    }
+    updateRemoteChannels();
+}
+
+void MainWindow::removeVfoChannel(int id)
+{
+    rx->remove_vfo_channel(id);
+    updateRemoteChannels();
+}
+
+/** Tell the remote control about the VFO channels and their levels. */
+void MainWindow::updateRemoteChannels()
+{
+    QStringList channels;
+
+    for (int id = 1; id <= rx->num_vfo_channels(); id++)
+    {
+        auto file = QString::fromStdString(rx->get_vfo_recording(id));
+
+        channels.append(QString("%1 %2 %3 %4 %5 %6 %7").arg(id)
+                        .arg(qRound64(rx->get_vfo_freq(id)))
+                        .arg(rx->get_vfo_demod(id) == vfo_channel::DEMOD_AM ? "AM" : "FM")
+                        .arg(rx->get_vfo_squelch(id), 0, 'f', 1)
+                        .arg(rx->get_vfo_level(id), 0, 'f', 1)
+                        .arg(rx->get_vfo_source(id))
+                        .arg(file.isEmpty() ? "-" : file));
+    }
+    remote->setVfoChannels(channels);
+}
+
+void MainWindow::logDecoderEvent(qint64 time_ms, const QString &name, const QString &type,
+                                 const QString &text)
+{
+    Q_UNUSED(time_ms);
+    qInfo() << "Decoder" << name << type << ":" << text;
+}
+
 /**
  * Cyclic processing for acquiring samples from receiver and processing them
  * with data decoders (see dec_* objects)
  */
 void MainWindow::decoderTimeout()
 {
+    TRACE_SCOPE("MainWindow::decoderTimeout", "timer");
     float buffer[DATA_BUFFER_SIZE];
     unsigned int num;
 
@@ -2321,6 +2927,15 @@ void MainWindow::setPassband(int bandwidth)
     on_plotter_newFilterFreq(lo, hi);
 }
 
+/** Start or commit a batch of receiver changes from the remote control. */
+void MainWindow::setBatchUpdate(bool active)
+{
+    if (active)
+        rx->begin_update();
+    else
+        rx->commit_update();
+}
+
 /** Launch Gqrx google group website. */
 void MainWindow::on_actionUserGroup_triggered()
 {
@@ -24,6 +24,8 @@
 #define MAINWINDOW_H
 
 #include <QColor>
+#include <QDockWidget>
+#include <QList>
 #include <QMainWindow>
 #include <QPointer>
 #include <QSettings>
@@ -39,12 +41,17 @@
 #include "qtgui/dockfft.h"
 #include "qtgui/dockbookmarks.h"
 #include "qtgui/dockrds.h"
+#include "qtgui/dockscope.h"
 #include "qtgui/afsk1200win.h"
 #include "qtgui/iq_tool.h"
 #include "qtgui/dxc_options.h"
+#include "qtgui/plotter.h"
 
+#include "applications/gqrx/decoder_plugins.h"
 #include "applications/gqrx/recentconfig.h"
 #include "applications/gqrx/remote_control.h"
+#include "applications/gqrx/load_governor.h"
+#include "applications/gqrx/spectrum_net.h"
 #include "applications/gqrx/receiver.h"
 
 namespace Ui {
@@ -90,11 +97,14 @@ private:
     enum receiver::filter_shape d_filter_shape;
     std::vector<float> d_iqFftData;
     float           d_fftAvg;      /*!< FFT averaging parameter set by user (not the true gain). */
-    float           d_fps;
+    float           d_fps;         /*!< Spectrum frame rate set by user. */
+    int             d_fftSize;     /*!< FFT size set by user. */
     int             d_fftWindowType;
     bool            d_fftNormalizeEnergy;
 
     std::vector<float> d_audioFftData;
+    std::vector<float> d_scopeMins;
+    std::vector<float> d_scopeMaxs;
     bool d_have_audio;  /*!< Whether we have audio (i.e. not with demod_off. */
 
     /* dock widgets */
@@ -104,10 +114,19 @@ private:
     DockFft        *uiDockFft;
     DockBookmarks  *uiDockBookmarks;
     DockRDS        *uiDockRDS;
+    DockScope      *uiDockScope;
 
     CIqTool        *iq_tool;
     DXCOptions     *dxc_options;
 
+    /* spectrum of each additional input source */
+    QList<QDockWidget *> d_sourceDocks;
+    QList<CPlotter *>    d_sourcePlotters;
+
+    /* spectrum merged from other gqrx nodes */
+    QDockWidget    *d_mergedDock;
+    CPlotter       *d_mergedPlotter;
+
 
     /* data decoders */
     Afsk1200Win    *dec_afsk1200;
@@ -118,6 +137,8 @@ private:
     QTimer   *iq_fft_timer;
     QTimer   *audio_fft_timer;
     QTimer   *rds_timer;
+    QTimer   *scope_timer;
+    QTimer   *governor_timer;
     quint64  d_last_fft_ms;
     float    d_avg_fft_rate;
     bool     d_frame_drop;
@@ -125,6 +146,10 @@ private:
     receiver *rx;
 
     RemoteControl *remote;
+    SpectrumPublisher *spectrum_pub;
+    SpectrumCollector *spectrum_col;
+    LoadGovernor       governor;   /*!< Sheds display load when the DSP falls behind. */
+    DecoderPlugins    *decoder_plugins;
 
     std::map<QString, QVariant> devList;
 
@@ -138,6 +163,10 @@ private:
     void updateFrequencyRange();
     void updateDeltaAndCenter();
     void updateGainStages(bool read_from_device);
+    void updateRemoteSources();
+    void updateRemoteChannels();
+    void applyLoadLevel(int old_level);
+    QByteArray sigmfMeta(qint64 sample_rate, qint64 freq, const QDateTime &start) const;
     void showSimpleTextFile(const QString &resource_path,
                             const QString &window_title);
     /* key shortcuts */
@@ -184,6 +213,30 @@ private slots:
     double setSqlLevelAuto();
     void setAudioGain(float gain);
     void setPassband(int bandwidth);
+    void setBatchUpdate(bool active);
+    void setTracing(bool enabled);
+    void setScopeSource(int source);
+    void scopeVisibilityChanged(bool visible);
+
+    /* additional input sources */
+    void addInputSource(const QString& device);
+    void removeInputSource(int id);
+    void setSourceFrequency(int id, qint64 freq_hz);
+
+    /* spectrum aggregation */
+    void setMergedSpectrum(qint64 center_hz, double span_hz, const QVector<float> &fft);
+    void logSpectrumEvent(const QString &node, qint64 freq_hz, float level_db, bool active);
+
+    /* Doppler tracking */
+    void setFreqRamp(double offset, double rate, double time);
+    void stopFreqRamp();
+
+    /* decoder plugins */
+    void unloadDecoder(int id);
+    void addVfoChannel(qint64 freq, int demod, double squelch, bool record);
+    void removeVfoChannel(int id);
+    void logDecoderEvent(qint64 time_ms, const QString &name, const QString &type,
+                         const QString &text);
 
     /* audio recording and playback */
     void startAudioRec(const QString& filename);
@@ -197,7 +250,9 @@ private slots:
     /* I/Q playback and recording*/
     void startIqRecording(const QString& recdir, const QString& format);
     void stopIqRecording();
-    void startIqPlayback(const QString& filename, float samprate, qint64 center_freq);
+    void saveIqSnapshot(int source, qint64 samples, double time);
+    void startIqPlayback(const QString& filename, float samprate, qint64 center_freq,
+                         const QString& datatype);
     void stopIqPlayback();
     void seekIqFile(qint64 seek_pos);
 
@@ -229,6 +284,7 @@ private slots:
     /* menu and toolbar actions */
     void on_actionDSP_triggered(bool checked);
     int  on_actionIoConfig_triggered();
+    void on_actionAddSource_triggered();
     void on_actionLoadSettings_triggered();
     void on_actionSaveSettings_triggered();
     void on_actionIqTool_triggered();
@@ -244,6 +300,7 @@ private slots:
     void on_actionAboutQt_triggered();
     void on_actionAddBookmark_triggered();
     void on_actionDX_Cluster_triggered();
+    void on_actionTrace_triggered(bool checked);
 
     /* markers*/
     void on_setMarkerButtonA_clicked();
@@ -260,7 +317,9 @@ private slots:
     void meterTimeout();
     void iqFftTimeout();
     void audioFftTimeout();
+    void scopeTimeout();
     void rdsTimeout();
+    void governorTimeout();
 };
 
 #endif // MAINWINDOW_H
@@ -20,6 +20,7 @@
  * the Free Software Foundation, Inc., 51 Franklin Street,
  * Boston, MA 02110-1301, USA.
  */
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
@@ -34,7 +35,9 @@
 #include "applications/gqrx/receiver.h"
 #include "dsp/correct_iq_cc.h"
 #include "dsp/filter/fir_decim.h"
+#include "dsp/rate_plan.h"
 #include "dsp/rx_fft.h"
+#include "interfaces/trace.h"
 #include "receivers/nbrx.h"
 #include "receivers/wfmrx.h"
 
@@ -48,7 +51,14 @@
 
 #define DEFAULT_AUDIO_GAIN -6.0
 #define WAV_FILE_GAIN 0.5
-#define TARGET_QUAD_RATE 1e6
+
+/* Lock a flow graph, the time spent waiting shows up in traces */
+static void lock_graph(gr::top_block_sptr &graph, const char *name)
+{
+    TRACE_SCOPE(name, "receiver");
+    (void) name;
+    graph->lock();
+}
 
 /**
  * @brief Public constructor.
@@ -72,58 +82,62 @@ receiver::receiver(const std::string input_device,
       d_iq_rev(false),
       d_dc_cancel(false),
       d_iq_balance(false),
-      d_demod(RX_DEMOD_OFF)
+      d_demod(RX_DEMOD_OFF),
+      d_audio_channels(0),
+      d_update_depth(0),
+      d_pending_demod(false),
+      d_pending_rate(false),
+      d_pending_decim(0),
+      d_pending_input_rate(0.0),
+      d_fft_window(gr::fft::window::WIN_HANN),
+      d_fft_normalize(false),
+      d_fft_rate(0.0f),
+      d_scope_source(SCOPE_OFF)
 {
 
     tb = gr::make_top_block("gqrx");
 
-    if (input_device.empty())
-    {
-        src = osmosdr::source::make("file="+escape_filename(get_zero_file())+",freq=428e6,rate=96000,repeat=true,throttle=true");
-    }
-    else
-    {
-        input_devstr = input_device;
-        src = osmosdr::source::make(input_device);
-    }
-
-    // input decimator
-    if (d_decim >= 2)
-    {
-        try
-        {
-            input_decim = make_fir_decim_cc(d_decim);
-        }
-        catch (std::range_error &e)
-        {
-            std::cout << "Error creating input decimator " << d_decim
-                      << ": " << e.what() << std::endl
-                      << "Using decimation 1." << std::endl;
-            d_decim = 1;
-        }
+    input_devstr = input_device;
+    frontend.reset(new input_frontend(input_device, d_decim));
+    d_input_rate = frontend->input_rate();
+    d_decim = frontend->decim();
+    d_decim_rate = frontend->decim_rate();
 
-        d_decim_rate = d_input_rate / (double)d_decim;
-    }
-    else
-    {
-        d_decim_rate = d_input_rate;
-    }
-
-    d_ddc_decim = std::max(1, (int)(d_decim_rate / TARGET_QUAD_RATE));
+    d_ddc_decim = rate_plan_ddc_decim(d_decim_rate, 2*DDC_LPF_CUTOFF,
+                                      {NBRX_QUAD_RATE, WFMRX_QUAD_RATE});
     d_quad_rate = d_decim_rate / d_ddc_decim;
     ddc = make_downconverter_cc(d_ddc_decim, 0.0, d_decim_rate);
     rx  = make_nbrx(d_quad_rate, d_audio_rate);
 
     iq_swap = make_iq_swap_cc(false);
     dc_corr = make_dc_corr_cc(d_decim_rate, 1.0);
-    iq_fft = make_rx_fft_c(DEFAULT_FFT_SIZE, d_decim_rate, gr::fft::window::WIN_HANN);
+    iq_fft = make_rx_fft_c(DEFAULT_FFT_SIZE, d_decim_rate, d_fft_window);
 
     audio_fft = make_rx_fft_f(DEFAULT_FFT_SIZE, d_audio_rate, gr::fft::window::WIN_HANN);
-    audio_gain0 = gr::blocks::multiply_const_ff::make(0);
-    audio_gain1 = gr::blocks::multiply_const_ff::make(0);
-    set_af_gain(DEFAULT_AUDIO_GAIN);
 
-    audio_udp_sink = make_udp_sink_f();
+    scope_data = std::make_shared<scope_pyramid>();
+    scope_c = make_scope_sink(scope_data, true);
+    scope_f = make_scope_sink(scope_data, false);
+
+    decoders = std::make_shared<decoder_pool>();
+
+    d_snap_bb_size = DEFAULT_SNAPSHOT_BB;
+    d_snap_ch_size = DEFAULT_SNAPSHOT_CH;
+    d_snap_shared = false;
+    snap_bb.reset(new iq_ring(d_snap_bb_size));
+    snap_ch.reset(new iq_ring(d_snap_ch_size));
+    snap_bb_sink = make_snapshot_sink(snap_bb);
+    snap_ch_sink = make_snapshot_sink(snap_ch);
+    reset_snapshots();
+
+    iq_rec = std::make_shared<file_recorder>(file_recorder::FORMAT_RAW_IQ, 1, d_decim_rate);
+    iq_sink = make_file_recorder_sink(iq_rec);
+    wav_rec = std::make_shared<file_recorder>(file_recorder::FORMAT_WAV, 2, d_audio_rate);
+
+    audio_out = make_audio_output(audio_fft, wav_rec);
+    audio_out->set_gain(audio_output::OUTPUT_RECORDER, WAV_FILE_GAIN);
+    set_af_gain(DEFAULT_AUDIO_GAIN);
+    rx_null_sink = gr::blocks::null_sink::make(sizeof(float));
 
 #ifdef WITH_PULSEAUDIO
     audio_snk = make_pa_sink(audio_device, d_audio_rate, "GQRX", "Audio output");
@@ -135,9 +149,7 @@ receiver::receiver(const std::string input_device,
 
     output_devstr = audio_device;
 
-    /* wav sink and source is created when rec/play is started */
-    audio_null_sink0 = gr::blocks::null_sink::make(sizeof(float));
-    audio_null_sink1 = gr::blocks::null_sink::make(sizeof(float));
+    /* wav source is created when playback is started */
     sniffer = make_sniffer_f();
     /* sniffer_rr is created at each activation. */
 
@@ -150,6 +162,12 @@ receiver::receiver(const std::string input_device,
 
 receiver::~receiver()
 {
+    for (auto &s : d_extra_sources)
+    {
+        s->frontend->stop();
+        s->tb->stop();
+    }
+    frontend->stop();
     tb->stop();
 }
 
@@ -159,7 +177,15 @@ void receiver::start()
 {
     if (!d_running)
     {
+        frontend->flush();
         tb->start();
+        frontend->start();
+        for (auto &s : d_extra_sources)
+        {
+            s->frontend->flush();
+            s->tb->start();
+            s->frontend->start();
+        }
         d_running = true;
     }
 }
@@ -169,6 +195,13 @@ void receiver::stop()
 {
     if (d_running)
     {
+        for (auto &s : d_extra_sources)
+        {
+            s->frontend->stop();
+            s->tb->stop();
+            s->tb->wait();
+        }
+        frontend->stop();
         tb->stop();
         tb->wait(); // If the graph is needed to run again, wait() must be called after stop
         d_running = false;
@@ -178,6 +211,9 @@ void receiver::stop()
 /**
  * @brief Select new input device.
  * @param device
+ *
+ * Only the input front end is stopped and rebuilt. The receiver flow graph
+ * keeps running and is notified about the new rate.
  */
 void receiver::set_input_device(const std::string device)
 {
@@ -192,61 +228,18 @@ void receiver::set_input_device(const std::string device)
 
     input_devstr = device;
 
-    // tb->lock() can hang occasionally
-    if (d_running)
-    {
-        tb->stop();
-        tb->wait();
-    }
-
-    if (d_decim >= 2)
-    {
-        tb->disconnect(src, 0, input_decim, 0);
-        tb->disconnect(input_decim, 0, iq_swap, 0);
-    }
-    else
-    {
-        tb->disconnect(src, 0, iq_swap, 0);
-    }
-
-#if GNURADIO_VERSION < 0x030802
-    //Work around GNU Radio bug #3184
-    //temporarily connect dummy source to ensure that previous device is closed
-    src = osmosdr::source::make("file="+escape_filename(get_zero_file())+",freq=428e6,rate=96000,repeat=true,throttle=true");
-    tb->connect(src, 0, iq_swap, 0);
-    tb->start();
-    tb->stop();
-    tb->wait();
-    tb->disconnect(src, 0, iq_swap, 0);
-#else
-    src.reset();
-#endif
-
     try
     {
-        src = osmosdr::source::make(device);
+        frontend->set_device(device);
     }
-    catch (std::exception &x)
+    catch (std::runtime_error &x)
     {
         error = x.what();
-        src = osmosdr::source::make("file="+escape_filename(get_zero_file())+",freq=428e6,rate=96000,repeat=true,throttle=true");
-    }
-
-    if(src->get_sample_rate() != 0)
-        set_input_rate(src->get_sample_rate());
-
-    if (d_decim >= 2)
-    {
-        tb->connect(src, 0, input_decim, 0);
-        tb->connect(input_decim, 0, iq_swap, 0);
-    }
-    else
-    {
-        tb->connect(src, 0, iq_swap, 0);
     }
 
-    if (d_running)
-        tb->start();
+    d_input_rate = frontend->input_rate();
+    update_decim_rate();
+    iq_fft->reset_retune_settle_time();
 
     if (error != "")
     {
@@ -267,13 +260,10 @@ void receiver::set_output_device(const std::string device)
 
     output_devstr = device;
 
-    tb->lock();
+    lock_graph(tb, "tb->lock");
 
-    if (d_demod != RX_DEMOD_OFF)
-    {
-        tb->disconnect(audio_gain0, 0, audio_snk, 0);
-        tb->disconnect(audio_gain1, 0, audio_snk, 1);
-    }
+    for (int ch = 0; ch < d_audio_channels; ch++)
+        tb->disconnect(audio_out, ch, audio_snk, ch);
     audio_snk.reset();
 
     try {
@@ -285,11 +275,8 @@ void receiver::set_output_device(const std::string device)
         audio_snk = gr::audio::sink::make(d_audio_rate, device, true);
 #endif
 
-        if (d_demod != RX_DEMOD_OFF)
-        {
-            tb->connect(audio_gain0, 0, audio_snk, 0);
-            tb->connect(audio_gain1, 0, audio_snk, 1);
-        }
+        for (int ch = 0; ch < d_audio_channels; ch++)
+            tb->connect(audio_out, ch, audio_snk, ch);
 
         tb->unlock();
 
@@ -303,7 +290,7 @@ void receiver::set_output_device(const std::string device)
 /** Get a list of available antenna connectors. */
 std::vector<std::string> receiver::get_antennas(void) const
 {
-    return src->get_antennas();
+    return frontend->src()->get_antennas();
 }
 
 /** Select antenna connector. */
@@ -311,7 +298,7 @@ void receiver::set_antenna(const std::string &antenna)
 {
     if (!antenna.empty())
     {
-        src->set_antenna(antenna);
+        frontend->src()->set_antenna(antenna);
     }
 }
 
@@ -319,127 +306,115 @@ void receiver::set_antenna(const std::string &antenna)
  * @brief Set new input sample rate.
  * @param rate The desired input rate
  * @return The actual sample rate set or 0 if there was an error with the
- *         device.
+ *         device. Within begin_update() / commit_update() the change is
+ *         deferred and the requested rate is returned.
  */
 double receiver::set_input_rate(double rate)
 {
-    double  current_rate;
-    bool    rate_has_changed;
-
-    current_rate = src->get_sample_rate();
-    rate_has_changed = !(rate == current_rate ||
-            std::abs(rate - current_rate) < std::abs(std::min(rate, current_rate))
-            * std::numeric_limits<double>::epsilon());
-
-    tb->lock();
-    try
+    if (d_update_depth > 0)
     {
-        d_input_rate = src->set_sample_rate(rate);
-    }
-    catch (std::runtime_error &e)
-    {
-        d_input_rate = 0;
+        d_pending_input_rate = rate;
+        return rate;
     }
 
-    if (d_input_rate == 0)
-    {
-        // This can be the case when no device is attached and gr-osmosdr
-        // puts in a null_source with rate 100 ksps or if the rate has not
-        // changed
-        if (rate_has_changed)
-        {
-            std::cerr << std::endl;
-            std::cerr << "Failed to set RX input rate to " << rate << std::endl;
-            std::cerr << "Your device may not be working properly." << std::endl;
-            std::cerr << std::endl;
-        }
-        d_input_rate = rate;
-    }
-
-    d_decim_rate = d_input_rate / (double)d_decim;
-    d_ddc_decim = std::max(1, (int)(d_decim_rate / TARGET_QUAD_RATE));
-    d_quad_rate = d_decim_rate / d_ddc_decim;
-    dc_corr->set_sample_rate(d_decim_rate);
-    ddc->set_decim_and_samp_rate(d_ddc_decim, d_decim_rate);
-    rx->set_quad_rate(d_quad_rate);
-    iq_fft->set_quad_rate(d_decim_rate);
-    tb->unlock();
+    d_input_rate = frontend->set_input_rate(rate);
+    update_decim_rate();
 
     return d_input_rate;
 }
 
-/** Set input decimation */
+/**
+ * @brief Set input decimation.
+ * @param decim The new decimation.
+ * @return The decimation in use. Within begin_update() / commit_update()
+ *         the change is deferred and the requested value is returned.
+ */
 unsigned int receiver::set_input_decim(unsigned int decim)
 {
-    if (decim == d_decim)
-        return d_decim;
-
-    if (d_running)
+    if (d_update_depth > 0)
     {
-        tb->stop();
-        tb->wait();
+        d_pending_decim = decim;
+        return decim;
     }
 
-    if (d_decim >= 2)
-    {
-        tb->disconnect(src, 0, input_decim, 0);
-        tb->disconnect(input_decim, 0, iq_swap, 0);
-    }
-    else
+    if (decim != d_decim)
+        apply_input_decim(decim);
+
+    return d_decim;
+}
+
+/** Rebuild the input front end with a new decimation. */
+void receiver::apply_input_decim(unsigned int decim)
+{
+    frontend->set_decim(decim);
+    d_decim = frontend->decim();
+    update_decim_rate();
+}
+
+/**
+ * @brief Notify the receiver chain about a new rate after input decimation.
+ *
+ * The blocks are reconfigured within a single lock of the receiver flow
+ * graph. Samples still queued at the old rate are discarded. Within
+ * begin_update() / commit_update() this is done once at the commit.
+ *
+ * If the front end was rebuilt but delivers the same rate, e.g. after a
+ * device change or a new input rate / decimation pair, only the samples of
+ * the old front end are dropped and the receiver flow graph is not locked.
+ */
+void receiver::update_decim_rate(void)
+{
+    double decim_rate = d_input_rate / (double)d_decim;
+
+    if (decim_rate == d_decim_rate && !d_pending_rate)
     {
-        tb->disconnect(src, 0, iq_swap, 0);
+        frontend->flush();
+        return;
     }
 
-    input_decim.reset();
-    d_decim = decim;
-    if (d_decim >= 2)
-    {
-        try
-        {
-            input_decim = make_fir_decim_cc(d_decim);
-        }
-        catch (std::range_error &e)
-        {
-            std::cout << "Error opening creating input decimator " << d_decim
-                      << ": " << e.what() << std::endl
-                      << "Using decimation 1." << std::endl;
-            d_decim = 1;
-        }
+    d_decim_rate = decim_rate;
+    d_ddc_decim = rate_plan_ddc_decim(d_decim_rate, 2*DDC_LPF_CUTOFF,
+                                      {NBRX_QUAD_RATE, WFMRX_QUAD_RATE});
+    d_quad_rate = d_decim_rate / d_ddc_decim;
 
-        d_decim_rate = d_input_rate / (double)d_decim;
-    }
-    else
+    if (d_update_depth > 0)
     {
-        d_decim_rate = d_input_rate;
+        d_pending_rate = true;
+        return;
     }
 
-    // update quadrature rate
-    d_ddc_decim = std::max(1, (int)(d_decim_rate / TARGET_QUAD_RATE));
-    d_quad_rate = d_decim_rate / d_ddc_decim;
+    lock_graph(tb, "tb->lock");
     dc_corr->set_sample_rate(d_decim_rate);
     ddc->set_decim_and_samp_rate(d_ddc_decim, d_decim_rate);
     rx->set_quad_rate(d_quad_rate);
     iq_fft->set_quad_rate(d_decim_rate);
+    iq_rec->set_sample_rate(d_decim_rate);
+    update_decoder_rates();
+    for (auto &v : d_vfo_channels)
+        if (!v.src)
+            v.chan->set_input_rate(d_decim_rate);
+    frontend->flush();
+    tb->unlock();
 
-    if (d_decim >= 2)
-    {
-        tb->connect(src, 0, input_decim, 0);
-        tb->connect(input_decim, 0, iq_swap, 0);
-    }
-    else
-    {
-        tb->connect(src, 0, iq_swap, 0);
-    }
-
-#ifdef CUSTOM_AIRSPY_KERNELS
-    if (input_devstr.find("airspy") != std::string::npos)
-        src->set_bandwidth(d_decim_rate);
-#endif
+    if (d_scope_source == SCOPE_BASEBAND || d_scope_source == SCOPE_CHANNEL)
+        scope_data->clear();
+    reset_snapshots();
+}
 
-    if (d_running)
-        tb->start();
+/**
+ * Start new snapshot segments after the rate changed.
+ *
+ * RF retunes and channel offset changes are handled by the sinks at the
+ * "rx_freq" and "ch_offset" tags instead.
+ */
+void receiver::reset_snapshots(void)
+{
+    double offset = d_filter_offset - d_cw_offset;
 
-    return d_decim;
+    snap_bb_sink->set_params(d_decim_rate, d_rf_freq, 0.0);
+    snap_ch_sink->set_params(d_quad_rate, d_rf_freq, offset);
+    snap_bb->reset(d_decim_rate, d_rf_freq);
+    snap_ch->reset(d_quad_rate, d_rf_freq + offset);
 }
 
 /**
@@ -449,13 +424,13 @@ unsigned int receiver::set_input_decim(unsigned int decim)
  */
 double receiver::set_analog_bandwidth(double bw)
 {
-    return src->set_bandwidth(bw);
+    return frontend->src()->set_bandwidth(bw);
 }
 
 /** Get current analog bandwidth. */
 double receiver::get_analog_bandwidth(void) const
 {
-    return src->get_bandwidth();
+    return frontend->src()->get_bandwidth();
 }
 
 /** Set I/Q reversed. */
@@ -515,7 +490,7 @@ void receiver::set_iq_balance(bool enable)
 
     d_iq_balance = enable;
 
-    src->set_iq_balance_mode(enable ? 2 : 0);
+    frontend->src()->set_iq_balance_mode(enable ? 2 : 0);
 }
 
 /**
@@ -538,12 +513,40 @@ receiver::status receiver::set_rf_freq(double freq_hz)
 {
     d_rf_freq = freq_hz;
 
-    src->set_center_freq(d_rf_freq);
+    // also tags the next sample delivered, approximately where the retune takes effect
+    frontend->set_center_freq(d_rf_freq);
+    ddc->clear_freq_ramp();
+    for (auto &v : d_vfo_channels)
+        if (!v.src)
+            v.chan->set_offset(v.freq - d_rf_freq);
     // FIXME: read back frequency?
 
     return STATUS_OK;
 }
 
+/**
+ * @brief Set how long to ignore samples after a retune.
+ * @param seconds The settle time of the tuner.
+ *
+ * Samples within this time after a retune are not used for the spectrum.
+ */
+receiver::status receiver::set_retune_settle(double seconds)
+{
+    iq_fft->set_retune_settle(seconds);
+
+    return STATUS_OK;
+}
+
+/**
+ * @brief Get the settle time measured after the last retune.
+ * @return The time in seconds until the signal power became stable,
+ *         or -1 if no retune has been measured on this device.
+ */
+double receiver::get_retune_settle_time(void)
+{
+    return iq_fft->get_retune_settle_time();
+}
+
 /**
  * @brief Get RF frequency.
  * @return The current RF frequency.
@@ -551,7 +554,7 @@ receiver::status receiver::set_rf_freq(double freq_hz)
  */
 double receiver::get_rf_freq(void)
 {
-    d_rf_freq = src->get_center_freq();
+    d_rf_freq = frontend->src()->get_center_freq();
 
     return d_rf_freq;
 }
@@ -567,7 +570,7 @@ receiver::status receiver::get_rf_range(double *start, double *stop, double *ste
 {
     osmosdr::freq_range_t range;
 
-    range = src->get_freq_range();
+    range = frontend->src()->get_freq_range();
 
     // currently range is empty for all but E4000
     if (!range.empty())
@@ -588,7 +591,7 @@ receiver::status receiver::get_rf_range(double *start, double *stop, double *ste
 /** Get the names of available gain stages. */
 std::vector<std::string> receiver::get_gain_names()
 {
-    return src->get_gain_names();
+    return frontend->src()->get_gain_names();
 }
 
 /**
@@ -605,7 +608,7 @@ receiver::status receiver::get_gain_range(std::string &name, double *start,
 {
     osmosdr::gain_range_t range;
 
-    range = src->get_gain_range(name);
+    range = frontend->src()->get_gain_range(name);
     *start = range.start();
     *stop  = range.stop();
     *step  = range.step();
@@ -615,14 +618,14 @@ receiver::status receiver::get_gain_range(std::string &name, double *start,
 
 receiver::status receiver::set_gain(std::string name, double value)
 {
-    src->set_gain(value, name);
+    frontend->src()->set_gain(value, name);
 
     return STATUS_OK;
 }
 
 double receiver::get_gain(std::string name) const
 {
-    return src->get_gain(name);
+    return frontend->src()->get_gain(name);
 }
 
 /**
@@ -633,7 +636,7 @@ double receiver::get_gain(std::string name) const
  */
 receiver::status receiver::set_auto_gain(bool automatic)
 {
-    src->set_gain_mode(automatic);
+    frontend->src()->set_gain_mode(automatic);
 
     return STATUS_OK;
 }
@@ -655,105 +658,705 @@ receiver::status receiver::set_auto_gain(bool automatic)
 receiver::status receiver::set_filter_offset(double offset_hz)
 {
     d_filter_offset = offset_hz;
+    // the snapshot ring follows at the "ch_offset" tag of the ddc
     ddc->set_center_freq(d_filter_offset - d_cw_offset);
+    ddc->clear_freq_ramp();
+
+    return STATUS_OK;
+}
+
+/**
+ * @brief Get filter offset.
+ * @return The current filter offset.
+ * @sa set_filter_offset()
+ */
+double receiver::get_filter_offset(void) const
+{
+    return d_filter_offset;
+}
+
+/**
+ * @brief Follow a frequency ramp, e.g. the Doppler shift of a satellite.
+ * @param offset_hz Offset from the tuned frequency at start_ns [Hz].
+ * @param rate Rate of change [Hz/s].
+ * @param start_ns UNIX time in ns the ramp starts at, negative for now.
+ * @return STATUS_ERROR if the offset is outside +/- DDC_RAMP_LIMIT.
+ *
+ * The ramp is applied per sample in the downconverter, without retuning.
+ * It is stopped by set_filter_offset() and set_rf_freq().
+ */
+receiver::status receiver::set_freq_ramp(double offset_hz, double rate, int64_t start_ns)
+{
+    if (std::abs(offset_hz) > DDC_RAMP_LIMIT)
+        return STATUS_ERROR;
+
+    ddc->set_freq_ramp(offset_hz, rate, start_ns);
+
+    return STATUS_OK;
+}
+
+/** Stop the frequency ramp and return to the tuned frequency. */
+void receiver::clear_freq_ramp(void)
+{
+    ddc->clear_freq_ramp();
+}
+
+/** Get the current offset of the frequency ramp and its rate of change. */
+void receiver::get_freq_ramp(double &offset_hz, double &rate)
+{
+    ddc->get_freq_ramp(offset_hz, rate);
+}
+
+/* CW offset can serve as a "BFO" if the GUI needs it */
+receiver::status receiver::set_cw_offset(double offset_hz)
+{
+    d_cw_offset = offset_hz;
+    ddc->set_center_freq(d_filter_offset - d_cw_offset);
+    rx->set_cw_offset(d_cw_offset);
+
+    return STATUS_OK;
+}
+
+double receiver::get_cw_offset(void) const
+{
+    return d_cw_offset;
+}
+
+receiver::status receiver::set_filter(double low, double high, filter_shape shape)
+{
+    double trans_width;
+
+    if ((low >= high) || (std::abs(high-low) < RX_FILTER_MIN_WIDTH))
+        return STATUS_ERROR;
+
+    switch (shape) {
+
+    case FILTER_SHAPE_SOFT:
+        trans_width = std::abs(high - low) * 0.5;
+        break;
+
+    case FILTER_SHAPE_SHARP:
+        trans_width = std::abs(high - low) * 0.1;
+        break;
+
+    case FILTER_SHAPE_NORMAL:
+    default:
+        trans_width = std::abs(high - low) * 0.2;
+        break;
+
+    }
+
+    rx->set_filter(low, high, trans_width);
+
+    return STATUS_OK;
+}
+
+receiver::status receiver::set_freq_corr(double ppm)
+{
+    frontend->src()->set_freq_corr(ppm);
+
+    return STATUS_OK;
+}
+
+/**
+ * @brief Get current signal power.
+ * @param dbfs Whether to use dbfs or absolute power.
+ * @return The current signal power.
+ *
+ * This method returns the current signal power detected by the receiver. The detector
+ * is located after the band pass filter. The full scale is 1.0
+ */
+float receiver::get_signal_pwr() const
+{
+    return rx->get_signal_level();
+}
+
+/** Set new FFT size. */
+void receiver::set_iq_fft_size(int newsize)
+{
+    iq_fft->set_fft_size(newsize);
+    for (auto &s : d_extra_sources)
+        s->fft->set_fft_size(newsize);
+}
+
+unsigned int receiver::iq_fft_size() const
+{
+    return iq_fft->fft_size();
+}
+
+void receiver::set_iq_fft_window(int window_type, bool normalize_energy)
+{
+    d_fft_window = window_type;
+    d_fft_normalize = normalize_energy;
+    iq_fft->set_window_type(window_type, normalize_energy);
+    for (auto &s : d_extra_sources)
+        s->fft->set_window_type(window_type, normalize_energy);
+}
+
+/**
+ * @brief Set the rate at which the baseband FFT is read.
+ * @param fps Frames per second, 0 if the FFT is not read.
+ *
+ * Lets the FFT block copy only the samples needed for each frame.
+ */
+void receiver::set_iq_fft_rate(float fps)
+{
+    d_fft_rate = fps;
+    iq_fft->set_frame_rate(fps);
+    for (auto &s : d_extra_sources)
+        s->fft->set_frame_rate(fps);
+}
+
+/** Get latest baseband FFT data. */
+int receiver::get_iq_fft_data(float* fftPoints)
+{
+    return iq_fft->get_fft_data(fftPoints);
+}
+
+/**
+ * @brief Select the signal shown by the time domain scope.
+ *
+ * Like set_dc_cancel() this rebuilds the flow graph.
+ */
+void receiver::set_scope_source(scope_source source)
+{
+    if (source == d_scope_source)
+        return;
+
+    d_scope_source = source;
+    set_demod(d_demod, true);
+    scope_data->clear();
+}
+
+/** Sample rate of the signal shown by the scope, 0 if it is off. */
+double receiver::get_scope_rate(void) const
+{
+    switch (d_scope_source)
+    {
+    case SCOPE_BASEBAND:
+        return d_decim_rate;
+    case SCOPE_CHANNEL:
+        return d_quad_rate;
+    case SCOPE_AUDIO:
+        return d_audio_rate;
+    default:
+        return 0.0;
+    }
+}
+
+/**
+ * @brief Get the envelope shown by the scope.
+ * @param span_s Time span in seconds.
+ * @param pixels Number of columns.
+ * @param mins Minimum of each column, NaN where there is no data.
+ * @param maxs Maximum of each column, NaN where there is no data.
+ * @param trigger A scope_pyramid::trigger_mode.
+ * @param level Trigger level.
+ * @return The number of columns filled, -1 if the scope is off.
+ */
+int receiver::get_scope_data(double span_s, int pixels, float *mins, float *maxs,
+                             int trigger, float level)
+{
+    double rate = get_scope_rate();
+
+    if (rate <= 0.0)
+        return -1;
+
+    return scope_data->envelope(span_s * rate, pixels, mins, maxs,
+                                (scope_pyramid::trigger_mode)trigger, level);
+}
+
+/** Samples lost because the DSP did not keep up with the input. */
+uint64_t receiver::get_input_overflows(void) const
+{
+    return frontend->overflows();
+}
+
+/** Fraction of the input FIFO waiting to be processed by the DSP. */
+double receiver::get_input_backlog(void) const
+{
+    return frontend->backlog();
+}
+
+/** Audio blocks lost because the WAV recorder did not keep up. */
+unsigned int receiver::get_recorder_drops(void) const
+{
+    return audio_out->recorder_dropped();
+}
+
+/** Native sample rate of a decoder_stream, 0 if the stream is not valid. */
+double receiver::decoder_stream_rate(int stream) const
+{
+    switch (stream)
+    {
+    case DECODER_STREAM_AUDIO:
+        return d_audio_rate;
+    case DECODER_STREAM_BASEBAND:
+        return d_decim_rate;
+    case DECODER_STREAM_CHANNEL:
+        return d_quad_rate;
+    default:
+        return 0.0;
+    }
+}
+
+/** Follow a change of the baseband or channel rate, called with the graph locked. */
+void receiver::update_decoder_rates(void)
+{
+    for (auto &tap : d_decoder_taps)
+    {
+        double native = decoder_stream_rate(tap.stream);
+
+        if (tap.rr_c)
+            tap.rr_c->set_rate(tap.rate / native);
+        else if (tap.rr_f)
+            tap.rr_f->set_rate(tap.rate / native);
+        else
+            tap.sink->set_sample_rate(native);
+    }
+}
+
+/**
+ * @brief Start a decoder plugin.
+ * @param plugin The plugin, owned by the receiver if it starts.
+ * @param destroy Function destroying the plugin.
+ * @return An id for remove_decoder(), -1 if the plugin did not start.
+ *
+ * Plugins using the same stream at the same rate share one resampler and
+ * one copy of the samples. The first plugin of a stream and rate rebuilds
+ * the flow graph.
+ */
+int receiver::add_decoder(decoder_plugin *plugin, decoder_destroy_fn destroy)
+{
+    int stream = plugin->stream();
+    double rate = plugin->sample_rate();
+    double native = decoder_stream_rate(stream);
+
+    if (native <= 0.0 || rate < 0.0)
+        return -1;
+
+    int id = decoders->add(plugin, destroy, rate > 0.0 ? rate : native);
+    if (id < 0)
+        return -1;
+
+    for (auto &tap : d_decoder_taps)
+    {
+        if (tap.stream == stream && tap.rate == rate)
+        {
+            tap.ids.push_back(id);
+            return id;
+        }
+    }
+
+    decoder_tap tap;
+    bool iq = (stream != DECODER_STREAM_AUDIO);
+
+    tap.stream = stream;
+    tap.rate = rate;
+    tap.ids.push_back(id);
+    if (rate > 0.0 && iq)
+        tap.rr_c = make_resampler_cc(rate / native);
+    else if (rate > 0.0)
+        tap.rr_f = make_resampler_ff(rate / native);
+    tap.sink = make_decoder_sink(decoders, stream, rate, rate > 0.0 ? rate : native, iq);
+    d_decoder_taps.push_back(tap);
+    set_demod(d_demod, true);
+
+    return id;
+}
+
+/**
+ * @brief Stop and unload a decoder plugin.
+ * @param id The id returned by add_decoder().
+ */
+receiver::status receiver::remove_decoder(int id)
+{
+    for (auto tap = d_decoder_taps.begin(); tap != d_decoder_taps.end(); ++tap)
+    {
+        auto it = std::find(tap->ids.begin(), tap->ids.end(), id);
+        if (it == tap->ids.end())
+            continue;
+
+        tap->ids.erase(it);
+        decoders->remove(id);
+        if (tap->ids.empty())
+        {
+            d_decoder_taps.erase(tap);
+            set_demod(d_demod, true);
+        }
+        return STATUS_OK;
+    }
+
+    return STATUS_ERROR;
+}
+
+/** Get the oldest event published by a decoder plugin and not read yet. */
+bool receiver::get_decoder_event(decoder_pool::event &ev)
+{
+    return decoders->get_event(ev);
+}
+
+/**
+ * @brief Set the size of the I/Q snapshot rings.
+ * @param baseband_size Baseband ring size in samples.
+ * @param channel_size Channel ring size in samples.
+ * @param shared Create the rings in POSIX shared memory, named /gqrx-baseband
+ *               and /gqrx-channel, so other programs can read them directly.
+ *
+ * This rebuilds the flow graph and the new rings start empty, unless the
+ * sizes and the mode are those already in use.
+ */
+void receiver::set_snapshot_buffers(size_t baseband_size, size_t channel_size,
+                                    bool shared)
+{
+    if (baseband_size == d_snap_bb_size && channel_size == d_snap_ch_size &&
+        shared == d_snap_shared)
+        return;
+
+    d_snap_bb_size = baseband_size;
+    d_snap_ch_size = channel_size;
+    d_snap_shared = shared;
+
+    if (d_running)
+    {
+        tb->stop();
+        tb->wait();
+    }
+
+    // Release the old shared memory objects before creating the new ones
+    tb->disconnect_all();
+    snap_bb_sink.reset();
+    snap_ch_sink.reset();
+    snap_bb.reset();
+    snap_ch.reset();
+
+    snap_bb = std::make_shared<iq_ring>(baseband_size, shared ? "/gqrx-baseband" : "");
+    snap_ch = std::make_shared<iq_ring>(channel_size, shared ? "/gqrx-channel" : "");
+    snap_bb_sink = make_snapshot_sink(snap_bb);
+    snap_ch_sink = make_snapshot_sink(snap_ch);
+    reset_snapshots();
+
+    apply_demod(d_demod);
+
+    if (d_running)
+        tb->start();
+}
+
+/**
+ * @brief Copy recent samples out of a snapshot ring.
+ * @param source The ring to copy from.
+ * @param n Number of samples wanted, fewer are returned if the ring holds less.
+ * @param center_ns Wall clock time in ns since the UNIX epoch to center the
+ *                  snapshot on, negative for the latest samples.
+ * @param samples Filled with the samples.
+ * @param meta Filled with the time, sample rate and frequency of the samples.
+ * @return false if the requested samples are not available.
+ *
+ * The rings are always connected, so this never changes the flow graph and
+ * only costs the copy.
+ */
+bool receiver::get_snapshot(snapshot_source source, size_t n, int64_t center_ns,
+                            std::vector<gr_complex> &samples, iq_ring::info &meta)
+{
+    iq_ring *ring = (source == SNAPSHOT_CHANNEL) ? snap_ch.get() : snap_bb.get();
+
+    samples.resize(std::min(n, ring->capacity() - ring->guard()));
+    if (!ring->snapshot(samples.data(), samples.size(), center_ns, meta))
+    {
+        samples.clear();
+        return false;
+    }
+    samples.resize(meta.count);
+
+    return true;
+}
+
+/**
+ * @brief Add an input source with a spectrum display of its own.
+ * @param device The device specifier.
+ * @return The number of the new source, 1 for the first one.
+ * @throws std::runtime_error if the device could not be opened.
+ *
+ * The source has no demodulator of its own. Its front end feeds a baseband
+ * FFT that uses the same size, window and frame rate as the main one, and
+ * the VFO channels added within its band. It is started and stopped
+ * together with the receiver.
+ */
+int receiver::add_input_source(const std::string &device)
+{
+    std::unique_ptr<extra_source> s(new extra_source);
+
+    // throws if the device can not be opened
+    s->frontend.reset(new input_frontend(device, 1));
+    if (s->frontend->src()->get_sample_rate() != 0)
+        s->frontend->set_input_rate(s->frontend->src()->get_sample_rate());
+
+    s->fft = make_rx_fft_c(iq_fft->fft_size(), s->frontend->decim_rate(),
+                           d_fft_window, d_fft_normalize);
+    s->fft->set_frame_rate(d_fft_rate);
+
+    s->tb = gr::make_top_block("gqrx_spectrum");
+    s->tb->connect(s->frontend->output(), 0, s->fft, 0);
+
+    if (d_running)
+    {
+        s->tb->start();
+        s->frontend->start();
+    }
+
+    d_extra_sources.push_back(std::move(s));
+
+    return (int)d_extra_sources.size();
+}
+
+/**
+ * @brief Close an additional input source and its VFO channels.
+ * @param id The source number. Sources after it move down by one, and so
+ *           do the channels after the removed ones.
+ */
+receiver::status receiver::remove_input_source(int id)
+{
+    if (id < 1 || id > (int)d_extra_sources.size())
+        return STATUS_ERROR;
+
+    extra_source *s = d_extra_sources[id - 1].get();
+    s->frontend->stop();
+    s->tb->stop();
+    s->tb->wait();
+    d_vfo_channels.erase(std::remove_if(d_vfo_channels.begin(), d_vfo_channels.end(),
+                                        [s](const vfo_entry &v) { return v.src == s; }),
+                         d_vfo_channels.end());
+    d_extra_sources.erase(d_extra_sources.begin() + (id - 1));
+
+    return STATUS_OK;
+}
+
+std::string receiver::get_source_device(int id) const
+{
+    if (id < 1 || id > (int)d_extra_sources.size())
+        return "";
+
+    return d_extra_sources[id - 1]->frontend->device();
+}
+
+receiver::status receiver::set_source_freq(int id, double freq_hz)
+{
+    if (id < 1 || id > (int)d_extra_sources.size())
+        return STATUS_ERROR;
+
+    extra_source *s = d_extra_sources[id - 1].get();
+    s->frontend->set_center_freq(freq_hz);
+    for (auto &v : d_vfo_channels)
+        if (v.src == s)
+            v.chan->set_offset(v.freq - freq_hz);
+
+    return STATUS_OK;
+}
+
+double receiver::get_source_freq(int id) const
+{
+    if (id < 1 || id > (int)d_extra_sources.size())
+        return 0.0;
+
+    return d_extra_sources[id - 1]->frontend->src()->get_center_freq();
+}
+
+/** Get the sample rate of the spectrum of an additional source. */
+double receiver::get_source_rate(int id) const
+{
+    if (id < 1 || id > (int)d_extra_sources.size())
+        return 0.0;
+
+    return d_extra_sources[id - 1]->frontend->decim_rate();
+}
+
+/** Get latest FFT data of an additional source, -1 if there is none. */
+int receiver::get_source_fft_data(int id, float *fftPoints)
+{
+    if (id < 1 || id > (int)d_extra_sources.size())
+        return -1;
+
+    return d_extra_sources[id - 1]->fft->get_fft_data(fftPoints);
+}
+
+/**
+ * @brief Demodulate a channel besides the main one.
+ * @param freq_hz The channel frequency.
+ * @param demod vfo_channel::DEMOD_AM or DEMOD_FM.
+ * @param squelch Recordings only run while the level is above this, in dBFS.
+ * @return The number of the new channel, 1 for the first one, or -1 if the
+ *         frequency is outside the baseband of every source.
+ *
+ * The channel is taken from the main baseband if it covers the frequency,
+ * otherwise from the first additional source that does. The channels of all
+ * sources run as tasks on one vfo_executor, so adding one does not add
+ * threads. A flow graph is only changed for the first channel of a source.
+ */
+int receiver::add_vfo_channel(double freq_hz, int demod, float squelch)
+{
+    extra_source *src = nullptr;
+    double center = d_rf_freq;
+    double rate = d_decim_rate;
+
+    if (std::abs(freq_hz - center) >= rate / 2.0)
+    {
+        auto it = std::find_if(d_extra_sources.begin(), d_extra_sources.end(),
+                               [freq_hz](const std::unique_ptr<extra_source> &s) {
+                                   return std::abs(freq_hz - s->frontend->src()->get_center_freq())
+                                          < s->frontend->decim_rate() / 2.0;
+                               });
+        if (it == d_extra_sources.end())
+            return -1;
+
+        src = it->get();
+        center = src->frontend->src()->get_center_freq();
+        rate = src->frontend->decim_rate();
+    }
+
+    if (!vfo_exec)
+    {
+        vfo_exec = std::make_shared<vfo_executor>();
+        vfo_rec = std::make_shared<vfo_writer>();
+    }
+
+    vfo_entry v;
+    v.freq = freq_hz;
+    v.chan = std::make_shared<vfo_channel>(rate, freq_hz - center,
+                                           demod, squelch, vfo_rec);
+    v.src = src;
+    d_vfo_channels.push_back(v);
+
+    if (src)
+    {
+        if (!src->vfo)
+        {
+            src->vfo = make_vfo_sink_c(vfo_exec);
+            src->vfo->add_channel(v.chan);
+            lock_graph(src->tb, "source tb->lock");
+            src->tb->connect(src->frontend->output(), 0, src->vfo, 0);
+            src->tb->unlock();
+        }
+        else
+        {
+            src->vfo->add_channel(v.chan);
+        }
+    }
+    else if (!vfo_sink)
+    {
+        vfo_sink = make_vfo_sink_c(vfo_exec);
+        vfo_sink->add_channel(v.chan);
+        set_demod(d_demod, true);
+    }
+    else
+    {
+        vfo_sink->add_channel(v.chan);
+    }
 
-    return STATUS_OK;
+    return (int)d_vfo_channels.size();
 }
 
 /**
- * @brief Get filter offset.
- * @return The current filter offset.
- * @sa set_filter_offset()
+ * @brief Stop demodulating a channel, and its recording.
+ * @param id The channel number. Channels after it move down by one.
  */
-double receiver::get_filter_offset(void) const
+receiver::status receiver::remove_vfo_channel(int id)
 {
-    return d_filter_offset;
-}
+    if (id < 1 || id > (int)d_vfo_channels.size())
+        return STATUS_ERROR;
 
-/* CW offset can serve as a "BFO" if the GUI needs it */
-receiver::status receiver::set_cw_offset(double offset_hz)
-{
-    d_cw_offset = offset_hz;
-    ddc->set_center_freq(d_filter_offset - d_cw_offset);
-    rx->set_cw_offset(d_cw_offset);
+    vfo_entry v = d_vfo_channels[id - 1];
+    d_vfo_channels.erase(d_vfo_channels.begin() + (id - 1));
+
+    // waits for the chunk in progress
+    if (v.src)
+    {
+        v.src->vfo->remove_channel(v.chan);
+        if (v.src->vfo->num_channels() == 0)
+        {
+            lock_graph(v.src->tb, "source tb->lock");
+            v.src->tb->disconnect(v.src->frontend->output(), 0, v.src->vfo, 0);
+            v.src->tb->unlock();
+            v.src->vfo.reset();
+        }
+    }
+    else
+    {
+        vfo_sink->remove_channel(v.chan);
+        if (vfo_sink->num_channels() == 0)
+        {
+            vfo_sink.reset();
+            set_demod(d_demod, true);
+        }
+    }
 
     return STATUS_OK;
 }
 
-double receiver::get_cw_offset(void) const
+double receiver::get_vfo_freq(int id) const
 {
-    return d_cw_offset;
+    if (id < 1 || id > (int)d_vfo_channels.size())
+        return 0.0;
+
+    return d_vfo_channels[id - 1].freq;
 }
 
-receiver::status receiver::set_filter(double low, double high, filter_shape shape)
+/** Get the source of a channel, 0 for the main baseband. */
+int receiver::get_vfo_source(int id) const
 {
-    double trans_width;
-
-    if ((low >= high) || (std::abs(high-low) < RX_FILTER_MIN_WIDTH))
-        return STATUS_ERROR;
-
-    switch (shape) {
-
-    case FILTER_SHAPE_SOFT:
-        trans_width = std::abs(high - low) * 0.5;
-        break;
-
-    case FILTER_SHAPE_SHARP:
-        trans_width = std::abs(high - low) * 0.1;
-        break;
-
-    case FILTER_SHAPE_NORMAL:
-    default:
-        trans_width = std::abs(high - low) * 0.2;
-        break;
-
-    }
+    if (id < 1 || id > (int)d_vfo_channels.size() || !d_vfo_channels[id - 1].src)
+        return 0;
 
-    rx->set_filter(low, high, trans_width);
+    for (size_t i = 0; i < d_extra_sources.size(); i++)
+        if (d_extra_sources[i].get() == d_vfo_channels[id - 1].src)
+            return (int)i + 1;
 
-    return STATUS_OK;
+    return 0;
 }
 
-receiver::status receiver::set_freq_corr(double ppm)
+int receiver::get_vfo_demod(int id) const
 {
-    src->set_freq_corr(ppm);
+    if (id < 1 || id > (int)d_vfo_channels.size())
+        return -1;
 
-    return STATUS_OK;
+    return d_vfo_channels[id - 1].chan->demod();
 }
 
-/**
- * @brief Get current signal power.
- * @param dbfs Whether to use dbfs or absolute power.
- * @return The current signal power.
- *
- * This method returns the current signal power detected by the receiver. The detector
- * is located after the band pass filter. The full scale is 1.0
- */
-float receiver::get_signal_pwr() const
+float receiver::get_vfo_squelch(int id) const
 {
-    return rx->get_signal_level();
-}
+    if (id < 1 || id > (int)d_vfo_channels.size())
+        return 0.0f;
 
-/** Set new FFT size. */
-void receiver::set_iq_fft_size(int newsize)
-{
-    iq_fft->set_fft_size(newsize);
+    return d_vfo_channels[id - 1].chan->squelch();
 }
 
-unsigned int receiver::iq_fft_size() const
+/** Get the smoothed power of a channel in dBFS. */
+float receiver::get_vfo_level(int id) const
 {
-    return iq_fft->fft_size();
+    if (id < 1 || id > (int)d_vfo_channels.size())
+        return -150.0f;
+
+    return d_vfo_channels[id - 1].chan->level();
 }
 
-void receiver::set_iq_fft_window(int window_type, bool normalize_energy)
+/** Record the audio of a channel to a WAV file while its squelch is open. */
+receiver::status receiver::start_vfo_recording(int id, const std::string &filename)
 {
-    iq_fft->set_window_type(window_type, normalize_energy);
+    if (id < 1 || id > (int)d_vfo_channels.size())
+        return STATUS_ERROR;
+
+    if (!d_vfo_channels[id - 1].chan->open_recording(filename))
+        return STATUS_ERROR;
+
+    return STATUS_OK;
 }
 
-/** Get latest baseband FFT data. */
-int receiver::get_iq_fft_data(float* fftPoints)
+/** Get the file a channel is recorded to, empty if none. */
+std::string receiver::get_vfo_recording(int id) const
 {
-    return iq_fft->get_fft_data(fftPoints);
+    if (id < 1 || id > (int)d_vfo_channels.size())
+        return "";
+
+    return d_vfo_channels[id - 1].chan->recording();
 }
 
 unsigned int receiver::audio_fft_size() const
@@ -869,6 +1472,20 @@ receiver::status receiver::set_demod(rx_demod demod, bool force)
     if (!force && (demod == d_demod))
         return ret;
 
+    if (d_update_depth > 0)
+    {
+        if (demod < RX_DEMOD_OFF || demod > RX_DEMOD_AMSYNC)
+            return STATUS_ERROR;
+
+        // Create the receiver now so that settings made before the commit
+        // end up in the right place, the wiring is done by commit_update().
+        select_rx_chain(demod_chain(demod));
+        d_demod = demod;
+        d_pending_demod = true;
+
+        return ret;
+    }
+
     // tb->lock() seems to hang occasionally
     if (d_running)
     {
@@ -876,7 +1493,21 @@ receiver::status receiver::set_demod(rx_demod demod, bool force)
         tb->wait();
     }
 
+    ret = apply_demod(demod);
+
+    if (d_running)
+        tb->start();
+
+    return ret;
+}
+
+/** Rewire the flow graph for a demodulator, the graph must be stopped. */
+receiver::status receiver::apply_demod(rx_demod demod)
+{
+    status ret = STATUS_OK;
+
     tb->disconnect_all();
+    d_audio_channels = 0;
 
     switch (demod)
     {
@@ -929,9 +1560,90 @@ receiver::status receiver::set_demod(rx_demod demod, bool force)
         break;
     }
 
+    // The channel count is only known once the demodulator is selected
+    if (demod != RX_DEMOD_OFF && ret == STATUS_OK)
+        connect_rx_outputs();
+
     d_demod = demod;
 
-    if (d_running)
+    return ret;
+}
+
+/** The receiver chain needed by a demodulator. */
+receiver::rx_chain receiver::demod_chain(rx_demod demod)
+{
+    switch (demod)
+    {
+    case RX_DEMOD_OFF:
+        return RX_CHAIN_NONE;
+
+    case RX_DEMOD_WFM_M:
+    case RX_DEMOD_WFM_S:
+    case RX_DEMOD_WFM_S_OIRT:
+        return RX_CHAIN_WFMRX;
+
+    default:
+        return RX_CHAIN_NBRX;
+    }
+}
+
+/**
+ * @brief Start a batch of settings changes.
+ *
+ * Changes that rewire the flow graph or restart the input front end
+ * (demodulator, DC cancellation, input decimation and rate) are collected
+ * until the matching commit_update() and then applied in one go. Other
+ * settings take effect immediately. Calls may be nested.
+ */
+void receiver::begin_update(void)
+{
+    d_update_depth++;
+}
+
+/**
+ * @brief Apply the changes collected since begin_update().
+ * @return STATUS_ERROR if there was no matching begin_update() or the
+ *         demodulator could not be set.
+ */
+receiver::status receiver::commit_update(void)
+{
+    status ret = STATUS_OK;
+
+    if (d_update_depth == 0)
+        return STATUS_ERROR;
+
+    if (--d_update_depth > 0)
+        return ret;
+
+    // One stop / start for the whole batch
+    bool restart = d_running && d_pending_demod;
+    if (restart)
+    {
+        tb->stop();
+        tb->wait();
+    }
+
+    // the front end is reconfigured once, the rate update follows below
+    if (d_pending_input_rate > 0.0)
+    {
+        d_input_rate = frontend->set_input_rate(d_pending_input_rate);
+        d_pending_rate = true;
+    }
+
+    if (d_pending_decim != 0 && d_pending_decim != d_decim)
+        apply_input_decim(d_pending_decim);
+    else if (d_pending_rate)
+        update_decim_rate();
+
+    if (d_pending_demod)
+        ret = apply_demod(d_demod);
+
+    d_pending_demod = false;
+    d_pending_rate = false;
+    d_pending_decim = 0;
+    d_pending_input_rate = 0.0;
+
+    if (restart)
         tb->start();
 
     return ret;
@@ -988,8 +1700,7 @@ receiver::status receiver::set_af_gain(float gain_db)
     /* convert dB to factor */
     k = powf(10.0f, gain_db / 20.0f);
     //std::cout << "G:" << gain_db << "dB / K:" << k << std::endl;
-    audio_gain0->set_k(k);
-    audio_gain1->set_k(k);
+    audio_out->set_gain(audio_output::OUTPUT_DEVICE, k);
 
     return STATUS_OK;
 }
@@ -999,10 +1710,8 @@ receiver::status receiver::set_af_gain(float gain_db)
  * @brief Start WAV file recorder.
  * @param filename The filename where to record.
  *
- * A new recorder object is created every time we start recording and deleted every time
- * we stop recording. The idea of creating one object and starting/stopping using different
- * file names does not work with WAV files (the initial /tmp/gqrx.wav will not be stopped
- * because the wav file can not be empty). See https://github.com/gqrx-sdr/gqrx/issues/36
+ * The recorder is fed by audio_out and permanently attached, so starting
+ * and stopping does not touch the flow graph.
  */
 receiver::status receiver::start_audio_recording(const std::string filename)
 {
@@ -1021,32 +1730,12 @@ receiver::status receiver::start_audio_recording(const std::string filename)
         return STATUS_ERROR;
     }
 
-    wav_gain0 = gr::blocks::multiply_const_ff::make(WAV_FILE_GAIN);
-    wav_gain1 = gr::blocks::multiply_const_ff::make(WAV_FILE_GAIN);
-
-    // if this fails, we don't want to go and crash now, do we
-    try {
-#if GNURADIO_VERSION < 0x030900
-        wav_sink = gr::blocks::wavfile_sink::make(filename.c_str(), 2,
-                                                  (unsigned int) d_audio_rate,
-                                                  16);
-#else
-        wav_sink = gr::blocks::wavfile_sink::make(filename.c_str(), 2,
-                                                  (unsigned int) d_audio_rate,
-                                                  gr::blocks::FORMAT_WAV, gr::blocks::FORMAT_PCM_16);
-#endif
-    }
-    catch (std::runtime_error &e) {
-        std::cout << "Error opening " << filename << ": " << e.what() << std::endl;
+    wav_rec->set_channels(rx->audio_channels());
+    if (!wav_rec->open(filename))
+    {
+        std::cout << "Error opening " << filename << std::endl;
         return STATUS_ERROR;
     }
-
-    tb->lock();
-    tb->connect(rx, 0, wav_gain0, 0);
-    tb->connect(rx, 1, wav_gain1, 0);
-    tb->connect(wav_gain0, 0, wav_sink, 0);
-    tb->connect(wav_gain1, 0, wav_sink, 1);
-    tb->unlock();
     d_recording_wav = true;
 
     std::cout << "Recording audio to " << filename << std::endl;
@@ -1071,23 +1760,9 @@ receiver::status receiver::stop_audio_recording()
         return STATUS_ERROR;
     }
 
-    // not strictly necessary to lock but I think it is safer
-    tb->lock();
-    wav_sink->close();
-    tb->disconnect(rx, 0, wav_gain0, 0);
-    tb->disconnect(rx, 1, wav_gain1, 0);
-    tb->disconnect(wav_gain0, 0, wav_sink, 0);
-    tb->disconnect(wav_gain1, 0, wav_sink, 1);
-
-    // Temporary workaround for https://github.com/gnuradio/gnuradio/issues/5436
-    tb->disconnect(ddc, 0, rx, 0);
-    tb->connect(ddc, 0, rx, 0);
-    // End temporary workaround
-
-    tb->unlock();
-    wav_gain0.reset();
-    wav_gain1.reset();
-    wav_sink.reset();
+    /* write what is still queued before closing the file */
+    audio_out->flush_recorder();
+    wav_rec->close();
     d_recording_wav = false;
 
     std::cout << "Audio recorder stopped" << std::endl;
@@ -1125,29 +1800,20 @@ receiver::status receiver::start_audio_playback(const std::string filename)
         return STATUS_ERROR;
     }
 
-    /** FIXME: We can only handle stereo files */
-    if (wav_src->channels() != 2)
+    if (wav_src->channels() < 1 || wav_src->channels() > 2)
     {
-        std::cout << "BUG: Can not handle other than 2 channels. File has " << wav_src->channels() << std::endl;
+        std::cout << "BUG: Can only handle mono or stereo files. File has " << wav_src->channels() << " channels" << std::endl;
         wav_src.reset();
 
         return STATUS_ERROR;
     }
 
     stop();
-    /* route demodulator output to null sink */
-    tb->disconnect(rx, 0, audio_gain0, 0);
-    tb->disconnect(rx, 1, audio_gain1, 0);
-    tb->disconnect(rx, 0, audio_fft, 0);
-    tb->disconnect(rx, 0, audio_udp_sink, 0);
-    tb->disconnect(rx, 1, audio_udp_sink, 1);
-    tb->connect(rx, 0, audio_null_sink0, 0); /** FIXME: other channel? */
-    tb->connect(rx, 1, audio_null_sink1, 0); /** FIXME: other channel? */
-    tb->connect(wav_src, 0, audio_gain0, 0);
-    tb->connect(wav_src, 1, audio_gain1, 0);
-    tb->connect(wav_src, 0, audio_fft, 0);
-    tb->connect(wav_src, 0, audio_udp_sink, 0);
-    tb->connect(wav_src, 1, audio_udp_sink, 1);
+    /* the WAV recorder follows audio_out and records the playback */
+    disconnect_audio(rx);
+    for (int ch = 0; ch < rx->audio_channels(); ch++)
+        tb->connect(rx, ch, rx_null_sink, ch);
+    connect_audio(wav_src, wav_src->channels());
     start();
 
     std::cout << "Playing audio from " << filename << std::endl;
@@ -1160,18 +1826,10 @@ receiver::status receiver::stop_audio_playback()
 {
     /* disconnect wav source and reconnect receiver */
     stop();
-    tb->disconnect(wav_src, 0, audio_gain0, 0);
-    tb->disconnect(wav_src, 1, audio_gain1, 0);
-    tb->disconnect(wav_src, 0, audio_fft, 0);
-    tb->disconnect(wav_src, 0, audio_udp_sink, 0);
-    tb->disconnect(wav_src, 1, audio_udp_sink, 1);
-    tb->disconnect(rx, 0, audio_null_sink0, 0);
-    tb->disconnect(rx, 1, audio_null_sink1, 0);
-    tb->connect(rx, 0, audio_gain0, 0);
-    tb->connect(rx, 1, audio_gain1, 0);
-    tb->connect(rx, 0, audio_fft, 0);  /** FIXME: other channel? */
-    tb->connect(rx, 0, audio_udp_sink, 0);
-    tb->connect(rx, 1, audio_udp_sink, 1);
+    disconnect_audio(wav_src);
+    for (int ch = 0; ch < rx->audio_channels(); ch++)
+        tb->disconnect(rx, ch, rx_null_sink, ch);
+    connect_audio(rx, rx->audio_channels());
     start();
 
     /* delete wav_src since we can not change file name */
@@ -1183,14 +1841,14 @@ receiver::status receiver::stop_audio_playback()
 /** Start UDP streaming of audio. */
 receiver::status receiver::start_udp_streaming(const std::string host, int port, bool stereo)
 {
-    audio_udp_sink->start_streaming(host, port, stereo);
+    audio_out->start_udp(host, port, stereo);
     return STATUS_OK;
 }
 
 /** Stop UDP streaming of audio. */
 receiver::status receiver::stop_udp_streaming()
 {
-    audio_udp_sink->stop_streaming();
+    audio_out->stop_udp();
     return STATUS_OK;
 }
 
@@ -1200,32 +1858,19 @@ receiver::status receiver::stop_udp_streaming()
  */
 receiver::status receiver::start_iq_recording(const std::string filename)
 {
-    receiver::status status = STATUS_OK;
-
     if (d_recording_iq) {
         std::cout << __func__ << ": already recording" << std::endl;
         return STATUS_ERROR;
     }
 
-    try
-    {
-        iq_sink = gr::blocks::file_sink::make(sizeof(gr_complex), filename.c_str(), true);
-    }
-    catch (std::runtime_error &e)
+    if (!iq_rec->open(filename))
     {
         std::cout << __func__ << ": couldn't open I/Q file" << std::endl;
         return STATUS_ERROR;
     }
-
-    tb->lock();
-    if (d_decim >= 2)
-        tb->connect(input_decim, 0, iq_sink, 0);
-    else
-        tb->connect(src, 0, iq_sink, 0);
     d_recording_iq = true;
-    tb->unlock();
 
-    return status;
+    return STATUS_OK;
 }
 
 /** Stop I/Q data recorder. */
@@ -1236,17 +1881,23 @@ receiver::status receiver::stop_iq_recording()
         return STATUS_ERROR;
     }
 
-    tb->lock();
-    iq_sink->close();
+    iq_rec->close();
+    d_recording_iq = false;
 
-    if (d_decim >= 2)
-        tb->disconnect(input_decim, 0, iq_sink, 0);
-    else
-        tb->disconnect(src, 0, iq_sink, 0);
+    return STATUS_OK;
+}
 
-    tb->unlock();
-    iq_sink.reset();
-    d_recording_iq = false;
+/**
+ * @brief Split I/Q and audio recordings into segments.
+ * @param seconds Length of each file in seconds, 0 to disable.
+ *
+ * The recorders switch files on the exact sample boundary, so consecutive
+ * segments can be concatenated without gaps.
+ */
+receiver::status receiver::set_recording_rollover(double seconds)
+{
+    iq_rec->set_rollover(seconds);
+    wav_rec->set_rollover(seconds);
 
     return STATUS_OK;
 }
@@ -1259,9 +1910,7 @@ receiver::status receiver::seek_iq_file(long pos)
 {
     receiver::status status = STATUS_OK;
 
-    tb->lock();
-
-    if (src->seek(pos, SEEK_SET))
+    if (frontend->seek(pos))
     {
         status = STATUS_OK;
     }
@@ -1270,8 +1919,6 @@ receiver::status receiver::seek_iq_file(long pos)
         status = STATUS_ERROR;
     }
 
-    tb->unlock();
-
     return status;
 }
 
@@ -1289,7 +1936,7 @@ receiver::status receiver::start_sniffer(unsigned int samprate, int buffsize)
 
     sniffer->set_buffer_size(buffsize);
     sniffer_rr = make_resampler_ff((float)samprate/(float)d_audio_rate);
-    tb->lock();
+    lock_graph(tb, "tb->lock");
     tb->connect(rx, 0, sniffer_rr, 0);
     tb->connect(sniffer_rr, 0, sniffer, 0);
     tb->unlock();
@@ -1308,7 +1955,7 @@ receiver::status receiver::stop_sniffer()
         return STATUS_ERROR;
     }
 
-    tb->lock();
+    lock_graph(tb, "tb->lock");
     tb->disconnect(rx, 0, sniffer_rr, 0);
 
     // Temporary workaround for https://github.com/gnuradio/gnuradio/issues/5436
@@ -1332,40 +1979,9 @@ void receiver::get_sniffer_data(float * outbuff, unsigned int &num)
     sniffer->get_samples(outbuff, num);
 }
 
-/** Convenience function to connect all blocks. */
-void receiver::connect_all(rx_chain type)
+/** Create the receiver for a chain type unless it is already in use. */
+void receiver::select_rx_chain(rx_chain type)
 {
-    gr::basic_block_sptr b;
-
-    // Setup source
-    b = src;
-
-    // Pre-processing
-    if (d_decim >= 2)
-    {
-        tb->connect(b, 0, input_decim, 0);
-        b = input_decim;
-    }
-
-    if (d_recording_iq)
-    {
-        // We record IQ with minimal pre-processing
-        tb->connect(b, 0, iq_sink, 0);
-    }
-
-    tb->connect(b, 0, iq_swap, 0);
-    b = iq_swap;
-
-    if (d_dc_cancel)
-    {
-        tb->connect(b, 0, dc_corr, 0);
-        b = dc_corr;
-    }
-
-    // Visualization
-    tb->connect(b, 0, iq_fft, 0);
-
-    // RX demod chain
     switch (type)
     {
     case RX_CHAIN_NBRX:
@@ -1387,30 +2003,78 @@ void receiver::connect_all(rx_chain type)
     default:
         break;
     }
+}
+
+/** Convenience function to connect all blocks. */
+void receiver::connect_all(rx_chain type)
+{
+    gr::basic_block_sptr b;
+
+    // Setup source, the device and input decimator run in the front end
+    b = frontend->output();
+
+    // We record IQ with minimal pre-processing
+    tb->connect(b, 0, iq_sink, 0);
+
+    tb->connect(b, 0, iq_swap, 0);
+    b = iq_swap;
+
+    if (d_dc_cancel)
+    {
+        tb->connect(b, 0, dc_corr, 0);
+        b = dc_corr;
+    }
+
+    // Visualization
+    tb->connect(b, 0, iq_fft, 0);
+    tb->connect(b, 0, snap_bb_sink, 0);
+    if (vfo_sink)
+        tb->connect(b, 0, vfo_sink, 0);
+
+    // RX demod chain
+    select_rx_chain(type);
 
     // Audio path (if there is a receiver)
     if (type != RX_CHAIN_NONE)
     {
         tb->connect(b, 0, ddc, 0);
         tb->connect(ddc, 0, rx, 0);
-        tb->connect(rx, 0, audio_fft, 0);
-        tb->connect(rx, 0, audio_udp_sink, 0);
-        tb->connect(rx, 1, audio_udp_sink, 1);
-        tb->connect(rx, 0, audio_gain0, 0);
-        tb->connect(rx, 1, audio_gain1, 0);
-        tb->connect(audio_gain0, 0, audio_snk, 0);
-        tb->connect(audio_gain1, 0, audio_snk, 1);
+        tb->connect(ddc, 0, snap_ch_sink, 0);
     }
 
-    // Recorders and sniffers
-    if (d_recording_wav)
+    // Time domain scope
+    if (d_scope_source == SCOPE_BASEBAND)
+        tb->connect(b, 0, scope_c, 0);
+    else if (d_scope_source == SCOPE_CHANNEL && type != RX_CHAIN_NONE)
+        tb->connect(ddc, 0, scope_c, 0);
+    else if (d_scope_source == SCOPE_AUDIO && type != RX_CHAIN_NONE)
+        tb->connect(rx, 0, scope_f, 0);
+
+    // Decoder plugins, the audio and channel streams need a receiver
+    for (auto &tap : d_decoder_taps)
     {
-        tb->connect(rx, 0, wav_gain0, 0);
-        tb->connect(rx, 1, wav_gain1, 0);
-        tb->connect(wav_gain0, 0, wav_sink, 0);
-        tb->connect(wav_gain1, 0, wav_sink, 1);
+        gr::basic_block_sptr src;
+
+        if (tap.stream == DECODER_STREAM_BASEBAND)
+            src = b;
+        else if (type == RX_CHAIN_NONE)
+            continue;
+        else
+            src = (tap.stream == DECODER_STREAM_CHANNEL) ? ddc : rx;
+
+        if (tap.rr_c || tap.rr_f)
+        {
+            gr::basic_block_sptr rr = tap.rr_c ? (gr::basic_block_sptr)tap.rr_c : tap.rr_f;
+            tb->connect(src, 0, rr, 0);
+            tb->connect(rr, 0, tap.sink, 0);
+        }
+        else
+        {
+            tb->connect(src, 0, tap.sink, 0);
+        }
     }
 
+    // Sniffers
     if (d_sniffer_active)
     {
         tb->connect(rx, 0, sniffer_rr, 0);
@@ -1418,6 +2082,40 @@ void receiver::connect_all(rx_chain type)
     }
 }
 
+/** Connect the receiver outputs, once its demodulator has been selected. */
+void receiver::connect_rx_outputs(void)
+{
+    connect_audio(rx, rx->audio_channels());
+}
+
+/**
+ * Connect an audio source to the output device through audio_out, which
+ * also feeds the audio FFT, the WAV recorder and the UDP streamer. Mono
+ * sources stay mono until a sink needs stereo.
+ */
+void receiver::connect_audio(gr::basic_block_sptr src, int channels)
+{
+    for (int ch = 0; ch < channels; ch++)
+    {
+        tb->connect(src, ch, audio_out, ch);
+        tb->connect(audio_out, ch, audio_snk, ch);
+    }
+
+    d_audio_channels = channels;
+}
+
+/** Undo connect_audio(). */
+void receiver::disconnect_audio(gr::basic_block_sptr src)
+{
+    for (int ch = 0; ch < d_audio_channels; ch++)
+    {
+        tb->disconnect(src, ch, audio_out, ch);
+        tb->disconnect(audio_out, ch, audio_snk, ch);
+    }
+
+    d_audio_channels = 0;
+}
+
 void receiver::get_rds_data(std::string &outbuff, int &num)
 {
     rx->get_rds_data(outbuff, num);
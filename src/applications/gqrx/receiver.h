@@ -23,18 +23,16 @@
 #ifndef RECEIVER_H
 #define RECEIVER_H
 
-#include <gnuradio/blocks/file_sink.h>
-#include <gnuradio/blocks/multiply_const.h>
 #include <gnuradio/blocks/null_sink.h>
-#include <gnuradio/blocks/wavfile_sink.h>
 #include <gnuradio/blocks/wavfile_source.h>
 #include <gnuradio/top_block.h>
-#include <osmosdr/source.h>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "dsp/correct_iq_cc.h"
+#include "dsp/decoder_sink.h"
 #include "dsp/downconverter.h"
-#include "dsp/filter/fir_decim.h"
 #include "dsp/rx_noise_blanker_cc.h"
 #include "dsp/rx_filter.h"
 #include "dsp/rx_meter.h"
@@ -42,9 +40,15 @@
 #include "dsp/rx_demod_fm.h"
 #include "dsp/rx_demod_am.h"
 #include "dsp/rx_fft.h"
+#include "dsp/scope_sink.h"
+#include "dsp/snapshot_sink.h"
 #include "dsp/sniffer_f.h"
 #include "dsp/resampler_xx.h"
-#include "interfaces/udp_sink_f.h"
+#include "dsp/vfo_channel.h"
+#include "dsp/vfo_sink_c.h"
+#include "applications/gqrx/input_frontend.h"
+#include "interfaces/audio_output.h"
+#include "interfaces/file_recorder.h"
 #include "receivers/receiver_base.h"
 
 #ifdef WITH_PULSEAUDIO
@@ -105,7 +109,23 @@ public:
         FILTER_SHAPE_SHARP = 2   /*!< Sharp: Transition band is TBD of width. */
     };
 
+    /** Signal shown by the time domain scope. */
+    enum scope_source {
+        SCOPE_OFF      = 0,  /*!< Scope not connected. */
+        SCOPE_BASEBAND = 1,  /*!< Magnitude of the input after decimation. */
+        SCOPE_CHANNEL  = 2,  /*!< Magnitude of the down-converted channel. */
+        SCOPE_AUDIO    = 3   /*!< Demodulator output, first channel. */
+    };
+
+    /** Signal kept for I/Q snapshots. */
+    enum snapshot_source {
+        SNAPSHOT_BASEBAND = 0,  /*!< Input after decimation, I/Q swap and DC removal. */
+        SNAPSHOT_CHANNEL  = 1   /*!< Down-converted channel fed to the demodulator. */
+    };
+
     static const unsigned int DEFAULT_FFT_SIZE = 8192;
+    static const size_t DEFAULT_SNAPSHOT_BB = 1u << 22;
+    static const size_t DEFAULT_SNAPSHOT_CH = 1u << 20;
 
     receiver(const std::string input_device="",
              const std::string audio_device="",
@@ -144,6 +164,8 @@ public:
 
     status      set_rf_freq(double freq_hz);
     double      get_rf_freq(void);
+    status      set_retune_settle(double seconds);
+    double      get_retune_settle_time(void);
     status      get_rf_range(double *start, double *stop, double *step);
 
     std::vector<std::string>    get_gain_names();
@@ -157,16 +179,64 @@ public:
     double      get_filter_offset(void) const;
     status      set_cw_offset(double offset_hz);
     double      get_cw_offset(void) const;
+    status      set_freq_ramp(double offset_hz, double rate, int64_t start_ns = -1);
+    void        clear_freq_ramp(void);
+    void        get_freq_ramp(double &offset_hz, double &rate);
     status      set_filter(double low, double high, filter_shape shape);
     status      set_freq_corr(double ppm);
     float       get_signal_pwr() const;
     void        set_iq_fft_size(int newsize);
     unsigned int iq_fft_size(void) const;
     void        set_iq_fft_window(int window_type, bool normalize_energy);
+    void        set_iq_fft_rate(float fps);
     int         get_iq_fft_data(float* fftPoints);
     int         get_audio_fft_data(float* fftPoints);
     unsigned int audio_fft_size(void) const;
 
+    /* Time domain scope */
+    void        set_scope_source(scope_source source);
+    double      get_scope_rate(void) const;
+    int         get_scope_data(double span_s, int pixels, float *mins, float *maxs,
+                               int trigger, float level);
+
+    /* Load indicators */
+    uint64_t    get_input_overflows(void) const;
+    double      get_input_backlog(void) const;
+    unsigned int get_recorder_drops(void) const;
+
+    /* Decoder plugins */
+    int         add_decoder(decoder_plugin *plugin, decoder_destroy_fn destroy);
+    status      remove_decoder(int id);
+    bool        get_decoder_event(decoder_pool::event &ev);
+
+    /* I/Q snapshots */
+    void        set_snapshot_buffers(size_t baseband_size, size_t channel_size,
+                                     bool shared);
+    bool        get_snapshot(snapshot_source source, size_t n, int64_t center_ns,
+                             std::vector<gr_complex> &samples, iq_ring::info &meta);
+
+    /* Additional input sources, numbered from 1 */
+    int         add_input_source(const std::string &device);
+    status      remove_input_source(int id);
+    int         num_input_sources(void) const { return (int)d_extra_sources.size(); }
+    std::string get_source_device(int id) const;
+    status      set_source_freq(int id, double freq_hz);
+    double      get_source_freq(int id) const;
+    double      get_source_rate(int id) const;
+    int         get_source_fft_data(int id, float *fftPoints);
+
+    /* Channels demodulated besides the main one, numbered from 1 */
+    int         add_vfo_channel(double freq_hz, int demod, float squelch);
+    status      remove_vfo_channel(int id);
+    int         num_vfo_channels(void) const { return (int)d_vfo_channels.size(); }
+    double      get_vfo_freq(int id) const;
+    int         get_vfo_source(int id) const;
+    int         get_vfo_demod(int id) const;
+    float       get_vfo_squelch(int id) const;
+    float       get_vfo_level(int id) const;
+    status      start_vfo_recording(int id, const std::string &filename);
+    std::string get_vfo_recording(int id) const;
+
     /* Noise blanker */
     status      set_nb_on(int nbid, bool on);
     status      set_nb_threshold(int nbid, float threshold);
@@ -185,6 +255,11 @@ public:
 
     status      set_demod(rx_demod demod, bool force=false);
 
+    /* Batched reconfiguration */
+    void        begin_update(void);
+    status      commit_update(void);
+    bool        is_updating(void) const { return d_update_depth > 0; }
+
     /* FM parameters */
     status      set_fm_maxdev(float maxdev_hz);
     status      set_fm_deemph(double tau);
@@ -209,6 +284,7 @@ public:
     /* I/Q recording and playback */
     status      start_iq_recording(const std::string filename);
     status      stop_iq_recording();
+    status      set_recording_rollover(double seconds);
     status      seek_iq_file(long pos);
 
     /* sample sniffer */
@@ -229,8 +305,22 @@ public:
     /* utility functions */
     static std::string escape_filename(std::string filename);
 
+    //! Get a path to a file containing random bytes
+    static std::string get_zero_file(void);
+
 private:
     void        connect_all(rx_chain type);
+    void        connect_rx_outputs(void);
+    void        connect_audio(gr::basic_block_sptr src, int channels);
+    void        disconnect_audio(gr::basic_block_sptr src);
+    void        update_decim_rate(void);
+    void        reset_snapshots(void);
+    double      decoder_stream_rate(int stream) const;
+    void        update_decoder_rates(void);
+    void        apply_input_decim(unsigned int decim);
+    status      apply_demod(rx_demod demod);
+    void        select_rx_chain(rx_chain type);
+    static rx_chain demod_chain(rx_demod demod);
 
 private:
     bool        d_running;          /*!< Whether receiver is running or not. */
@@ -254,11 +344,17 @@ private:
     std::string output_devstr; /*!< Current output device string. */
 
     rx_demod    d_demod;       /*!< Current demodulator. */
+    int         d_audio_channels;   /*!< Channels connected to the audio sink, 0 if none. */
+
+    int         d_update_depth;     /*!< Nesting level of begin_update(). */
+    bool        d_pending_demod;    /*!< Topology change deferred to commit_update(). */
+    bool        d_pending_rate;     /*!< Rate update deferred to commit_update(). */
+    unsigned int d_pending_decim;   /*!< Input decimation to apply, 0 if none. */
+    double      d_pending_input_rate; /*!< Input rate to apply, 0 if none. */
 
     gr::top_block_sptr         tb;        /*!< The GNU Radio top block. */
 
-    osmosdr::source::sptr     src;       /*!< Real time I/Q source. */
-    fir_decim_cc_sptr         input_decim;      /*!< Input decimator. */
+    std::unique_ptr<input_frontend> frontend; /*!< Device and input decimator, feeds tb. */
     receiver_base_cf_sptr     rx;        /*!< receiver. */
 
     dc_corr_cc_sptr           dc_corr;   /*!< DC corrector block. */
@@ -267,24 +363,71 @@ private:
     rx_fft_c_sptr             iq_fft;     /*!< Baseband FFT block. */
     rx_fft_f_sptr             audio_fft;  /*!< Audio FFT block. */
 
-    downconverter_cc_sptr     ddc;        /*!< Digital down-converter for demod chain. */
+    std::shared_ptr<scope_pyramid> scope_data; /*!< Envelope shown by the scope. */
+    scope_sink_sptr           scope_c;    /*!< Scope input for baseband and channel. */
+    scope_sink_sptr           scope_f;    /*!< Scope input for audio. */
+    scope_source              d_scope_source;
+
+    /*! \brief Feed of the decoder plugins using one stream and rate. */
+    struct decoder_tap
+    {
+        int                 stream;     /*!< A decoder_stream. */
+        double              rate;       /*!< Requested rate, 0 for native. */
+        std::vector<int>    ids;        /*!< Plugins using the tap. */
+        resampler_ff_sptr   rr_f;       /*!< Audio resampler, if rate is set. */
+        resampler_cc_sptr   rr_c;       /*!< I/Q resampler, if rate is set. */
+        decoder_sink_sptr   sink;
+    };
+
+    std::shared_ptr<decoder_pool> decoders;   /*!< Decoder plugins and their workers. */
+    std::vector<decoder_tap>  d_decoder_taps;
 
-    gr::blocks::multiply_const_ff::sptr audio_gain0; /*!< Audio gain block. */
-    gr::blocks::multiply_const_ff::sptr audio_gain1; /*!< Audio gain block. */
-    gr::blocks::multiply_const_ff::sptr wav_gain0; /*!< WAV file gain block. */
-    gr::blocks::multiply_const_ff::sptr wav_gain1; /*!< WAV file gain block. */
+    std::shared_ptr<iq_ring>  snap_bb;    /*!< Latest baseband samples. */
+    std::shared_ptr<iq_ring>  snap_ch;    /*!< Latest channel samples. */
+    snapshot_sink_sptr        snap_bb_sink;
+    snapshot_sink_sptr        snap_ch_sink;
+    size_t                    d_snap_bb_size;   /*!< Requested ring sizes and mode. */
+    size_t                    d_snap_ch_size;
+    bool                      d_snap_shared;
 
-    gr::blocks::file_sink::sptr         iq_sink;     /*!< I/Q file sink. */
+    downconverter_cc_sptr     ddc;        /*!< Digital down-converter for demod chain. */
 
-    gr::blocks::wavfile_sink::sptr      wav_sink;   /*!< WAV file sink for recording. */
+    audio_output_sptr                   audio_out;  /*!< Audio gain and fan-out to all audio consumers. */
+
+    file_recorder_ptr                   iq_rec;     /*!< I/Q recorder. */
+    file_recorder_sink_sptr             iq_sink;    /*!< Feeds iq_rec. */
+    file_recorder_ptr                   wav_rec;    /*!< WAV recorder, fed by audio_out. */
     gr::blocks::wavfile_source::sptr    wav_src;    /*!< WAV file source for playback. */
-    gr::blocks::null_sink::sptr         audio_null_sink0; /*!< Audio null sink used during playback. */
-    gr::blocks::null_sink::sptr         audio_null_sink1; /*!< Audio null sink used during playback. */
+    gr::blocks::null_sink::sptr         rx_null_sink; /*!< Demodulator outputs during playback, one input each. */
 
-    udp_sink_f_sptr   audio_udp_sink;  /*!< UDP sink to stream audio over the network. */
     sniffer_f_sptr    sniffer;    /*!< Sample sniffer for data decoders. */
     resampler_ff_sptr sniffer_rr; /*!< Sniffer resampler. */
 
+    /** An additional input source with a spectrum and VFO channels. */
+    struct extra_source
+    {
+        std::unique_ptr<input_frontend> frontend;
+        gr::top_block_sptr  tb;   /*!< frontend -> fft and vfo. */
+        rx_fft_c_sptr       fft;
+        vfo_sink_c_sptr     vfo;  /*!< frontend -> vfo_exec, while the source has channels. */
+    };
+    std::vector<std::unique_ptr<extra_source>> d_extra_sources;
+
+    /** A channel demodulated on the VFO executor. */
+    struct vfo_entry
+    {
+        double                          freq;
+        std::shared_ptr<vfo_channel>    chan;
+        extra_source                   *src;    /*!< nullptr for the main baseband. */
+    };
+    std::vector<vfo_entry>          d_vfo_channels;
+    std::shared_ptr<vfo_executor>   vfo_exec;   /*!< Shared by all sources, created with the first channel. */
+    std::shared_ptr<vfo_writer>     vfo_rec;    /*!< Writes the channel recordings. */
+    vfo_sink_c_sptr                 vfo_sink;   /*!< Baseband -> vfo_exec, while there are channels. */
+    int         d_fft_window;       /*!< Window type of the baseband FFTs. */
+    bool        d_fft_normalize;    /*!< Normalize window energy. */
+    float       d_fft_rate;         /*!< Frame rate of the baseband FFTs. */
+
 #ifdef WITH_PULSEAUDIO
     pa_sink_sptr              audio_snk;  /*!< Pulse audio sink. */
 #elif WITH_PORTAUDIO
@@ -292,9 +435,6 @@ private:
 #else
     gr::audio::sink::sptr     audio_snk;  /*!< gr audio sink */
 #endif
-
-    //! Get a path to a file containing random bytes
-    static std::string get_zero_file(void);
 };
 
 #endif // RECEIVER_H
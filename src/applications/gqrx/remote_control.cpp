@@ -30,6 +30,7 @@
 
 #define DEFAULT_RC_PORT            7356
 #define DEFAULT_RC_ALLOWED_HOSTS   "127.0.0.1"
+#define MAX_DECODER_EVENTS         1024
 
 RemoteControl::RemoteControl(QObject *parent) :
     QObject(parent)
@@ -43,13 +44,17 @@ RemoteControl::RemoteControl(QObject *parent) :
     rc_passband_lo = 0;
     rc_passband_hi = 0;
     rc_program_id = "0000";
+    rc_settle_time = -1.0;
     rds_status = false;
     signal_level = -200.0;
     squelch_level = -150.0;
     audio_gain = -6.0;
     audio_recorder_status = false;
+    batch_status = false;
     receiver_running = false;
     hamlib_compatible = false;
+    rc_ramp_ok = false;
+    rc_ramp_offset = 0.0;
 
     rc_port = DEFAULT_RC_PORT;
     rc_allowed_hosts.append(DEFAULT_RC_ALLOWED_HOSTS);
@@ -175,6 +180,7 @@ void RemoteControl::acceptConnection()
         if (address.isEqual(QHostAddress(allowed_host)))
         {
             connect(rc_socket, SIGNAL(readyRead()), this, SLOT(startRead()));
+            connect(rc_socket, SIGNAL(disconnected()), this, SLOT(endBatch()));
             return;
         }
     }
@@ -246,6 +252,16 @@ void RemoteControl::startRead()
             answer = cmd_LOS();
         else if (cmd == "LNB_LO")
             answer = cmd_lnb_lo(cmdlist);
+        else if (cmd == "SOURCE")
+            answer = cmd_source(cmdlist);
+        else if (cmd == "SNAPSHOT")
+            answer = cmd_snapshot(cmdlist);
+        else if (cmd == "DECODER")
+            answer = cmd_decoder(cmdlist);
+        else if (cmd == "CHANNEL")
+            answer = cmd_channel(cmdlist);
+        else if (cmd == "DOPPLER")
+            answer = cmd_doppler(cmdlist);
         else if (cmd == "\\chk_vfo")
             answer = QString("0\n");
         else if (cmd == "\\dump_state")
@@ -389,6 +405,71 @@ void RemoteControl::setGainStages(gain_list_t &gain_list)
     gains = gain_list;
 }
 
+/*! \brief Set the additional input sources (from mainwindow).
+ *  \param devices Device string of each source, source 1 first.
+ *  \param freqs Center frequency of each source in Hz.
+ */
+void RemoteControl::setInputSources(QStringList devices, QList<qint64> freqs)
+{
+    rc_sources = devices;
+    rc_source_freqs = freqs;
+}
+
+/*! \brief Set the data file written for a snapshot (from mainwindow).
+ *  \param path The .sigmf-data file, empty if the snapshot failed.
+ */
+void RemoteControl::setSnapshotFile(QString path)
+{
+    rc_snapshot_file = path;
+}
+
+/*! \brief Set the tuner settle time measured after the last retune (from mainwindow).
+ *  \param seconds The settle time, -1 if none has been measured.
+ */
+void RemoteControl::setSettleTime(double seconds)
+{
+    rc_settle_time = seconds;
+}
+
+/*! \brief Set the loaded decoder plugins (from mainwindow).
+ *  \param decoders "<id> <name> <path>" for each plugin.
+ */
+void RemoteControl::setDecoders(QStringList decoders)
+{
+    rc_decoders = decoders;
+}
+
+/*! \brief Set the VFO channels (from mainwindow).
+ *  \param channels "<n> <freq> <mode> <squelch> <level> <source> <file>" for each
+ *                  channel, channel 1 first.
+ */
+void RemoteControl::setVfoChannels(QStringList channels)
+{
+    rc_vfo_channels = channels;
+}
+
+/*! \brief Set the result of a frequency ramp command (from mainwindow).
+ *  \param ok The ramp was accepted.
+ *  \param offset Offset from the tuned frequency reached by the ramp in Hz.
+ */
+void RemoteControl::setFreqRampStatus(bool ok, double offset)
+{
+    rc_ramp_ok = ok;
+    rc_ramp_offset = offset;
+}
+
+/*! \brief Queue an event of a decoder plugin until it is read with DECODER EVENTS. */
+void RemoteControl::addDecoderEvent(qint64 time_ms, const QString &name,
+                                    const QString &type, const QString &text)
+{
+    QString line = QString("%1 %2 %3 %4").arg(time_ms).arg(name).arg(type).arg(text);
+
+    // Events may contain newlines, which would break the reply
+    rc_decoder_events.append(line.replace('\n', ' '));
+    while (rc_decoder_events.size() > MAX_DECODER_EVENTS)
+        rc_decoder_events.removeFirst();
+}
+
 /*! \brief Set value for a specific gain setting (from DockInputCtl). */
 bool RemoteControl::setGain(QString name, double gain)
 {
@@ -737,9 +818,11 @@ QString RemoteControl::cmd_get_func(QStringList cmdlist)
     QString func = cmdlist.value(1, "");
 
     if (func == "?")
-        answer = QString("RECORD DSP RDS\n");
+        answer = QString("RECORD DSP RDS BATCH\n");
     else if (func.compare("RECORD", Qt::CaseInsensitive) == 0)
         answer = QString("%1\n").arg(audio_recorder_status);
+    else if (func.compare("BATCH", Qt::CaseInsensitive) == 0)
+        answer = QString("%1\n").arg(batch_status);
     else if (func.compare("DSP", Qt::CaseInsensitive) == 0)
         answer = QString("%1\n").arg(receiver_running);
     else if (func.compare("RDS", Qt::CaseInsensitive) == 0)
@@ -760,7 +843,7 @@ QString RemoteControl::cmd_set_func(QStringList cmdlist)
 
     if (func == "?")
     {
-        answer = QString("RECORD DSP RDS\n");
+        answer = QString("RECORD DSP RDS BATCH TRACE\n");
     }
     else if ((func.compare("RECORD", Qt::CaseInsensitive) == 0) && ok)
     {
@@ -796,6 +879,24 @@ QString RemoteControl::cmd_set_func(QStringList cmdlist)
 
         answer = QString("RPRT 0\n");
     }
+    else if ((func.compare("TRACE", Qt::CaseInsensitive) == 0) && ok)
+    {
+        emit traceChanged(status != 0);
+        answer = QString("RPRT 0\n");
+    }
+    else if ((func.compare("BATCH", Qt::CaseInsensitive) == 0) && ok)
+    {
+        if ((status != 0) == batch_status)
+        {
+            answer = QString("RPRT 1\n");
+        }
+        else
+        {
+            batch_status = (status != 0);
+            emit batchChanged(batch_status);
+            answer = QString("RPRT 0\n");
+        }
+    }
     else
     {
         answer = QString("RPRT 1\n");
@@ -811,9 +912,11 @@ QString RemoteControl::cmd_get_param(QStringList cmdlist)
     QString func = cmdlist.value(1, "");
 
     if (func == "?")
-        answer = QString("RDS_PI\n");
+        answer = QString("RDS_PI SETTLE\n");
     else if (func.compare("RDS_PI", Qt::CaseInsensitive) == 0)
         answer = QString("%1\n").arg(rc_program_id);
+    else if (func.compare("SETTLE", Qt::CaseInsensitive) == 0)
+        answer = QString("%1\n").arg(rc_settle_time, 0, 'f', 4);
     else
         answer = QString("RPRT 1\n");
 
@@ -871,6 +974,19 @@ QString RemoteControl::cmd_AOS()
     return QString("RPRT 0\n");
 }
 
+/*! \brief Commit pending receiver changes if a batch is open.
+ *
+ * Called when the client disconnects so that a batch is never left open.
+ */
+void RemoteControl::endBatch()
+{
+    if (batch_status)
+    {
+        batch_status = false;
+        emit batchChanged(false);
+    }
+}
+
 /* Gpredict / Gqrx specific command: LOS - satellite LOS event */
 QString RemoteControl::cmd_LOS()
 {
@@ -902,6 +1018,243 @@ QString RemoteControl::cmd_lnb_lo(QStringList cmdlist)
     }
 }
 
+/*
+ * Additional input sources
+ *
+ *   SOURCE                  number of sources, then "<n> <freq> <device>" for each
+ *   SOURCE ADD <device>     open a source, replies with its number
+ *   SOURCE DEL <n>          close source n
+ *   SOURCE F <n> <freq>     tune source n
+ *
+ * The sources are handled by mainwindow, which updates rc_sources before
+ * the signal returns.
+ */
+QString RemoteControl::cmd_source(QStringList cmdlist)
+{
+    if (cmdlist.size() == 1)
+    {
+        QString answer = QString("%1\n").arg(rc_sources.size());
+        for (int i = 0; i < rc_sources.size(); i++)
+            answer.append(QString("%1 %2 %3\n").arg(i + 1)
+                          .arg(rc_source_freqs.value(i)).arg(rc_sources[i]));
+        return answer;
+    }
+
+    QString func = cmdlist[1].toUpper();
+    bool ok;
+
+    if (func == "ADD" && cmdlist.size() >= 3)
+    {
+        int num = rc_sources.size();
+        emit newInputSource(cmdlist.mid(2).join(" "));
+        if (rc_sources.size() > num)
+            return QString("%1\n").arg(rc_sources.size());
+    }
+    else if (func == "DEL" && cmdlist.size() == 3)
+    {
+        int id = cmdlist[2].toInt(&ok);
+        if (ok && id >= 1 && id <= rc_sources.size())
+        {
+            emit removeInputSource(id);
+            return QString("RPRT 0\n");
+        }
+    }
+    else if (func == "F" && cmdlist.size() == 4)
+    {
+        int id = cmdlist[2].toInt(&ok);
+        qint64 freq = ok ? (qint64)cmdlist[3].toDouble(&ok) : 0;
+        if (ok && id >= 1 && id <= rc_sources.size())
+        {
+            emit newSourceFrequency(id, freq);
+            return QString("RPRT 0\n");
+        }
+    }
+
+    return QString("RPRT 1\n");
+}
+
+/*
+ * I/Q snapshots
+ *
+ *   SNAPSHOT BB|CH <n> [<time>]   save n samples, replies with the data file
+ *
+ * BB selects the baseband, CH the demodulator channel. Without a time the
+ * latest samples are saved, otherwise the samples centered on the UNIX time
+ * in seconds, which must still be in the buffer. The file is written by
+ * mainwindow, which sets rc_snapshot_file before the signal returns.
+ */
+QString RemoteControl::cmd_snapshot(QStringList cmdlist)
+{
+    if (cmdlist.size() != 3 && cmdlist.size() != 4)
+        return QString("RPRT 1\n");
+
+    QString src = cmdlist[1].toUpper();
+    bool ok;
+    qint64 samples = cmdlist[2].toLongLong(&ok);
+    double time = -1.0;
+
+    if (ok && cmdlist.size() == 4)
+        time = cmdlist[3].toDouble(&ok);
+    if (!ok || samples <= 0 || (src != "BB" && src != "CH"))
+        return QString("RPRT 1\n");
+
+    rc_snapshot_file.clear();
+    emit newSnapshot(src == "CH" ? 1 : 0, samples, time);
+    if (rc_snapshot_file.isEmpty())
+        return QString("RPRT 1\n");
+
+    return QString("%1\n").arg(rc_snapshot_file);
+}
+
+/*
+ * Decoder plugins
+ *
+ *   DECODER                 number of plugins, then "<id> <name> <path>" for each
+ *   DECODER UNLOAD <id>     stop and unload a plugin
+ *   DECODER EVENTS          number of events, then "<time> <name> <type> <text>"
+ *                           for each event published since the last call
+ *
+ * The plugins are handled by mainwindow, which updates rc_decoders before
+ * the signal returns. Event times are in ms since the UNIX epoch, at most
+ * the latest MAX_DECODER_EVENTS events are kept.
+ *
+ * Plugins are only loaded from decoders/plugins in the configuration, there
+ * is no remote command to load one: it would let any client run code.
+ */
+QString RemoteControl::cmd_decoder(QStringList cmdlist)
+{
+    if (cmdlist.size() == 1)
+        return QString("%1\n").arg(rc_decoders.size()) +
+               rc_decoders.join("\n") + (rc_decoders.isEmpty() ? "" : "\n");
+
+    QString func = cmdlist[1].toUpper();
+    bool ok;
+
+    if (func == "UNLOAD" && cmdlist.size() == 3)
+    {
+        int id = cmdlist[2].toInt(&ok);
+        int num = rc_decoders.size();
+        if (ok)
+        {
+            emit removeDecoder(id);
+            if (rc_decoders.size() < num)
+                return QString("RPRT 0\n");
+        }
+    }
+    else if (func == "EVENTS" && cmdlist.size() == 2)
+    {
+        QString answer = QString("%1\n").arg(rc_decoder_events.size());
+        for (const QString &ev : rc_decoder_events)
+            answer.append(ev + "\n");
+        rc_decoder_events.clear();
+        return answer;
+    }
+
+    return QString("RPRT 1\n");
+}
+
+/*
+ * Channels demodulated besides the main receiver
+ *
+ *   CHANNEL                 number of channels, then one line per channel
+ *   CHANNEL ADD <freq> AM|FM [<squelch>] [REC]
+ *                           start a channel, replies with its number
+ *   CHANNEL DEL <n>         stop channel n
+ *
+ * The channel comes from the first source whose baseband covers <freq>.
+ * The channels are handled by mainwindow, which updates rc_vfo_channels
+ * before the signal returns. The levels are updated with the S-meter.
+ */
+QString RemoteControl::cmd_channel(QStringList cmdlist)
+{
+    if (cmdlist.size() == 1)
+        return QString("%1\n").arg(rc_vfo_channels.size()) +
+               rc_vfo_channels.join("\n") + (rc_vfo_channels.isEmpty() ? "" : "\n");
+
+    QString func = cmdlist[1].toUpper();
+    bool ok;
+
+    if (func == "ADD" && cmdlist.size() >= 4 && cmdlist.size() <= 6)
+    {
+        qint64 freq = (qint64)cmdlist[2].toDouble(&ok);
+        QString mode = cmdlist[3].toUpper();
+        double squelch = -150.0;
+        bool record = false;
+
+        for (int i = 4; ok && i < cmdlist.size(); i++)
+        {
+            if (cmdlist[i].toUpper() == "REC" && i == cmdlist.size() - 1)
+                record = true;
+            else if (i == 4)
+                squelch = cmdlist[i].toDouble(&ok);
+            else
+                ok = false;
+        }
+
+        if (ok && (mode == "AM" || mode == "FM"))
+        {
+            int num = rc_vfo_channels.size();
+            emit newVfoChannel(freq, mode == "AM" ? 0 : 1, squelch, record);
+            if (rc_vfo_channels.size() > num)
+                return QString("%1\n").arg(rc_vfo_channels.size());
+        }
+    }
+    else if (func == "DEL" && cmdlist.size() == 3)
+    {
+        int id = cmdlist[2].toInt(&ok);
+        if (ok && id >= 1 && id <= rc_vfo_channels.size())
+        {
+            emit removeVfoChannel(id);
+            return QString("RPRT 0\n");
+        }
+    }
+
+    return QString("RPRT 1\n");
+}
+
+/*
+ * Doppler tracking
+ *
+ *   DOPPLER <freq> <rate> [<time>]  follow freq [Hz] changing by rate [Hz/s]
+ *   DOPPLER OFF                     stop and tune to the frequency reached
+ *
+ * The ramp is applied per sample in the downconverter, so a tracking client
+ * only needs to send a new ramp every few seconds instead of many F commands.
+ * With <time>, UNIX time in seconds, the ramp starts at freq at that time;
+ * ramps for future times are queued. The frequency must stay within
+ * DDC_RAMP_LIMIT of the tuned frequency. Any retune stops the ramp.
+ */
+QString RemoteControl::cmd_doppler(QStringList cmdlist)
+{
+    if (cmdlist.size() == 2 && cmdlist[1].toUpper() == "OFF")
+    {
+        // mainwindow stops the ramp unless the retune below will
+        rc_ramp_offset = 0.0;
+        emit stopFreqRamp();
+        if (qRound64(rc_ramp_offset) != 0)
+            setNewRemoteFreq(rc_freq + qRound64(rc_ramp_offset));
+        return QString("RPRT 0\n");
+    }
+
+    if (cmdlist.size() != 3 && cmdlist.size() != 4)
+        return QString("RPRT 1\n");
+
+    bool ok;
+    double freq = cmdlist[1].toDouble(&ok);
+    double rate = ok ? cmdlist[2].toDouble(&ok) : 0.0;
+    double time = -1.0;
+
+    if (ok && cmdlist.size() == 4)
+        time = cmdlist[3].toDouble(&ok);
+    if (!ok)
+        return QString("RPRT 1\n");
+
+    rc_ramp_ok = false;
+    emit newFreqRamp(freq - rc_freq, rate, time);
+
+    return QString(rc_ramp_ok ? "RPRT 0\n" : "RPRT 1\n");
+}
+
 /*
  * '\dump_state' used by hamlib clients, e.g. xdx, fldigi, rigctl and etc
  * More info:
@@ -52,6 +52,8 @@
  * We also have some gqrx specific commands:
  *
  *  close: Close connection (useful for interactive telnet sessions).
+ *  SOURCE: List, add, remove and tune additional input sources.
+ *  SNAPSHOT: Save recent I/Q samples to a SigMF file.
  *
  *
  * FIXME: The server code is very minimalistic and probably not very robust.
@@ -82,6 +84,12 @@ public:
     }
     void setReceiverStatus(bool enabled);
     void setGainStages(gain_list_t &gain_list);
+    void setInputSources(QStringList devices, QList<qint64> freqs);
+    void setSnapshotFile(QString path);
+    void setDecoders(QStringList decoders);
+    void setVfoChannels(QStringList channels);
+    void setSettleTime(double seconds);
+    void setFreqRampStatus(bool ok, double offset);
 
 public slots:
     void setNewFrequency(qint64 freq);
@@ -98,6 +106,8 @@ public slots:
     bool setGain(QString name, double gain);
     void setRDSstatus(bool enabled);
     void rdsPI(QString program_id);
+    void addDecoderEvent(qint64 time_ms, const QString &name, const QString &type,
+                         const QString &text);
 
 signals:
     void newFrequency(qint64 freq);
@@ -112,10 +122,22 @@ signals:
     void gainChanged(QString name, double value);
     void dspChanged(bool value);
     void newRDSmode(bool value);
+    void batchChanged(bool active);
+    void traceChanged(bool enabled);
+    void newInputSource(QString device);
+    void removeInputSource(int id);
+    void newSourceFrequency(int id, qint64 freq);
+    void newSnapshot(int source, qint64 samples, double time);
+    void removeDecoder(int id);
+    void newVfoChannel(qint64 freq, int demod, double squelch, bool record);
+    void removeVfoChannel(int id);
+    void newFreqRamp(double offset, double rate, double time);
+    void stopFreqRamp();
 
 private slots:
     void acceptConnection();
     void startRead();
+    void endBatch();
 
 private:
     QTcpServer  rc_server;         /*!< The active server object. */
@@ -137,10 +159,20 @@ private:
     double      squelch_level;     /*!< Squelch level in dBFS */
     float       audio_gain;        /*!< Audio gain in dB */
     QString     rc_program_id;     /*!< RDS Program identification */
+    double      rc_settle_time;    /*!< Measured tuner settle time in s, -1 if none */
     bool        audio_recorder_status; /*!< Recording enabled */
+    bool        batch_status;      /*!< Receiver changes are being batched */
     bool        receiver_running;  /*!< Whether the receiver is running or not */
     bool        hamlib_compatible;
     gain_list_t gains;             /*!< Possible and current gain settings */
+    QStringList rc_sources;        /*!< Devices of the additional input sources */
+    QList<qint64> rc_source_freqs; /*!< Frequencies of the additional input sources */
+    QString     rc_snapshot_file;  /*!< Data file of the last snapshot, empty if it failed */
+    QStringList rc_decoders;       /*!< Loaded decoder plugins, "<id> <name> <path>" */
+    QStringList rc_decoder_events; /*!< Decoder events not read yet, oldest first */
+    QStringList rc_vfo_channels;   /*!< VFO channels, "<n> <freq> <mode> <squelch> <level> <file>" */
+    bool        rc_ramp_ok;        /*!< The last frequency ramp was accepted */
+    double      rc_ramp_offset;    /*!< Offset reached by the frequency ramp in Hz */
 
     void        setNewRemoteFreq(qint64 freq);
     int         modeStrToInt(QString mode_str);
@@ -164,6 +196,11 @@ private:
     QString     cmd_AOS();
     QString     cmd_LOS();
     QString     cmd_lnb_lo(QStringList cmdlist);
+    QString     cmd_source(QStringList cmdlist);
+    QString     cmd_snapshot(QStringList cmdlist);
+    QString     cmd_decoder(QStringList cmdlist);
+    QString     cmd_channel(QStringList cmdlist);
+    QString     cmd_doppler(QStringList cmdlist);
     QString     cmd_dump_state() const;
 };
 
@@ -0,0 +1,444 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QHostInfo>
+#include <QtGlobal>
+
+#include "applications/gqrx/spectrum_net.h"
+
+#define SPECTRUM_MAGIC      0x47515350  /* "GQSP" */
+#define SPECTRUM_VERSION    1
+#define SPECTRUM_STEP_DB    0.5f
+
+/* Keep a spectrum datagram below a 1500 byte MTU */
+#define MAX_DATAGRAM_BINS   1400
+
+#define NODE_TIMEOUT_MS     2000
+#define NODE_MAX_FRAMES     64
+#define MAX_NODES           64
+#define MAX_NODE_NAME       64
+
+QByteArray SpectrumFrame::encode() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out << (quint32)SPECTRUM_MAGIC << (quint8)SPECTRUM_VERSION << (quint8)type
+        << node.toUtf8() << time_ms << seq << freq;
+
+    if (type == TYPE_SPECTRUM)
+    {
+        float floor_db = levels.isEmpty() ? 0.0f :
+                         *std::min_element(levels.begin(), levels.end());
+
+        out << (qint64)span << floor_db << SPECTRUM_STEP_DB << (quint16)levels.size();
+        for (float l : levels)
+            out << (quint8)qBound(0, qRound((l - floor_db) / SPECTRUM_STEP_DB), 255);
+    }
+    else
+    {
+        out << level << (quint8)active;
+    }
+
+    return data;
+}
+
+/** Decode a datagram, false if it is not a valid frame. */
+bool SpectrumFrame::decode(const QByteArray &data)
+{
+    QDataStream in(data);
+    quint32     magic;
+    quint8      version, t;
+    QByteArray  name;
+
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    in >> magic >> version >> t;
+    if (in.status() != QDataStream::Ok || magic != SPECTRUM_MAGIC ||
+        version != SPECTRUM_VERSION)
+        return false;
+
+    type = t;
+    in >> name >> time_ms >> seq >> freq;
+    if (in.status() != QDataStream::Ok || name.size() > MAX_NODE_NAME)
+        return false;
+    node = QString::fromUtf8(name);
+
+    if (type == TYPE_SPECTRUM)
+    {
+        qint64  span_hz;
+        float   floor_db, step_db;
+        quint16 bins;
+
+        in >> span_hz >> floor_db >> step_db >> bins;
+        span = (double)span_hz;
+        levels.resize(bins);
+        for (int i = 0; i < bins; i++)
+        {
+            quint8 v;
+            in >> v;
+            levels[i] = floor_db + v * step_db;
+        }
+        return in.status() == QDataStream::Ok && bins > 0 && span > 0.0;
+    }
+    else if (type == TYPE_EVENT)
+    {
+        quint8 a;
+
+        in >> level >> a;
+        active = a != 0;
+        return in.status() == QDataStream::Ok;
+    }
+
+    return false;
+}
+
+
+SpectrumPublisher::SpectrumPublisher(QObject *parent) :
+    QObject(parent),
+    d_port(0),
+    d_lookup_port(0),
+    d_lookup_id(-1),
+    d_max_bins(1024),
+    d_interval_ms(100),
+    d_threshold(15.0f),
+    d_last_ms(0),
+    d_seq(0)
+{
+}
+
+void SpectrumPublisher::readSettings(QSettings *settings)
+{
+    if (!settings)
+        return;
+
+    settings->beginGroup("spectrum_net");
+    QString dest = settings->value("publish_to", "").toString();
+    d_node = settings->value("node_name", QHostInfo::localHostName()).toString();
+    d_max_bins = qBound(16, settings->value("max_bins", 1024).toInt(), MAX_DATAGRAM_BINS);
+    d_interval_ms = 1000 / qBound(1, settings->value("publish_fps", 10).toInt(), 50);
+    d_threshold = settings->value("threshold_db", 15.0).toFloat();
+    settings->endGroup();
+
+    d_port = 0;
+    d_signals.clear();
+    if (d_lookup_id >= 0)
+    {
+        QHostInfo::abortHostLookup(d_lookup_id);
+        d_lookup_id = -1;
+    }
+    if (dest.isEmpty())
+        return;
+
+    bool ok;
+    int colon = dest.lastIndexOf(':');
+    int port = dest.mid(colon + 1).toInt(&ok);
+
+    if (colon <= 0 || !ok || port <= 0 || port > 65535)
+    {
+        qWarning() << "Invalid spectrum_net/publish_to:" << dest;
+        return;
+    }
+
+    // Publishing starts when the host name is resolved, without blocking the GUI
+    d_lookup_port = (quint16)port;
+    d_lookup_id = QHostInfo::lookupHost(dest.left(colon), this, SLOT(hostFound(QHostInfo)));
+}
+
+void SpectrumPublisher::hostFound(const QHostInfo &info)
+{
+    // Ignore lookups replaced by a later readSettings()
+    if (info.lookupId() != d_lookup_id)
+        return;
+
+    d_lookup_id = -1;
+    if (info.error() != QHostInfo::NoError || info.addresses().isEmpty())
+    {
+        qWarning() << "Can not resolve spectrum_net/publish_to:" << info.hostName()
+                   << info.errorString();
+        return;
+    }
+
+    d_host = info.addresses().first();
+    d_port = d_lookup_port;
+}
+
+/**
+ * @brief Publish the current spectrum.
+ * @param center_hz Center frequency of the spectrum.
+ * @param span_hz Width of the spectrum, i.e. the sample rate.
+ * @param fft FFT data as returned by receiver::get_iq_fft_data().
+ * @param size The FFT size.
+ *
+ * Calls faster than publish_fps are ignored.
+ */
+void SpectrumPublisher::publish(qint64 center_hz, double span_hz, const float *fft, int size)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    if (d_port == 0 || size <= 0 || now - d_last_ms < d_interval_ms)
+        return;
+    d_last_ms = now;
+
+    SpectrumFrame frame;
+    const int bins = std::min(size, d_max_bins);
+    const float scale = 1.0f / ((float)size * (float)size);
+
+    frame.type = SpectrumFrame::TYPE_SPECTRUM;
+    frame.time_ms = now;
+    frame.freq = center_hz;
+    frame.span = span_hz;
+    frame.levels.resize(bins);
+
+    // keep the peak of each group so narrow signals survive the reduction
+    for (int j = 0; j < bins; j++)
+    {
+        int i0 = (int)((qint64)j * size / bins);
+        int i1 = (int)((qint64)(j + 1) * size / bins);
+        float peak = 1e-20f;
+
+        for (int i = i0; i < i1; i++)
+            peak = std::max(peak, fft[i] * scale);
+        frame.levels[j] = 10.0f * log10f(peak);
+    }
+
+    send(frame);
+    detectEvents(frame);
+}
+
+/** Report peaks above the threshold that appeared or disappeared since the last frame. */
+void SpectrumPublisher::detectEvents(const SpectrumFrame &frame)
+{
+    const int n = frame.levels.size();
+    const double bin_hz = frame.span / n;
+    const double start = frame.freq - frame.span / 2.0;
+
+    QVector<float> sorted = frame.levels;
+    std::nth_element(sorted.begin(), sorted.begin() + n / 2, sorted.end());
+    const float limit = sorted[n / 2] + d_threshold;
+
+    QList<qint64> found;
+    QList<float>  found_level;
+    for (int i = 0; i < n; )
+    {
+        if (frame.levels[i] <= limit)
+        {
+            i++;
+            continue;
+        }
+
+        int peak = i;
+        for (; i < n && frame.levels[i] > limit; i++)
+            if (frame.levels[i] > frame.levels[peak])
+                peak = i;
+        found.append((qint64)(start + (peak + 0.5) * bin_hz));
+        found_level.append(frame.levels[peak]);
+    }
+
+    // signals within two bins are considered the same
+    const qint64 tol = (qint64)(2.0 * bin_hz);
+    auto known = [tol](const QList<qint64> &list, qint64 f) {
+        for (qint64 g : list)
+            if (std::abs(g - f) <= tol)
+                return true;
+        return false;
+    };
+
+    SpectrumFrame event;
+    event.type = SpectrumFrame::TYPE_EVENT;
+    event.time_ms = frame.time_ms;
+
+    for (int k = 0; k < found.size(); k++)
+    {
+        if (!known(d_signals, found[k]))
+        {
+            event.freq = found[k];
+            event.level = found_level[k];
+            event.active = true;
+            send(event);
+        }
+    }
+    for (qint64 f : d_signals)
+    {
+        if (!known(found, f))
+        {
+            int i = qBound(0, (int)((f - start) / bin_hz), n - 1);
+            event.freq = f;
+            event.level = frame.levels[i];
+            event.active = false;
+            send(event);
+        }
+    }
+
+    d_signals = found;
+}
+
+void SpectrumPublisher::send(SpectrumFrame &frame)
+{
+    frame.node = d_node;
+    frame.seq = d_seq++;
+    d_socket.writeDatagram(frame.encode(), d_host, d_port);
+}
+
+
+SpectrumCollector::SpectrumCollector(QObject *parent) :
+    QObject(parent),
+    d_bins(4096),
+    d_align_ms(250)
+{
+    connect(&d_socket, SIGNAL(readyRead()), this, SLOT(readPending()));
+    connect(&d_timer, SIGNAL(timeout()), this, SLOT(merge()));
+}
+
+void SpectrumCollector::readSettings(QSettings *settings)
+{
+    if (!settings)
+        return;
+
+    settings->beginGroup("spectrum_net");
+    int port = settings->value("collect_port", 0).toInt();
+    int fps = qBound(1, settings->value("collect_fps", 10).toInt(), 50);
+    d_bins = qBound(256, settings->value("collect_bins", 4096).toInt(), 65536);
+    d_align_ms = qMax(0, settings->value("align_ms", 250).toInt());
+    settings->endGroup();
+
+    d_timer.stop();
+    d_socket.close();
+    d_nodes.clear();
+    if (port <= 0 || port > 65535)
+        return;
+
+    if (!d_socket.bind(QHostAddress::Any, (quint16)port))
+    {
+        qWarning() << "Spectrum collector can not listen on port" << port << ":"
+                   << d_socket.errorString();
+        return;
+    }
+    d_timer.start(1000 / fps);
+}
+
+void SpectrumCollector::readPending()
+{
+    while (d_socket.hasPendingDatagrams())
+    {
+        QByteArray data;
+        SpectrumFrame frame;
+
+        data.resize((int)d_socket.pendingDatagramSize());
+        d_socket.readDatagram(data.data(), data.size());
+        if (!frame.decode(data))
+            continue;
+
+        if (frame.type == SpectrumFrame::TYPE_EVENT)
+        {
+            emit newEvent(frame.node, frame.freq, frame.level, frame.active);
+            continue;
+        }
+
+        // the node names are not trusted, don't let them grow the map
+        auto node = d_nodes.find(frame.node);
+        if (node == d_nodes.end())
+        {
+            if (d_nodes.size() >= MAX_NODES)
+                continue;
+            node = d_nodes.insert(frame.node, Node());
+        }
+        node->rx_ms = QDateTime::currentMSecsSinceEpoch();
+
+        // keep the frames in time order, a late datagram is put in place
+        QList<SpectrumFrame> &frames = node->frames;
+        int pos = frames.size();
+        while (pos > 0 && frames[pos - 1].time_ms > frame.time_ms)
+            pos--;
+        frames.insert(pos, frame);
+        while (frames.size() > NODE_MAX_FRAMES)
+            frames.removeFirst();
+    }
+}
+
+/** Merge the aligned frame of each node into one spectrum. */
+void SpectrumCollector::merge()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 t = now - d_align_ms;
+    QList<const SpectrumFrame *> use;
+    double lo = std::numeric_limits<double>::max();
+    double hi = std::numeric_limits<double>::lowest();
+
+    for (auto it = d_nodes.begin(); it != d_nodes.end(); )
+    {
+        QList<SpectrumFrame> &frames = it.value().frames;
+
+        // liveness by the local clock, the sender's clock may be off
+        if (frames.isEmpty() || now - it.value().rx_ms > NODE_TIMEOUT_MS)
+        {
+            it = d_nodes.erase(it);
+            continue;
+        }
+
+        // latest frame taken at or before t, the oldest one if all are newer
+        while (frames.size() > 1 && frames[1].time_ms <= t)
+            frames.removeFirst();
+
+        const SpectrumFrame &f = frames.first();
+        use.append(&f);
+        lo = std::min(lo, f.freq - f.span / 2.0);
+        hi = std::max(hi, f.freq + f.span / 2.0);
+        ++it;
+    }
+
+    if (use.isEmpty() || hi <= lo)
+        return;
+
+    const double out_hz = (hi - lo) / d_bins;
+    d_merged.fill(-200.0f, d_bins);
+
+    for (const SpectrumFrame *f : use)
+    {
+        const int n = f->levels.size();
+        const double bin_hz = f->span / n;
+        const double start = f->freq - f->span / 2.0 - lo;
+
+        for (int i = 0; i < n; i++)
+        {
+            int j0 = qBound(0, (int)((start + i * bin_hz) / out_hz), d_bins - 1);
+            int j1 = qBound(j0, (int)std::ceil((start + (i + 1) * bin_hz) / out_hz) - 1, d_bins - 1);
+
+            for (int j = j0; j <= j1; j++)
+                d_merged[j] = std::max(d_merged[j], f->levels[i]);
+        }
+    }
+
+    // back to linear power with the scaling of rx_fft, see CPlotter::setNewFftData()
+    const float scale = (float)d_bins * (float)d_bins;
+    for (float &v : d_merged)
+        v = scale * powf(10.0f, v / 10.0f);
+
+    emit newSpectrum((qint64)((lo + hi) / 2.0), hi - lo, d_merged);
+}
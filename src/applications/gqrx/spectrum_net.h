@@ -0,0 +1,157 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef SPECTRUM_NET_H
+#define SPECTRUM_NET_H
+
+#include <QHostAddress>
+#include <QHostInfo>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QSettings>
+#include <QString>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QVector>
+
+/*! \brief Spectrum frame or detector event exchanged between gqrx nodes.
+ *
+ * Frames are sent as single UDP datagrams:
+ *
+ *   header:   magic "GQSP", version, type, node name, time [ms UTC], sequence
+ *   spectrum: center [Hz], span [Hz], floor [dBFS], step [dB], bins, levels
+ *   event:    frequency [Hz], level [dBFS], active
+ *
+ * Spectrum levels are one byte per bin above the floor of the frame, in
+ * steps of 0.5 dB.
+ */
+struct SpectrumFrame
+{
+    enum Type {
+        TYPE_SPECTRUM = 1,
+        TYPE_EVENT    = 2
+    };
+
+    int             type{TYPE_SPECTRUM};
+    QString         node;
+    qint64          time_ms{0};     /*!< Sender wall clock, ms since epoch. */
+    quint32         seq{0};
+    qint64          freq{0};        /*!< Center or event frequency [Hz]. */
+    double          span{0.0};      /*!< Spectrum width [Hz]. */
+    QVector<float>  levels;         /*!< Spectrum [dBFS], lowest frequency first. */
+    float           level{0.0f};    /*!< Event level [dBFS]. */
+    bool            active{false};  /*!< Event: signal appeared or disappeared. */
+
+    QByteArray  encode() const;
+    bool        decode(const QByteArray &data);
+};
+
+/*! \brief Publish a reduced spectrum and detector events of this node.
+ *
+ * The spectrum is reduced to at most max_bins by keeping the peak of each
+ * group of FFT bins, and sent at most publish_fps times per second. Peaks
+ * more than threshold_db above the median of the frame are reported as
+ * events when they appear and disappear.
+ *
+ * Settings in [spectrum_net]: publish_to=host:port, node_name, max_bins,
+ * publish_fps, threshold_db.
+ */
+class SpectrumPublisher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SpectrumPublisher(QObject *parent = 0);
+
+    void readSettings(QSettings *settings);
+    bool isEnabled() const { return d_port != 0; }
+
+    void publish(qint64 center_hz, double span_hz, const float *fft, int size);
+
+private slots:
+    void hostFound(const QHostInfo &info);
+
+private:
+    void detectEvents(const SpectrumFrame &frame);
+    void send(SpectrumFrame &frame);
+
+    QUdpSocket      d_socket;
+    QHostAddress    d_host;
+    quint16         d_port;         /*!< 0 until the destination is resolved. */
+    quint16         d_lookup_port;  /*!< Port of the pending host lookup. */
+    int             d_lookup_id;    /*!< Pending host lookup, -1 if none. */
+    QString         d_node;
+    int             d_max_bins;
+    int             d_interval_ms;
+    float           d_threshold;
+    qint64          d_last_ms;
+    quint32         d_seq;
+    QList<qint64>   d_signals;   /*!< Frequencies of the detected signals. */
+};
+
+/*! \brief Merge the spectra of several nodes onto one frequency axis.
+ *
+ * The frames of each node are buffered and a merged spectrum is produced
+ * collect_fps times per second. For time alignment each node contributes
+ * the latest frame that is at least align_ms old by the sender's clock.
+ * Nodes not heard from for two seconds by the local clock are dropped, and
+ * frames of new nodes are ignored while 64 nodes are tracked.
+ *
+ * Settings in [spectrum_net]: collect_port, collect_fps, collect_bins,
+ * align_ms.
+ */
+class SpectrumCollector : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SpectrumCollector(QObject *parent = 0);
+
+    void readSettings(QSettings *settings);
+    bool isEnabled() const { return d_socket.state() == QAbstractSocket::BoundState; }
+
+signals:
+    /*! \brief New merged spectrum, linear power scaled like rx_fft. */
+    void newSpectrum(qint64 center_hz, double span_hz, const QVector<float> &fft);
+    void newEvent(const QString &node, qint64 freq_hz, float level_db, bool active);
+
+private slots:
+    void readPending();
+    void merge();
+
+private:
+    struct Node
+    {
+        QList<SpectrumFrame> frames;    /*!< Recent frames, oldest first. */
+        qint64  rx_ms{0};               /*!< Local time of the last frame. */
+    };
+
+    QUdpSocket      d_socket;
+    QTimer          d_timer;
+    int             d_bins;
+    int             d_align_ms;
+    QMap<QString, Node> d_nodes;
+    QVector<float>  d_merged;
+};
+
+#endif // SPECTRUM_NET_H
@@ -0,0 +1,294 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Offscreen benchmark of the spectrum plotter.
+ *
+ * Feeds synthetic FFT frames to a CPlotter that is shown on the offscreen
+ * Qt platform and times the three stages of a frame: processing new data
+ * (setNewFftData), rendering the 2D plot and redrawing the overlay. This
+ * is repeated for a matrix of widths, plot modes and overlay densities.
+ *
+ * Build with -DBUILD_PLOTTER_BENCH=ON. Use --scale to run at a device
+ * pixel ratio other than 1.
+ */
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include "qtgui/bandplan.h"
+#include "qtgui/bookmarks.h"
+#include "qtgui/dxc_spots.h"
+#include "qtgui/plotter.h"
+
+#define BENCH_CENTER_FREQ   145000000LL
+#define BENCH_SAMPLE_RATE   2400000.0f
+#define BENCH_HEIGHT        800
+#define BENCH_NUM_FRAMES    16      /* distinct synthetic frames */
+#define BENCH_WARMUP        10
+
+struct bench_mode
+{
+    const char *name;
+    int         plot_mode;
+    bool        fill;
+    bool        hold;
+    bool        peaks;
+    bool        antialias;
+};
+
+static const bench_mode modes[] = {
+    { "max",       CPlotter::PLOT_MODE_MAX,       false, false, false, true  },
+    { "max-noaa",  CPlotter::PLOT_MODE_MAX,       false, false, false, false },
+    { "avg",       CPlotter::PLOT_MODE_AVG,       false, false, false, true  },
+    { "filled",    CPlotter::PLOT_MODE_FILLED,    false, false, false, true  },
+    { "histogram", CPlotter::PLOT_MODE_HISTOGRAM, false, false, false, true  },
+    { "all",       CPlotter::PLOT_MODE_FILLED,    true,  true,  true,  true  },
+};
+
+/*! \brief Gives the benchmark access to the rendering stages of CPlotter. */
+class CPlotterBench
+{
+public:
+    static void drawPlot(CPlotter &plotter)
+    {
+        plotter.drawPlot();
+    }
+
+    static void drawOverlay(CPlotter &plotter)
+    {
+        plotter.drawOverlay();
+        plotter.m_DrawOverlay = false;
+    }
+};
+
+/*! \brief Noise floor at -90 dBFS with carriers and a drifting wideband signal. */
+static std::vector<std::vector<float>> make_frames(int fftsize)
+{
+    std::vector<std::vector<float>> frames(BENCH_NUM_FRAMES);
+    std::mt19937 rng(1);
+    std::exponential_distribution<float> noise(1.0f);
+
+    // setNewFftData() divides by fftsize^2 to get dBFS
+    const float full_scale = (float)fftsize * (float)fftsize;
+    const float floor = full_scale * 1.0e-9f;
+
+    for (int f = 0; f < BENCH_NUM_FRAMES; f++)
+    {
+        std::vector<float> &v = frames[f];
+        v.resize(fftsize);
+        for (int i = 0; i < fftsize; i++)
+            v[i] = floor * noise(rng);
+
+        for (int k = 0; k < 16; k++)
+            v[(k + 1) * fftsize / 17] += full_scale * std::pow(10.0f, -(20.0f + 3.0f * k) / 10.0f);
+
+        const int width = fftsize / 40;
+        const int start = fftsize / 8 + f * fftsize / (4 * BENCH_NUM_FRAMES);
+        for (int i = start; i < start + width; i++)
+            v[i] += full_scale * 1.0e-6f * noise(rng);
+    }
+
+    return frames;
+}
+
+/*! \brief Write a band plan and bookmarks covering the displayed span. */
+static bool make_overlays(const QString &dir, int bookmarks, int spots)
+{
+    const qint64 low = BENCH_CENTER_FREQ - (qint64)BENCH_SAMPLE_RATE / 2;
+    const qint64 step = (qint64)BENCH_SAMPLE_RATE / 16;
+
+    QFile bandplan(dir + "/bandplan.csv");
+    if (!bandplan.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+    QTextStream bands(&bandplan);
+    for (int i = 0; i < 16; i++)
+        bands << low + i * step << "," << low + (i + 1) * step - 1 << ",FM,12500,"
+              << (i % 2 ? "#3070c0" : "#30c070") << ",Band " << i << "\n";
+    bandplan.close();
+
+    QFile bookmarks_file(dir + "/bookmarks.csv");
+    if (!bookmarks_file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+    QTextStream marks(&bookmarks_file);
+    marks << "Bench; #c0c000\n\n";
+    for (int i = 0; i < bookmarks; i++)
+        marks << low + (qint64)BENCH_SAMPLE_RATE * i / std::max(bookmarks, 1)
+              << "; Bookmark " << i << "; Narrow FM; 10000; Bench\n";
+    bookmarks_file.close();
+
+    BandPlan::Get().setConfigDir(dir);
+    Bookmarks::Get().setConfigDir(dir);
+    if (!BandPlan::Get().load() || !Bookmarks::Get().load())
+        return false;
+
+    for (int i = 0; i < spots; i++)
+    {
+        DXCSpotInfo info;
+        info.frequency = low + (qint64)BENCH_SAMPLE_RATE * i / std::max(spots, 1) + 1000;
+        info.name = QString("DX%1").arg(i);
+        DXCSpots::Get().add(info);
+    }
+
+    return true;
+}
+
+static void run(CPlotter &plotter, const std::vector<std::vector<float>> &frames,
+                int width, const bench_mode &mode, bool overlays, int nframes)
+{
+    const int fftsize = (int)frames[0].size();
+
+    plotter.resize(width, BENCH_HEIGHT);
+    plotter.setPlotMode(mode.plot_mode);
+    plotter.enableFftFill(mode.fill);
+    plotter.enableMaxHold(mode.hold);
+    plotter.enableMinHold(mode.hold);
+    plotter.enablePeakDetect(mode.peaks);
+    plotter.setTraceAntialiasing(mode.antialias);
+    plotter.setBookmarksEnabled(overlays);
+    plotter.setDXCSpotsEnabled(overlays);
+    plotter.enableBandPlan(overlays);
+    QCoreApplication::processEvents();
+
+    for (int n = 0; n < BENCH_WARMUP; n++)
+    {
+        plotter.setNewFftData(frames[n % BENCH_NUM_FRAMES].data(), fftsize);
+        CPlotterBench::drawPlot(plotter);
+    }
+
+    QElapsedTimer timer;
+    qint64 data_ns = 0;
+    qint64 plot_ns = 0;
+    qint64 overlay_ns = 0;
+
+    for (int n = 0; n < nframes; n++)
+    {
+        timer.start();
+        plotter.setNewFftData(frames[n % BENCH_NUM_FRAMES].data(), fftsize);
+        data_ns += timer.nsecsElapsed();
+
+        timer.start();
+        CPlotterBench::drawPlot(plotter);
+        plot_ns += timer.nsecsElapsed();
+
+        timer.start();
+        CPlotterBench::drawOverlay(plotter);
+        overlay_ns += timer.nsecsElapsed();
+    }
+
+    std::printf("%6d  %-10s %-8s %12.1f %12.1f %12.1f\n", width, mode.name,
+                overlays ? "yes" : "no",
+                1.0e-3 * data_ns / nframes,
+                1.0e-3 * plot_ns / nframes,
+                1.0e-3 * overlay_ns / nframes);
+    std::fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    // Must be set before QApplication is created
+    for (int i = 1; i < argc - 1; i++)
+        if (QString(argv[i]) == "--scale")
+            qputenv("QT_SCALE_FACTOR", argv[i + 1]);
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Offscreen benchmark of the gqrx spectrum plotter");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"fft-size", "FFT size.", "size", "16384"},
+        {"frames", "Frames timed per configuration.", "count", "200"},
+        {"widths", "Comma separated plot widths.", "list", "1280,1920,3840"},
+        {"bookmarks", "Number of bookmarks in the span.", "count", "500"},
+        {"spots", "Number of DX spots in the span.", "count", "100"},
+        {"scale", "Device pixel ratio, sets QT_SCALE_FACTOR.", "factor", "1"},
+    });
+    parser.process(app);
+
+    const int fftsize = parser.value("fft-size").toInt();
+    const int nframes = parser.value("frames").toInt();
+    if (fftsize < 64 || nframes < 1)
+    {
+        std::fprintf(stderr, "Invalid FFT size or frame count\n");
+        return 1;
+    }
+
+    QTemporaryDir dir;
+    BandPlan::create();
+    Bookmarks::create();
+    DXCSpots::create();
+    if (!dir.isValid() || !make_overlays(dir.path(), parser.value("bookmarks").toInt(),
+                                         parser.value("spots").toInt()))
+    {
+        std::fprintf(stderr, "Can not create overlay data\n");
+        return 1;
+    }
+
+    const std::vector<std::vector<float>> frames = make_frames(fftsize);
+
+    // CPlotter holds large histogram arrays, keep it off the stack
+    std::unique_ptr<CPlotter> plotter(new CPlotter());
+    plotter->setSampleRate(BENCH_SAMPLE_RATE);
+    plotter->setSpanFreq((quint32)BENCH_SAMPLE_RATE);
+    plotter->setCenterFreq(BENCH_CENTER_FREQ);
+    plotter->setFftRate(25);
+    plotter->setPandapterRange(-120.0f, 0.0f);
+    plotter->setWaterfallRange(-120.0f, 0.0f);
+    plotter->setRunningState(true);
+    plotter->show();
+
+    std::printf("FFT size %d, DPR %.2f, %d frames per configuration, times in us\n",
+                fftsize, plotter->devicePixelRatioF(), nframes);
+    std::printf("%6s  %-10s %-8s %12s %12s %12s\n", "width", "mode", "overlay",
+                "data", "plot", "overlay");
+
+    for (const QString &w : parser.value("widths").split(','))
+    {
+        const int width = w.toInt();
+        if (width <= 0 || width * plotter->devicePixelRatioF() >= MAX_SCREENSIZE)
+        {
+            std::fprintf(stderr, "Skipping invalid width %s\n", qPrintable(w));
+            continue;
+        }
+
+        for (const bench_mode &mode : modes)
+        {
+            run(*plotter, frames, width, mode, false, nframes);
+            run(*plotter, frames, width, mode, true, nframes);
+        }
+    }
+
+    return 0;
+}
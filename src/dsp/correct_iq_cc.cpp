@@ -25,6 +25,7 @@
 #include <iostream>
 #include <QDebug>
 #include "dsp/correct_iq_cc.h"
+#include "interfaces/trace.h"
 
 
 dc_corr_cc_sptr make_dc_corr_cc(double sample_rate, double tau)
@@ -120,6 +121,7 @@ int iq_swap_cc::work(int noutput_items,
                      gr_vector_const_void_star& input_items,
                      gr_vector_void_star& output_items)
 {
+    TRACE_SCOPE("iq_swap_cc::work", "dsp");
     const float *in = (const float *)input_items[0];
     float *out = (float *)output_items[0];
 
@@ -0,0 +1,67 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <cstring>
+#include <gnuradio/io_signature.h>
+
+#include "dsp/decoder_sink.h"
+#include "interfaces/trace.h"
+
+decoder_sink_sptr make_decoder_sink(std::shared_ptr<decoder_pool> pool, int stream,
+                                    double rate, double sample_rate, bool complex_input)
+{
+    return gnuradio::get_initial_sptr(new decoder_sink(pool, stream, rate, sample_rate,
+                                                       complex_input));
+}
+
+decoder_sink::decoder_sink(std::shared_ptr<decoder_pool> pool, int stream, double rate,
+                           double sample_rate, bool complex_input)
+    : gr::sync_block("decoder_sink",
+          gr::io_signature::make(1, 1, complex_input ? sizeof(gr_complex) : sizeof(float)),
+          gr::io_signature::make(0, 0, 0)),
+      d_pool(pool),
+      d_stream(stream),
+      d_rate(rate),
+      d_sample_rate(sample_rate),
+      d_complex(complex_input)
+{
+}
+
+int decoder_sink::work(int noutput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items)
+{
+    (void) output_items;
+    TRACE_SCOPE("decoder_sink::work", "dsp");
+
+    // One copy out of the flow graph buffer, shared by all plugins
+    size_t values = d_complex ? 2 * noutput_items : noutput_items;
+    decoder_pool::buffer_sptr buf = d_pool->get_buffer(values);
+
+    memcpy(buf->data.data(), input_items[0], values * sizeof(float));
+    buf->count = noutput_items;
+    buf->offset = nitems_read(0);
+    buf->sample_rate = d_sample_rate;
+    d_pool->deliver(d_stream, d_rate, buf);
+
+    return noutput_items;
+}
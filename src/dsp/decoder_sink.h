@@ -0,0 +1,75 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <gnuradio/sync_block.h>
+
+#include "interfaces/decoder_pool.h"
+
+class decoder_sink;
+
+#if GNURADIO_VERSION < 0x030900
+typedef boost::shared_ptr<decoder_sink> decoder_sink_sptr;
+#else
+typedef std::shared_ptr<decoder_sink> decoder_sink_sptr;
+#endif
+
+/*! \brief Return a shared_ptr to a new instance of decoder_sink.
+ *  \param pool The pool running the plugins.
+ *  \param stream A decoder_stream.
+ *  \param rate The rate requested by the plugins, 0 for native.
+ *  \param sample_rate The actual sample rate of the input.
+ *  \param complex_input Whether the input is gr_complex or float.
+ */
+decoder_sink_sptr make_decoder_sink(std::shared_ptr<decoder_pool> pool, int stream,
+                                    double rate, double sample_rate, bool complex_input);
+
+/*! \brief Hand samples to the decoder plugins of one stream and rate.
+ *  \ingroup DSP
+ */
+class decoder_sink : public gr::sync_block
+{
+    friend decoder_sink_sptr make_decoder_sink(std::shared_ptr<decoder_pool> pool,
+                                               int stream, double rate,
+                                               double sample_rate, bool complex_input);
+
+protected:
+    decoder_sink(std::shared_ptr<decoder_pool> pool, int stream, double rate,
+                 double sample_rate, bool complex_input);
+
+public:
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+
+    void set_sample_rate(double sample_rate) { d_sample_rate = sample_rate; }
+
+private:
+    std::shared_ptr<decoder_pool>   d_pool;
+    int                             d_stream;
+    double                          d_rate;
+    std::atomic<double>             d_sample_rate;
+    bool                            d_complex;
+};
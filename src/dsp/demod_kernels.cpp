@@ -0,0 +1,271 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <cmath>
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include "dsp/demod_kernels.h"
+#include "dsp/fm_deemph.h"
+#include "interfaces/trace.h"
+
+#define DCR_POLE        0.999f
+
+/* Loop bandwidth per block; keeps the block PLL well inside its stable range */
+#define PLL_BLOCK_BW    0.05f
+#define PLL_MAX_BLOCK   64
+
+
+void dcr_state::process(float *buf, int nitems)
+{
+    float x, y;
+
+    for (int i = 0; i < nitems; i++)
+    {
+        x = buf[i];
+        y = x - x1 + DCR_POLE * y1;
+        x1 = x;
+        y1 = y;
+        buf[i] = y;
+    }
+}
+
+
+fm_discriminator_cf_sptr make_fm_discriminator_cf(float gain, float quad_rate, double tau)
+{
+    return gnuradio::get_initial_sptr(new fm_discriminator_cf(gain, quad_rate, tau));
+}
+
+fm_discriminator_cf::fm_discriminator_cf(float gain, float quad_rate, double tau)
+    : gr::sync_block ("fm_discriminator_cf",
+          gr::io_signature::make(1, 1, sizeof(gr_complex)),
+          gr::io_signature::make(1, 1, sizeof(float))),
+      d_gain(gain),
+      d_quad_rate(quad_rate),
+      d_x1(0.0f),
+      d_y1(0.0f),
+      d_last(1.0f, 0.0f)
+{
+    set_tau(tau);
+}
+
+fm_discriminator_cf::~fm_discriminator_cf()
+{
+}
+
+void fm_discriminator_cf::set_gain(float gain)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_gain = gain;
+}
+
+void fm_discriminator_cf::set_tau(double tau)
+{
+    double b0, b1, p1;
+
+    fm_deemph_coeffs((double)d_quad_rate, tau, b0, b1, p1);
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_b0 = (float)b0;
+    d_b1 = (float)b1;
+    d_p1 = (float)p1;
+}
+
+int fm_discriminator_cf::work(int noutput_items,
+                              gr_vector_const_void_star &input_items,
+                              gr_vector_void_star &output_items)
+{
+    TRACE_SCOPE("fm_discriminator_cf::work", "dsp");
+    const gr_complex *in = (const gr_complex *)input_items[0];
+    float *out = (float *)output_items[0];
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    if ((int)d_prod.size() < noutput_items)
+        d_prod.resize(noutput_items);
+
+    /* in[n] * conj(in[n-1]), carrying the last sample across calls */
+    d_prod[0] = in[0] * std::conj(d_last);
+    if (noutput_items > 1)
+        volk_32fc_x2_multiply_conjugate_32fc(&d_prod[1], &in[1], &in[0], noutput_items - 1);
+    d_last = in[noutput_items - 1];
+
+    /* atan2 divides by the normalize factor */
+    volk_32fc_s32f_atan2_32f(out, d_prod.data(), 1.0f / d_gain, noutput_items);
+
+    if (d_p1 != 0.0f)
+    {
+        float x, y;
+
+        for (int i = 0; i < noutput_items; i++)
+        {
+            x = out[i];
+            y = d_b0 * x + d_b1 * d_x1 + d_p1 * d_y1;
+            d_x1 = x;
+            d_y1 = y;
+            out[i] = y;
+        }
+    }
+
+    return noutput_items;
+}
+
+
+am_envelope_cf_sptr make_am_envelope_cf(bool dcr)
+{
+    return gnuradio::get_initial_sptr(new am_envelope_cf(dcr));
+}
+
+am_envelope_cf::am_envelope_cf(bool dcr)
+    : gr::sync_block ("am_envelope_cf",
+          gr::io_signature::make(1, 1, sizeof(gr_complex)),
+          gr::io_signature::make(1, 1, sizeof(float))),
+      d_dcr_enabled(dcr)
+{
+    d_dcr.reset();
+}
+
+am_envelope_cf::~am_envelope_cf()
+{
+}
+
+void am_envelope_cf::set_dcr(bool dcr)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    if (dcr && !d_dcr_enabled)
+        d_dcr.reset();
+    d_dcr_enabled = dcr;
+}
+
+int am_envelope_cf::work(int noutput_items,
+                         gr_vector_const_void_star &input_items,
+                         gr_vector_void_star &output_items)
+{
+    TRACE_SCOPE("am_envelope_cf::work", "dsp");
+    const gr_complex *in = (const gr_complex *)input_items[0];
+    float *out = (float *)output_items[0];
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    volk_32fc_magnitude_32f(out, in, noutput_items);
+    if (d_dcr_enabled)
+        d_dcr.process(out, noutput_items);
+
+    return noutput_items;
+}
+
+
+am_sync_cf_sptr make_am_sync_cf(float quad_rate, bool dcr, float pll_bw, float max_freq)
+{
+    return gnuradio::get_initial_sptr(new am_sync_cf(quad_rate, dcr, pll_bw, max_freq));
+}
+
+am_sync_cf::am_sync_cf(float quad_rate, bool dcr, float pll_bw, float max_freq)
+    : gr::sync_block ("am_sync_cf",
+          gr::io_signature::make(1, 1, sizeof(gr_complex)),
+          gr::io_signature::make(1, 1, sizeof(float))),
+      d_dcr_enabled(dcr),
+      d_pll_bw(pll_bw),
+      d_max_freq(2.0f * (float)M_PI * max_freq / quad_rate),
+      d_phase(0.0),
+      d_freq(0.0f)
+{
+    d_dcr.reset();
+    update_gains();
+}
+
+am_sync_cf::~am_sync_cf()
+{
+}
+
+void am_sync_cf::set_dcr(bool dcr)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    if (dcr && !d_dcr_enabled)
+        d_dcr.reset();
+    d_dcr_enabled = dcr;
+}
+
+void am_sync_cf::set_pll_bw(float pll_bw)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_pll_bw = pll_bw;
+    update_gains();
+}
+
+/*! \brief Second order loop gains, same as gr::blocks::control_loop but for
+ *         the block rate.
+ */
+void am_sync_cf::update_gains()
+{
+    d_blocklen = std::max(1, std::min(PLL_MAX_BLOCK, (int)(PLL_BLOCK_BW / d_pll_bw)));
+
+    float bw = d_pll_bw * d_blocklen;
+    float damping = sqrtf(2.0f) / 2.0f;
+    float denom = 1.0f + 2.0f * damping * bw + bw * bw;
+
+    d_alpha = (4.0f * damping * bw) / denom;
+    d_beta = (4.0f * bw * bw) / denom;
+}
+
+int am_sync_cf::work(int noutput_items,
+                     gr_vector_const_void_star &input_items,
+                     gr_vector_void_star &output_items)
+{
+    TRACE_SCOPE("am_sync_cf::work", "dsp");
+    const gr_complex *in = (const gr_complex *)input_items[0];
+    float *out = (float *)output_items[0];
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    if ((int)d_buf.size() < noutput_items)
+        d_buf.resize(noutput_items);
+
+    for (int i = 0; i < noutput_items; i += d_blocklen)
+    {
+        int len = std::min(d_blocklen, noutput_items - i);
+        gr_complex phase = std::polar(1.0f, (float)-d_phase);
+        gr_complex phase_inc = std::polar(1.0f, -d_freq);
+        gr_complex acc(0.0f, 0.0f);
+
+        volk_32fc_s32fc_x2_rotator_32fc(&d_buf[i], &in[i], phase_inc, &phase, len);
+
+        for (int k = i; k < i + len; k++)
+        {
+            acc += d_buf[k];
+            out[k] = d_buf[k].real();
+        }
+
+        /* residual carrier phase of this block */
+        float error = (acc != gr_complex(0.0f, 0.0f)) ? std::arg(acc) : 0.0f;
+
+        d_phase += (double)d_freq * len + (double)(d_alpha * error);
+        d_freq += d_beta * error / d_blocklen;
+        d_freq = std::max(-d_max_freq, std::min(d_max_freq, d_freq));
+        d_phase = std::remainder(d_phase, 2.0 * M_PI);
+    }
+
+    if (d_dcr_enabled)
+        d_dcr.process(out, noutput_items);
+
+    return noutput_items;
+}
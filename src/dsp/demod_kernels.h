@@ -0,0 +1,185 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/sync_block.h>
+
+class fm_discriminator_cf;
+class am_envelope_cf;
+class am_sync_cf;
+
+#if GNURADIO_VERSION < 0x030900
+typedef boost::shared_ptr<fm_discriminator_cf> fm_discriminator_cf_sptr;
+typedef boost::shared_ptr<am_envelope_cf> am_envelope_cf_sptr;
+typedef boost::shared_ptr<am_sync_cf> am_sync_cf_sptr;
+#else
+typedef std::shared_ptr<fm_discriminator_cf> fm_discriminator_cf_sptr;
+typedef std::shared_ptr<am_envelope_cf> am_envelope_cf_sptr;
+typedef std::shared_ptr<am_sync_cf> am_sync_cf_sptr;
+#endif
+
+/*! \brief Single pole DC removal filter, y[n] = x[n] - x[n-1] + 0.999 y[n-1]. */
+struct dcr_state
+{
+    float x1;
+    float y1;
+
+    void reset() { x1 = 0.0f; y1 = 0.0f; }
+    void process(float *buf, int nitems);
+};
+
+
+/*! \brief Return a shared_ptr to a new instance of fm_discriminator_cf.
+ *  \param gain Discriminator gain, quad_rate / (2 * PI * max_dev).
+ *  \param quad_rate The input sample rate.
+ *  \param tau De-emphasis time constant in seconds (0.0 disables).
+ */
+fm_discriminator_cf_sptr make_fm_discriminator_cf(float gain, float quad_rate, double tau);
+
+/*! \brief FM discriminator with built-in de-emphasis.
+ *  \ingroup DSP
+ *
+ * Equivalent to quadrature_demod_cf followed by fm_deemph, but done in a
+ * single pass in single precision. The conjugate products and the atan2 use
+ * VOLK kernels; only the one-pole de-emphasis runs as a scalar loop.
+ */
+class fm_discriminator_cf : public gr::sync_block
+{
+    friend fm_discriminator_cf_sptr make_fm_discriminator_cf(float gain, float quad_rate, double tau);
+
+protected:
+    fm_discriminator_cf(float gain, float quad_rate, double tau);
+
+public:
+    ~fm_discriminator_cf();
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+
+    void set_gain(float gain);
+    void set_tau(double tau);
+
+private:
+    std::mutex  d_mutex;
+    float       d_gain;         /*!< Discriminator gain. */
+    float       d_quad_rate;    /*!< Input sample rate. */
+    float       d_b0;           /*!< De-emphasis coefficients, see fm_deemph_coeffs(). */
+    float       d_b1;
+    float       d_p1;
+    float       d_x1;           /*!< De-emphasis state. */
+    float       d_y1;
+    gr_complex  d_last;         /*!< Last input sample of the previous call. */
+    std::vector<gr_complex> d_prod;
+};
+
+
+/*! \brief Return a shared_ptr to a new instance of am_envelope_cf.
+ *  \param dcr Enable DC removal.
+ */
+am_envelope_cf_sptr make_am_envelope_cf(bool dcr);
+
+/*! \brief AM envelope detector with built-in DC removal.
+ *  \ingroup DSP
+ *
+ * Equivalent to complex_to_mag followed by the IIR DC removal filter
+ * previously used in rx_demod_am, in single precision.
+ */
+class am_envelope_cf : public gr::sync_block
+{
+    friend am_envelope_cf_sptr make_am_envelope_cf(bool dcr);
+
+protected:
+    am_envelope_cf(bool dcr);
+
+public:
+    ~am_envelope_cf();
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+
+    void set_dcr(bool dcr);
+
+private:
+    std::mutex  d_mutex;
+    bool        d_dcr_enabled;
+    dcr_state   d_dcr;
+};
+
+
+/*! \brief Return a shared_ptr to a new instance of am_sync_cf.
+ *  \param quad_rate The input sample rate.
+ *  \param dcr Enable DC removal.
+ *  \param pll_bw PLL loop bandwidth in rad/sample.
+ *  \param max_freq Largest carrier offset the PLL will track, in Hz.
+ */
+am_sync_cf_sptr make_am_sync_cf(float quad_rate, bool dcr, float pll_bw, float max_freq);
+
+/*! \brief Synchronous AM detector with a block processed PLL.
+ *  \ingroup DSP
+ *
+ * Replaces pll_carriertracking_cc + complex_to_real + DC removal. Rather than
+ * running the loop for every sample, the NCO frequency is held constant for a
+ * short block, the block is derotated with the VOLK rotator and the phase
+ * error is taken from the coherent sum of the derotated samples. The loop
+ * is then updated once per block with gains scaled to the block rate, which
+ * gives the same loop response as long as the block is short compared to
+ * 1 / pll_bw.
+ */
+class am_sync_cf : public gr::sync_block
+{
+    friend am_sync_cf_sptr make_am_sync_cf(float quad_rate, bool dcr, float pll_bw, float max_freq);
+
+protected:
+    am_sync_cf(float quad_rate, bool dcr, float pll_bw, float max_freq);
+
+public:
+    ~am_sync_cf();
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+
+    void set_dcr(bool dcr);
+    void set_pll_bw(float pll_bw);
+
+private:
+    void update_gains();
+
+    std::mutex  d_mutex;
+    bool        d_dcr_enabled;
+    dcr_state   d_dcr;
+
+    float       d_pll_bw;       /*!< Loop bandwidth per sample. */
+    int         d_blocklen;     /*!< Samples per loop update. */
+    float       d_alpha;        /*!< Loop gains for the block rate. */
+    float       d_beta;
+    float       d_max_freq;     /*!< Frequency limit in rad/sample. */
+    double      d_phase;        /*!< NCO phase in rad. */
+    float       d_freq;         /*!< NCO frequency in rad/sample. */
+    std::vector<gr_complex> d_buf;
+};
@@ -20,14 +20,13 @@
  * the Free Software Foundation, Inc., 51 Franklin Street,
  * Boston, MA 02110-1301, USA.
  */
+#include <algorithm>
 #include <math.h>
 #include <gnuradio/filter/firdes.h>
 #include <gnuradio/io_signature.h>
 
 #include "downconverter.h"
 
-#define LPF_CUTOFF 120e3
-
 downconverter_cc_sptr make_downconverter_cc(unsigned int decim, double center_freq, double samp_rate)
 {
     return gnuradio::get_initial_sptr(new downconverter_cc(decim, center_freq, samp_rate));
@@ -41,6 +40,7 @@ downconverter_cc::downconverter_cc(unsigned int decim, double center_freq, doubl
       d_center_freq(center_freq),
       d_samp_rate(samp_rate)
 {
+    ramp = make_freq_ramp_cc(d_samp_rate / d_decim, ramp_limit());
     connect_all();
     update_proto_taps();
     update_phase_inc();
@@ -62,6 +62,7 @@ void downconverter_cc::set_decim_and_samp_rate(unsigned int decim, double samp_r
         connect_all();
         unlock();
     }
+    ramp->set_sample_rate(d_samp_rate / d_decim, ramp_limit());
     update_proto_taps();
     update_phase_inc();
 }
@@ -70,6 +71,28 @@ void downconverter_cc::set_center_freq(double center_freq)
 {
     d_center_freq = center_freq;
     update_phase_inc();
+    ramp->tag_offset(center_freq);
+}
+
+/**
+ * Follow a frequency ramp around the center frequency, see freq_ramp_cc.
+ * The ramp runs at the output rate, so it is limited to the passband of
+ * the downconverter.
+ */
+void downconverter_cc::set_freq_ramp(double freq, double rate, int64_t start_ns)
+{
+    ramp->set_ramp(freq, rate, start_ns);
+}
+
+void downconverter_cc::clear_freq_ramp()
+{
+    ramp->clear();
+}
+
+/** Get the current ramp offset from the center frequency and its rate of change. */
+void downconverter_cc::get_freq_ramp(double &freq, double &rate)
+{
+    ramp->get_ramp(freq, rate);
 }
 
 void downconverter_cc::connect_all()
@@ -78,14 +101,15 @@ void downconverter_cc::connect_all()
     {
         filt = gr::filter::freq_xlating_fir_filter_ccf::make(d_decim, {1}, 0.0, d_samp_rate);
         connect(self(), 0, filt, 0);
-        connect(filt, 0, self(), 0);
+        connect(filt, 0, ramp, 0);
     }
     else
     {
         rot = gr::blocks::rotator_cc::make(0.0);
         connect(self(), 0, rot, 0);
-        connect(rot, 0, self(), 0);
+        connect(rot, 0, ramp, 0);
     }
+    connect(ramp, 0, self(), 0);
 }
 
 void downconverter_cc::update_proto_taps()
@@ -93,7 +117,7 @@ void downconverter_cc::update_proto_taps()
     if (d_decim > 1)
     {
         double out_rate = d_samp_rate / d_decim;
-        filt->set_taps(gr::filter::firdes::low_pass(1.0, d_samp_rate, LPF_CUTOFF, out_rate - 2*LPF_CUTOFF,
+        filt->set_taps(gr::filter::firdes::low_pass(1.0, d_samp_rate, DDC_LPF_CUTOFF, out_rate - 2*DDC_LPF_CUTOFF,
 #if GNURADIO_VERSION < 0x030900
             gr::filter::firdes::WIN_BLACKMAN_HARRIS
 #else
@@ -103,6 +127,11 @@ void downconverter_cc::update_proto_taps()
     }
 }
 
+double downconverter_cc::ramp_limit() const
+{
+    return std::min(DDC_RAMP_LIMIT, 0.5 * d_samp_rate / d_decim);
+}
+
 void downconverter_cc::update_phase_inc()
 {
     if (d_decim > 1)
@@ -25,6 +25,15 @@
 #include <gnuradio/blocks/rotator_cc.h>
 #include <gnuradio/filter/freq_xlating_fir_filter.h>
 #include <gnuradio/hier_block2.h>
+#include "dsp/freq_ramp.h"
+
+/* Cutoff of the downconverter low pass filter. The quadrature rate must be
+ * well above twice this value, see rate_plan_ddc_decim(). */
+#define DDC_LPF_CUTOFF 120e3
+
+/* Largest offset of a frequency ramp from the center frequency, leaves room
+ * for the channel filter inside the downconverter passband. */
+#define DDC_RAMP_LIMIT 60e3
 
 class downconverter_cc;
 
@@ -44,6 +53,9 @@ public:
     ~downconverter_cc();
     void set_decim_and_samp_rate(unsigned int decim, double samp_rate);
     void set_center_freq(double center_freq);
+    void set_freq_ramp(double freq, double rate, int64_t start_ns);
+    void clear_freq_ramp();
+    void get_freq_ramp(double &freq, double &rate);
 
 private:
     unsigned int d_decim;
@@ -54,7 +66,9 @@ private:
     void connect_all();
     void update_proto_taps();
     void update_phase_inc();
+    double ramp_limit() const;
 
     gr::filter::freq_xlating_fir_filter_ccf::sptr filt;
     gr::blocks::rotator_cc::sptr rot;
+    freq_ramp_cc_sptr ramp;
 };
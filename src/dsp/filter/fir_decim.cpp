@@ -22,6 +22,8 @@
  * Boston, MA 02110-1301, USA.
  */
 #include <cstdio>
+#include <iostream>
+#include <stdexcept>
 #include <vector>
 
 #include <gnuradio/hier_block2.h>
@@ -91,18 +93,10 @@ static const decimation_stage decimation_stages[] =
     }
 };
 
-fir_decim_cc_sptr make_fir_decim_cc(unsigned int decim)
+/*! \brief Pick the stages for a total decimation, largest first. */
+static std::vector<const decimation_stage *> plan_stages(unsigned int decim)
 {
-    return gnuradio::get_initial_sptr(new fir_decim_cc(decim));
-}
-
-fir_decim_cc::fir_decim_cc(unsigned int decim)
-    : gr::hier_block2("fir_decim_cc",
-          gr::io_signature::make(1, 1, sizeof(gr_complex)),
-          gr::io_signature::make(1, 1, sizeof(gr_complex)))
-{
-    std::vector<float>  taps;
-    int this_stage = 0;
+    std::vector<const decimation_stage *> stages;
     int index = decimation_stage_count - 1;
 
     std::cout << "Decimation: " << decim << std::endl;
@@ -112,19 +106,8 @@ fir_decim_cc::fir_decim_cc(unsigned int decim)
 
         if (decim % stage->decimation == 0)
         {
-            this_stage++;
-            taps.assign(stage->kernel, stage->kernel + stage->length);
-            if (this_stage == 1)
-                fir1 = gr::filter::fir_filter_ccf::make(stage->ratio, taps);
-            else if (this_stage == 2)
-                fir2 = gr::filter::fir_filter_ccf::make(stage->ratio, taps);
-            else if (this_stage == 3)  // NB: currently max 2 stages
-                fir3 = gr::filter::fir_filter_ccf::make(stage->ratio, taps);
-            else
-                std::cout << "  Too many decimation stages: " << this_stage
-                          << std::endl;
-
-            std::cout << "  stage: " << this_stage << "  ratio: " << stage->ratio
+            stages.push_back(stage);
+            std::cout << "  stage: " << stages.size() << "  ratio: " << stage->ratio
                       << std::endl;
             decim /= stage->ratio;
         }
@@ -134,12 +117,45 @@ fir_decim_cc::fir_decim_cc(unsigned int decim)
         }
     }
 
-    if (this_stage == 1)
+    return stages;
+}
+
+fir_decim_cc_sptr make_fir_decim_cc(unsigned int decim)
+{
+    return gnuradio::get_initial_sptr(new fir_decim_cc(decim));
+}
+
+fir_decim_cc::fir_decim_cc(unsigned int decim)
+    : gr::hier_block2("fir_decim_cc",
+          gr::io_signature::make(1, 1, sizeof(gr_complex)),
+          gr::io_signature::make(1, 1, sizeof(gr_complex)))
+{
+    std::vector<float>  taps;
+    std::vector<const decimation_stage *> stages = plan_stages(decim);
+
+    if (stages.empty())
+        throw std::range_error("unsupported decimation");
+
+    for (size_t i = 0; i < stages.size(); i++)
+    {
+        taps.assign(stages[i]->kernel, stages[i]->kernel + stages[i]->length);
+        if (i == 0)
+            fir1 = gr::filter::fir_filter_ccf::make(stages[i]->ratio, taps);
+        else if (i == 1)
+            fir2 = gr::filter::fir_filter_ccf::make(stages[i]->ratio, taps);
+        else if (i == 2)  // NB: currently max 2 stages
+            fir3 = gr::filter::fir_filter_ccf::make(stages[i]->ratio, taps);
+        else
+            std::cout << "  Too many decimation stages: " << i + 1
+                      << std::endl;
+    }
+
+    if (stages.size() == 1)
     {
         connect(self(), 0, fir1, 0);
         connect(fir1, 0, self(), 0);
     }
-    else if (this_stage == 2)
+    else if (stages.size() == 2)
     {
         connect(self(), 0, fir1, 0);
         connect(fir1, 0, fir2, 0);
@@ -158,3 +174,55 @@ fir_decim_cc::~fir_decim_cc()
 {
 
 }
+
+fir_decim_sc_sptr make_fir_decim_sc(int format, unsigned int decim)
+{
+    return gnuradio::get_initial_sptr(new fir_decim_sc(format, decim));
+}
+
+/*! \brief Create an input decimator for integer samples.
+ *  \param format One of fir_decim_int::sample_format.
+ *  \param decim The total decimation, 1 to only convert to gr_complex.
+ *
+ * The first stage, which runs at the full input rate, filters the integer
+ * samples directly. The remaining stages are the same float filters as in
+ * fir_decim_cc.
+ */
+fir_decim_sc::fir_decim_sc(int format, unsigned int decim)
+    : gr::hier_block2("fir_decim_sc",
+          gr::io_signature::make(1, 1, fir_decim_int::item_size(format)),
+          gr::io_signature::make(1, 1, sizeof(gr_complex)))
+{
+    std::vector<float>  taps;
+    std::vector<const decimation_stage *> stages = plan_stages(decim);
+
+    if (stages.empty() && decim > 1)
+        throw std::range_error("unsupported decimation");
+
+    if (stages.empty())
+    {
+        first = make_fir_decim_int(format, 1, taps);
+        connect(self(), 0, first, 0);
+        connect(first, 0, self(), 0);
+        return;
+    }
+
+    taps.assign(stages[0]->kernel, stages[0]->kernel + stages[0]->length);
+    first = make_fir_decim_int(format, stages[0]->ratio, taps);
+    connect(self(), 0, first, 0);
+
+    gr::basic_block_sptr b = first;
+    for (size_t i = 1; i < stages.size(); i++)
+    {
+        taps.assign(stages[i]->kernel, stages[i]->kernel + stages[i]->length);
+        rest.push_back(gr::filter::fir_filter_ccf::make(stages[i]->ratio, taps));
+        connect(b, 0, rest.back(), 0);
+        b = rest.back();
+    }
+    connect(b, 0, self(), 0);
+}
+
+fir_decim_sc::~fir_decim_sc()
+{
+
+}
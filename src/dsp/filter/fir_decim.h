@@ -24,6 +24,9 @@
 
 #include <gnuradio/filter/fir_filter_blk.h>
 #include <gnuradio/hier_block2.h>
+#include <vector>
+
+#include "fir_decim_int.h"
 
 class fir_decim_cc;
 
@@ -50,3 +53,29 @@ private:
     gr::filter::fir_filter_ccf::sptr        fir2;
     gr::filter::fir_filter_ccf::sptr        fir3;
 };
+
+
+class fir_decim_sc;
+
+#if GNURADIO_VERSION < 0x030900
+typedef boost::shared_ptr<fir_decim_sc> fir_decim_sc_sptr;
+#else
+typedef std::shared_ptr<fir_decim_sc> fir_decim_sc_sptr;
+#endif
+fir_decim_sc_sptr make_fir_decim_sc(int format, unsigned int decim);
+
+/*! \brief Input decimator for 8 and 16 bit I/Q, see fir_decim_int. */
+class fir_decim_sc : public gr::hier_block2
+{
+    friend fir_decim_sc_sptr make_fir_decim_sc(int format, unsigned int decim);
+
+protected:
+    fir_decim_sc(int format, unsigned int decim);
+
+public:
+    ~fir_decim_sc();
+
+private:
+    fir_decim_int_sptr                              first;
+    std::vector<gr::filter::fir_filter_ccf::sptr>   rest;
+};
@@ -0,0 +1,184 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <cmath>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+
+#include "fir_decim_int.h"
+#include "interfaces/trace.h"
+
+fir_decim_int_sptr make_fir_decim_int(int format, unsigned int ratio,
+                                      const std::vector<float> &taps)
+{
+    return gnuradio::get_initial_sptr(new fir_decim_int(format, ratio, taps));
+}
+
+/*! \brief Parse a sample format name.
+ *  \returns The format or -1 for names that are not integer formats.
+ *
+ * Accepts the short names (cs8, cu8, cs16) and the SigMF datatypes.
+ */
+int fir_decim_int::format_from_string(const std::string &name)
+{
+    if (name == "cs8" || name == "ci8")
+        return FORMAT_CS8;
+    if (name == "cu8")
+        return FORMAT_CU8;
+    if (name == "cs16" || name == "ci16" || name == "ci16_le")
+        return FORMAT_CS16;
+    return -1;
+}
+
+/*! \brief Size of one I/Q sample in bytes. */
+size_t fir_decim_int::item_size(int format)
+{
+    return (format == FORMAT_CS16) ? 2 * sizeof(int16_t) : 2 * sizeof(int8_t);
+}
+
+fir_decim_int::fir_decim_int(int format, unsigned int ratio, const std::vector<float> &taps)
+    : gr::sync_decimator("fir_decim_int",
+          gr::io_signature::make(1, 1, item_size(format)),
+          gr::io_signature::make(1, 1, sizeof(gr_complex)),
+          ratio),
+      d_format(format),
+      d_ratio(ratio)
+{
+    /* largest Q format where the int32 accumulator can not overflow */
+    double sum = 0.0;
+    double peak = 0.0;
+    for (float t : taps)
+    {
+        sum += std::fabs(t);
+        peak = std::max(peak, (double)std::fabs(t));
+    }
+    int q = 15;
+    const double acc_max = 2147483647.0 - 16384.0 * taps.size();   // rounding
+    while (q > 0 && (sum * std::ldexp(32768.0, q) >= acc_max ||
+                     std::ldexp(peak, q) >= 32767.0))
+        q--;
+
+    d_taps.resize(taps.size());
+    for (size_t k = 0; k < taps.size(); k++)
+        d_taps[taps.size() - 1 - k] = (int16_t)std::lrint(std::ldexp(taps[k], q));
+    d_scale = (float)std::ldexp(1.0 / 32768.0, -q);
+
+    if (!d_taps.empty())
+        set_history(d_taps.size());
+}
+
+fir_decim_int::~fir_decim_int()
+{
+}
+
+int fir_decim_int::work(int noutput_items,
+                        gr_vector_const_void_star &input_items,
+                        gr_vector_void_star &output_items)
+{
+    TRACE_SCOPE("fir_decim_int::work", "dsp");
+    gr_complex *out = (gr_complex *)output_items[0];
+
+    if (d_taps.empty())
+    {
+        /* conversion only, interleaved I/Q maps directly onto gr_complex */
+        if (d_format == FORMAT_CS16)
+            volk_16i_s32f_convert_32f((float *)out, (const int16_t *)input_items[0],
+                                      32768.0f, 2 * noutput_items);
+        else if (d_format == FORMAT_CS8)
+            volk_8i_s32f_convert_32f((float *)out, (const int8_t *)input_items[0],
+                                     128.0f, 2 * noutput_items);
+        else
+        {
+            const uint8_t *in = (const uint8_t *)input_items[0];
+            float *f = (float *)out;
+            for (int k = 0; k < 2 * noutput_items; k++)
+                f[k] = ((float)in[k] - 127.5f) * (1.0f / 128.0f);
+        }
+        return noutput_items;
+    }
+
+    const int ntaps = (int)d_taps.size();
+    widen(input_items[0], noutput_items * (int)d_ratio + ntaps - 1);
+
+    const int16_t *h = d_taps.data();
+    for (int n = 0; n < noutput_items; n++)
+    {
+        const int16_t *xi = d_i.data() + (size_t)n * d_ratio;
+        const int16_t *xq = d_q.data() + (size_t)n * d_ratio;
+        int32_t acc_i = 0;
+        int32_t acc_q = 0;
+
+        /* plain int16 x int16 -> int32 loops, vectorized by the compiler */
+        for (int k = 0; k < ntaps; k++)
+            acc_i += (int32_t)xi[k] * h[k];
+        for (int k = 0; k < ntaps; k++)
+            acc_q += (int32_t)xq[k] * h[k];
+
+        out[n] = gr_complex((float)acc_i * d_scale, (float)acc_q * d_scale);
+    }
+
+    return noutput_items;
+}
+
+/*! \brief Deinterleave the input into d_i and d_q, widening 8 bit formats to int16. */
+void fir_decim_int::widen(const void *in, int nitems)
+{
+    d_i.resize(nitems);
+    d_q.resize(nitems);
+
+    switch (d_format)
+    {
+    case FORMAT_CS16:
+    {
+        const int16_t *s = (const int16_t *)in;
+        for (int k = 0; k < nitems; k++)
+        {
+            d_i[k] = s[2 * k];
+            d_q[k] = s[2 * k + 1];
+        }
+        break;
+    }
+    case FORMAT_CS8:
+    {
+        const int8_t *s = (const int8_t *)in;
+        for (int k = 0; k < nitems; k++)
+        {
+            d_i[k] = (int16_t)(s[2 * k] * 256);
+            d_q[k] = (int16_t)(s[2 * k + 1] * 256);
+        }
+        break;
+    }
+    default:
+    {
+        /* 256 * (x - 127.5) */
+        const uint8_t *s = (const uint8_t *)in;
+        for (int k = 0; k < nitems; k++)
+        {
+            d_i[k] = (int16_t)(s[2 * k] * 256 - 32640);
+            d_q[k] = (int16_t)(s[2 * k + 1] * 256 - 32640);
+        }
+        break;
+    }
+    }
+}
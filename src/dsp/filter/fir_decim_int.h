@@ -0,0 +1,86 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <gnuradio/sync_decimator.h>
+
+class fir_decim_int;
+
+#if GNURADIO_VERSION < 0x030900
+typedef boost::shared_ptr<fir_decim_int> fir_decim_int_sptr;
+#else
+typedef std::shared_ptr<fir_decim_int> fir_decim_int_sptr;
+#endif
+fir_decim_int_sptr make_fir_decim_int(int format, unsigned int ratio,
+                                      const std::vector<float> &taps);
+
+/*! \brief Integer input decimation stage.
+ *  \ingroup DSP
+ *
+ * First stage of the input decimator for sources delivering 8 or 16 bit
+ * interleaved I/Q. The samples are widened to int16 once, filtered with
+ * int16 taps and int32 accumulators, and converted to gr_complex only at the
+ * decimated rate, so the full rate part of the front end moves 2 or 4 bytes
+ * per sample instead of 8.
+ *
+ * With ratio 1 and no taps the block only converts to gr_complex.
+ * The output is scaled to +/- 1.0 full scale for all formats.
+ */
+class fir_decim_int : public gr::sync_decimator
+{
+    friend fir_decim_int_sptr make_fir_decim_int(int format, unsigned int ratio,
+                                                 const std::vector<float> &taps);
+
+public:
+    enum sample_format {
+        FORMAT_CS8  = 1,    /*!< Signed 8 bit (SigMF ci8). */
+        FORMAT_CU8  = 2,    /*!< Unsigned 8 bit with offset 127.5, as RTL-SDR. */
+        FORMAT_CS16 = 3     /*!< Signed 16 bit native endian (SigMF ci16_le). */
+    };
+
+    static int format_from_string(const std::string &name);
+    static size_t item_size(int format);
+
+protected:
+    fir_decim_int(int format, unsigned int ratio, const std::vector<float> &taps);
+
+public:
+    ~fir_decim_int();
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+
+private:
+    void widen(const void *in, int nitems);
+
+    int                  d_format;
+    unsigned int         d_ratio;
+    std::vector<int16_t> d_taps;    /*!< Quantized taps, reversed. */
+    float                d_scale;   /*!< Accumulator to full scale float. */
+    std::vector<int16_t> d_i;       /*!< Widened input, I. */
+    std::vector<int16_t> d_q;       /*!< Widened input, Q. */
+};
@@ -69,14 +69,25 @@ void fm_deemph::set_tau(double tau)
 
 /*! \brief Calculate taps for FM de-emph IIR filter. */
 void fm_deemph::calculate_iir_taps(double tau)
+{
+    double  b0, b1, p1;
+
+    fm_deemph_coeffs((double)d_quad_rate, tau, b0, b1, p1);
+
+    d_fftaps[0] = b0;
+    d_fftaps[1] = b1;
+    d_fbtaps[0] = (tau > 1.0e-9) ? 1.0 : 0.0;
+    d_fbtaps[1] = -p1;
+}
+
+void fm_deemph_coeffs(double fs, double tau, double &b0, double &b1, double &p1)
 {
     if (tau > 1.0e-9)
     {
         // copied from fm_emph.py in gr-analog
         double  w_c;    // Digital corner frequency
         double  w_ca;   // Prewarped analog corner frequency
-        double  k, z1, p1, b0;
-        double  fs = (double)d_quad_rate;
+        double  k, z1;
 
         w_c = 1.0 / tau;
         w_ca = 2.0 * fs * tan(w_c / (2.0 * fs));
@@ -88,17 +99,12 @@ void fm_deemph::calculate_iir_taps(double tau)
         z1 = -1.0;
         p1 = (1.0 + k) / (1.0 - k);
         b0 = -k / (1.0 - k);
-
-        d_fftaps[0] = b0;
-        d_fftaps[1] = -z1 * b0;
-        d_fbtaps[0] = 1.0;
-        d_fbtaps[1] = -p1;
+        b1 = -z1 * b0;
     }
     else
     {
-        d_fftaps[0] = 1.0;
-        d_fftaps[1] = 0.0;
-        d_fbtaps[0] = 0.0;
-        d_fbtaps[1] = 0.0;
+        b0 = 1.0;
+        b1 = 0.0;
+        p1 = 0.0;
     }
 }
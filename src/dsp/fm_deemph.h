@@ -43,6 +43,17 @@ typedef std::shared_ptr<fm_deemph> fm_deemph_sptr;
  */
 fm_deemph_sptr make_fm_deemph(float quad_rate, double tau=50.0e-6);
 
+/*! \brief Calculate the de-emphasis filter coefficients.
+ *  \param fs The sample rate.
+ *  \param tau De-emphasis time constant in seconds (0.0 disables).
+ *  \param b0 Feed forward coefficient for x[n].
+ *  \param b1 Feed forward coefficient for x[n-1].
+ *  \param p1 Feed back coefficient for y[n-1].
+ *
+ * The filter is y[n] = b0 * x[n] + b1 * x[n-1] + p1 * y[n-1].
+ */
+void fm_deemph_coeffs(double fs, double tau, double &b0, double &b1, double &p1);
+
 /*! \brief FM demodulator.
  *  \ingroup DSP
  *
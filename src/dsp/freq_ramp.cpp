@@ -0,0 +1,204 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <gnuradio/io_signature.h>
+#include <pmt/pmt.h>
+#include <volk/volk.h>
+#include "dsp/freq_ramp.h"
+#include "interfaces/trace.h"
+
+/* Samples per NCO frequency update. The ramp runs at the downconverter
+ * output rate; at 1 kHz/s and 48 ksps the frequency changes by 1.3 Hz per
+ * block, and the NCO uses the frequency in the middle of the block. */
+#define RAMP_BLOCK_LEN      64
+
+/* Limit for queued ramps, a client sends a few points ahead */
+#define RAMP_MAX_QUEUE      64
+
+static int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+freq_ramp_cc_sptr make_freq_ramp_cc(double sample_rate, double limit)
+{
+    return gnuradio::get_initial_sptr(new freq_ramp_cc(sample_rate, limit));
+}
+
+freq_ramp_cc::freq_ramp_cc(double sample_rate, double limit)
+    : gr::sync_block("freq_ramp_cc",
+          gr::io_signature::make(1, 1, sizeof(gr_complex)),
+          gr::io_signature::make(1, 1, sizeof(gr_complex))),
+      d_sample_rate(sample_rate),
+      d_limit(limit),
+      d_freq(0.0),
+      d_rate(0.0),
+      d_phase(0.0),
+      d_tag_pending(false),
+      d_tag_offset(0.0)
+{
+}
+
+freq_ramp_cc::~freq_ramp_cc()
+{
+}
+
+int freq_ramp_cc::work(int noutput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items)
+{
+    TRACE_SCOPE("freq_ramp_cc::work", "dsp");
+    const gr_complex *in = (const gr_complex *)input_items[0];
+    gr_complex *out = (gr_complex *)output_items[0];
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    if (d_tag_pending)
+    {
+        add_item_tag(0, nitems_written(0), pmt::intern("ch_offset"),
+                     pmt::from_double(d_tag_offset));
+        d_tag_pending = false;
+    }
+
+    if (d_freq == 0.0 && d_rate == 0.0 && d_queue.empty())
+    {
+        std::memcpy(out, in, noutput_items * sizeof(gr_complex));
+        return noutput_items;
+    }
+
+    int64_t t0 = now_ns();
+
+    for (int i = 0; i < noutput_items; )
+    {
+        int len = std::min(RAMP_BLOCK_LEN, noutput_items - i);
+
+        // Start a queued ramp at its first sample
+        if (!d_queue.empty())
+        {
+            int64_t start = (int64_t)((d_queue.front().start_ns - t0) * 1.e-9 * d_sample_rate);
+            if (start <= i)
+            {
+                d_freq = d_queue.front().freq;
+                d_rate = d_queue.front().rate;
+                d_queue.pop_front();
+                continue;
+            }
+            len = (int)std::min((int64_t)len, start - i);
+        }
+
+        // Frequency in the middle of the block
+        double step = d_rate / d_sample_rate;
+        double freq = std::max(-d_limit, std::min(d_limit, d_freq + step * 0.5 * len));
+        float inc = (float)(-2.0 * M_PI * freq / d_sample_rate);
+        gr_complex phase = std::polar(1.0f, (float)d_phase);
+
+        volk_32fc_s32fc_x2_rotator_32fc(&out[i], &in[i], std::polar(1.0f, inc), &phase, len);
+
+        d_phase = std::remainder(d_phase + (double)inc * len, 2.0 * M_PI);
+        d_freq = std::max(-d_limit, std::min(d_limit, d_freq + step * len));
+        i += len;
+    }
+
+    return noutput_items;
+}
+
+void freq_ramp_cc::set_sample_rate(double sample_rate, double limit)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    d_sample_rate = sample_rate;
+    d_limit = limit;
+    d_freq = std::max(-d_limit, std::min(d_limit, d_freq));
+}
+
+/**
+ * @brief Set the frequency ramp.
+ * @param freq Offset at start_ns [Hz].
+ * @param rate Rate of change [Hz/s].
+ * @param start_ns UNIX time in ns the ramp starts at, negative for now.
+ *
+ * A ramp starting in the future is queued after the ramps starting before
+ * it; queued ramps starting later are dropped.
+ */
+void freq_ramp_cc::set_ramp(double freq, double rate, int64_t start_ns)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    int64_t now = now_ns();
+
+    freq = std::max(-d_limit, std::min(d_limit, freq));
+    if (start_ns <= now)
+    {
+        // Already started, catch up with the time since then
+        d_queue.clear();
+        d_rate = rate;
+        d_freq = freq;
+        if (start_ns >= 0)
+            d_freq = std::max(-d_limit, std::min(d_limit, freq + rate * (now - start_ns) * 1.e-9));
+        return;
+    }
+
+    while (!d_queue.empty() && d_queue.back().start_ns >= start_ns)
+        d_queue.pop_back();
+    if (d_queue.size() < RAMP_MAX_QUEUE)
+        d_queue.push_back({start_ns, freq, rate});
+}
+
+/** Stop the ramp and return to the center frequency. */
+void freq_ramp_cc::clear()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    d_queue.clear();
+    d_freq = 0.0;
+    d_rate = 0.0;
+}
+
+/**
+ * @brief Tag the next output sample with "ch_offset".
+ * @param offset The new center frequency of the downconverter [Hz].
+ *
+ * Consumers such as snapshot_sink use the tag to switch to the new
+ * frequency with the stream instead of when the GUI changed it. Samples
+ * the downconverter filter had already produced before the change are
+ * still in front of this block, so the tag can be early by those.
+ */
+void freq_ramp_cc::tag_offset(double offset)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    d_tag_pending = true;
+    d_tag_offset = offset;
+}
+
+/** Get the current offset [Hz] and rate of change [Hz/s]. */
+void freq_ramp_cc::get_ramp(double &freq, double &rate)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    freq = d_freq;
+    rate = d_rate;
+}
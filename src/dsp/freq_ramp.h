@@ -0,0 +1,96 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <gnuradio/sync_block.h>
+
+class freq_ramp_cc;
+
+#if GNURADIO_VERSION < 0x030900
+typedef boost::shared_ptr<freq_ramp_cc> freq_ramp_cc_sptr;
+#else
+typedef std::shared_ptr<freq_ramp_cc> freq_ramp_cc_sptr;
+#endif
+
+/*! \brief Return a shared_ptr to a new instance of freq_ramp_cc.
+ *  \param sample_rate The sample rate.
+ *  \param limit Largest frequency offset in Hz.
+ */
+freq_ramp_cc_sptr make_freq_ramp_cc(double sample_rate, double limit);
+
+/*! \brief NCO following a frequency ramp, e.g. the Doppler shift of a satellite.
+ *  \ingroup DSP
+ *
+ * A signal at freq + rate * t is shifted to 0 Hz. The frequency is advanced
+ * with the sample count, so the output has no phase or frequency steps as
+ * long as the ramp is not changed. A new ramp can be queued with the UNIX
+ * time it starts at; the time is compared with the wall clock when the
+ * samples are processed. The frequency is held at +/- limit.
+ *
+ * The frequency is kept constant for short blocks, which are derotated with
+ * the VOLK rotator. Without a ramp the input is copied.
+ *
+ * As the last block of the downconverter it also tags the stream with
+ * "ch_offset" when the downconverter center frequency changes, see
+ * tag_offset().
+ */
+class freq_ramp_cc : public gr::sync_block
+{
+    friend freq_ramp_cc_sptr make_freq_ramp_cc(double sample_rate, double limit);
+
+protected:
+    freq_ramp_cc(double sample_rate, double limit);
+
+public:
+    ~freq_ramp_cc();
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+
+    void set_sample_rate(double sample_rate, double limit);
+    void set_ramp(double freq, double rate, int64_t start_ns = -1);
+    void clear();
+    void get_ramp(double &freq, double &rate);
+    void tag_offset(double offset);
+
+private:
+    struct segment
+    {
+        int64_t start_ns;   /*!< UNIX time in ns. */
+        double  freq;       /*!< Offset at start_ns [Hz]. */
+        double  rate;       /*!< [Hz/s] */
+    };
+
+    std::mutex  d_mutex;
+    double      d_sample_rate;
+    double      d_limit;
+    double      d_freq;     /*!< Current offset [Hz]. */
+    double      d_rate;     /*!< Current rate of change [Hz/s]. */
+    double      d_phase;    /*!< NCO phase [rad]. */
+    std::deque<segment> d_queue;    /*!< Ramps not started yet, by time. */
+    bool        d_tag_pending;
+    double      d_tag_offset;   /*!< Value of the next "ch_offset" tag [Hz]. */
+};
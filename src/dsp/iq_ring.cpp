@@ -0,0 +1,231 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "dsp/iq_ring.h"
+#include "interfaces/large_buffer.h"
+
+#define IQ_RING_MAGIC   0x47514951
+#define IQ_RING_VERSION 1
+#define IQ_RING_OFFSET  4096
+
+static int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/*!
+ * \brief Create a ring.
+ * \param capacity Size in samples, rounded up to a power of two.
+ * \param shm_name Name of a POSIX shared memory object to create, empty for
+ *                 private memory. Falls back to private memory if the object
+ *                 can not be created, e.g. because another instance owns it.
+ */
+iq_ring::iq_ring(size_t capacity, const std::string &shm_name)
+    : d_hdr(nullptr),
+      d_data(nullptr),
+      d_shared(false),
+      d_shm_name(shm_name)
+{
+    d_capacity = 1024;
+    while (d_capacity < capacity)
+        d_capacity <<= 1;
+    d_guard = d_capacity / 8;
+    d_size = IQ_RING_OFFSET + d_capacity * sizeof(gr_complex);
+
+    void *mem = nullptr;
+#ifndef _WIN32
+    if (!d_shm_name.empty())
+    {
+        // Never take over an object that another instance is writing
+        int fd = shm_open(d_shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0 && errno == EEXIST)
+            std::cerr << "iq_ring: " << d_shm_name << " already exists, "
+                      << "remove it if no other instance is running" << std::endl;
+        if (fd >= 0)
+        {
+            if (ftruncate(fd, (off_t)d_size) == 0)
+            {
+                mem = mmap(nullptr, d_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (mem == MAP_FAILED)
+                    mem = nullptr;
+            }
+            close(fd);
+            if (mem)
+                d_shared = true;
+            else
+                shm_unlink(d_shm_name.c_str());
+        }
+        if (!mem)
+            std::cerr << "iq_ring: Can not create shared memory " << d_shm_name
+                      << ", using private memory" << std::endl;
+    }
+#endif
+    if (!mem)
+    {
+        mem = large_buffer::alloc(d_size);
+        if (!mem)
+            throw std::bad_alloc();
+    }
+
+    d_hdr = new (mem) header;
+    d_hdr->magic = IQ_RING_MAGIC;
+    d_hdr->version = IQ_RING_VERSION;
+    d_hdr->capacity = d_capacity;
+    d_hdr->data_offset = IQ_RING_OFFSET;
+    d_hdr->guard = d_guard;
+    d_hdr->count.store(0);
+    d_hdr->valid_from.store(0);
+    d_hdr->time_ns.store(0);
+    d_hdr->sample_rate.store(0.0);
+    d_hdr->center_freq.store(0.0);
+    d_data = reinterpret_cast<gr_complex *>(static_cast<char *>(mem) + IQ_RING_OFFSET);
+}
+
+iq_ring::~iq_ring()
+{
+    d_hdr->~header();
+#ifndef _WIN32
+    if (d_shared)
+    {
+        munmap(d_hdr, d_size);
+        shm_unlink(d_shm_name.c_str());
+        return;
+    }
+#endif
+    large_buffer::dealloc(d_hdr, d_size);
+}
+
+/*! \brief Append samples, called from the flow graph only. */
+void iq_ring::write(const gr_complex *in, size_t n)
+{
+    uint64_t count = d_hdr->count.load(std::memory_order_relaxed);
+    size_t   mask = d_capacity - 1;
+
+    while (n > 0)
+    {
+        size_t chunk = std::min(n, d_guard);
+        size_t idx = count & mask;
+        size_t part = std::min(chunk, d_capacity - idx);
+
+        memcpy(d_data + idx, in, part * sizeof(gr_complex));
+        if (part < chunk)
+            memcpy(d_data, in + part, (chunk - part) * sizeof(gr_complex));
+
+        count += chunk;
+        in += chunk;
+        n -= chunk;
+        d_hdr->time_ns.store(now_ns(), std::memory_order_relaxed);
+        d_hdr->count.store(count, std::memory_order_release);
+    }
+}
+
+/*! \brief Start a new segment with the given sample rate and frequency. */
+void iq_ring::reset(double sample_rate, double center_freq)
+{
+    d_hdr->sample_rate.store(sample_rate, std::memory_order_relaxed);
+    d_hdr->center_freq.store(center_freq, std::memory_order_relaxed);
+    d_hdr->valid_from.store(d_hdr->count.load(std::memory_order_acquire),
+                            std::memory_order_release);
+}
+
+/*!
+ * \brief Copy samples out of the ring.
+ * \param out Buffer for at least n samples.
+ * \param n Number of samples wanted. Fewer are copied if the ring holds less.
+ * \param center_ns Wall clock time to center the snapshot on in ns since the
+ *                  UNIX epoch, negative for the latest samples.
+ * \param meta Filled with the position, time and metadata of the copy.
+ * \returns false if the ring is empty, the time is not in the ring or the
+ *          writer kept overwriting the samples.
+ *
+ * Times are converted to sample positions with the nominal sample rate and
+ * the time of the last published chunk, so they are accurate to about one
+ * work() call of the flow graph.
+ */
+bool iq_ring::snapshot(gr_complex *out, size_t n, int64_t center_ns, info &meta) const
+{
+    for (int i = 0; i < 4; i++)
+        if (try_copy(out, n, center_ns, meta))
+            return true;
+    return false;
+}
+
+bool iq_ring::try_copy(gr_complex *out, size_t n, int64_t center_ns, info &meta) const
+{
+    uint64_t valid_from = d_hdr->valid_from.load(std::memory_order_acquire);
+    uint64_t end = d_hdr->count.load(std::memory_order_acquire);
+    int64_t  end_ns = d_hdr->time_ns.load(std::memory_order_relaxed);
+    double   rate = d_hdr->sample_rate.load(std::memory_order_relaxed);
+    double   freq = d_hdr->center_freq.load(std::memory_order_relaxed);
+    uint64_t span = d_capacity - d_guard;
+    uint64_t oldest = std::max(valid_from, end > span ? end - span : 0);
+
+    if (end <= oldest || n == 0 || rate <= 0.0)
+        return false;
+
+    n = std::min<uint64_t>(n, end - oldest);
+    uint64_t first = end - n;
+    if (center_ns >= 0)
+    {
+        double back = (double)(end_ns - center_ns) * 1.e-9 * rate;
+        if (back < 0.0 || back > (double)(end - oldest))
+            return false;
+        uint64_t center = end - (uint64_t)back;
+        first = center > oldest + n / 2 ? center - n / 2 : oldest;
+        first = std::min(first, end - n);
+    }
+
+    size_t idx = first & (d_capacity - 1);
+    size_t part = std::min<size_t>(n, d_capacity - idx);
+    memcpy(out, d_data + idx, part * sizeof(gr_complex));
+    if (part < n)
+        memcpy(out + part, d_data, (n - part) * sizeof(gr_complex));
+
+    // Reject the copy if the writer may have reached the copied samples
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t now = d_hdr->count.load(std::memory_order_relaxed);
+    if (d_hdr->valid_from.load(std::memory_order_relaxed) != valid_from)
+        return false;
+    if (now > span && first < now - span)
+        return false;
+
+    meta.first = first;
+    meta.count = n;
+    meta.time_ns = end_ns - (int64_t)((double)(end - first) / rate * 1.e9);
+    meta.sample_rate = rate;
+    meta.center_freq = freq;
+    return true;
+}
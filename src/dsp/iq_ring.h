@@ -0,0 +1,100 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <gnuradio/gr_complex.h>
+
+/*! \brief Ring of the latest I/Q samples for snapshots.
+ *  \ingroup DSP
+ *
+ * One writer, the flow graph, appends samples with write(). Readers copy
+ * any part of the ring with snapshot() without taking a lock: the writer
+ * publishes a running sample count after every chunk of at most guard()
+ * samples, and a copy is only accepted if the count shows that the writer
+ * has not reached the copied samples in the meantime.
+ *
+ * Samples before the last reset() are never returned, reset() is called
+ * whenever the sample rate or the center frequency changes so that every
+ * snapshot matches its metadata.
+ *
+ * With a shared memory name the ring is created in POSIX shared memory
+ * and other processes can map it and read the same header and samples
+ * directly, see resources/remote-control.txt for the layout.
+ */
+class iq_ring
+{
+public:
+    /*! \brief Layout of the start of the mapping, version 1. */
+    struct header
+    {
+        uint32_t                magic;        /*!< 0x47514951, "GQIQ". */
+        uint32_t                version;      /*!< 1. */
+        uint64_t                capacity;     /*!< Size of the ring in samples. */
+        uint64_t                data_offset;  /*!< Byte offset of the ring. */
+        uint64_t                guard;        /*!< Samples that may be in flight. */
+        std::atomic<uint64_t>   count;        /*!< Samples written in total. */
+        std::atomic<uint64_t>   valid_from;   /*!< First sample after the last reset. */
+        std::atomic<int64_t>    time_ns;      /*!< Wall clock when count was published. */
+        std::atomic<double>     sample_rate;
+        std::atomic<double>     center_freq;
+    };
+
+    struct info
+    {
+        uint64_t    first;          /*!< Index of the first sample copied. */
+        size_t      count;          /*!< Samples copied. */
+        int64_t     time_ns;        /*!< Wall clock of the first sample, UNIX epoch. */
+        double      sample_rate;
+        double      center_freq;
+    };
+
+    explicit iq_ring(size_t capacity, const std::string &shm_name = "");
+    ~iq_ring();
+
+    iq_ring(const iq_ring &) = delete;
+    iq_ring &operator=(const iq_ring &) = delete;
+
+    void write(const gr_complex *in, size_t n);
+    void reset(double sample_rate, double center_freq);
+
+    bool snapshot(gr_complex *out, size_t n, int64_t center_ns, info &meta) const;
+
+    size_t capacity() const { return d_capacity; }
+    size_t guard() const { return d_guard; }
+    bool   is_shared() const { return d_shared; }
+
+private:
+    bool try_copy(gr_complex *out, size_t n, int64_t center_ns, info &meta) const;
+
+    header      *d_hdr;
+    gr_complex  *d_data;
+    size_t       d_capacity;  /*!< Power of two. */
+    size_t       d_guard;
+    size_t       d_size;      /*!< Bytes mapped. */
+    bool         d_shared;
+    std::string  d_shm_name;
+};
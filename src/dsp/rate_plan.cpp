@@ -0,0 +1,133 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <cmath>
+#include "dsp/rate_plan.h"
+
+/* Ratios closer than this are considered equal (rates are passed as float) */
+#define RATE_TOLERANCE    1.0e-5
+
+/* firdes tap estimate: attenuation / (22 * transition) */
+#define HAMMING_TAPS_K    (53.0 / 22.0)
+#define BLACKMAN_TAPS_K   (92.0 / 22.0)
+
+/* Smallest transition band accepted for the downconverter filter, in Hz */
+#define MIN_DDC_TRANSITION 20.0e3
+
+rate_stages rate_plan_stages(double rate)
+{
+    rate_stages st = {1, 1, rate};
+
+    if (rate <= 0.0)
+        return st;
+
+    /* the smallest interpolation that fits gives the fraction in lowest terms */
+    for (unsigned int interp = 1; interp <= RATE_PLAN_MAX_INTERP; interp++)
+    {
+        double decim = std::round(interp / rate);
+
+        if (decim >= 1.0 && std::abs(interp / decim - rate) < RATE_TOLERANCE * rate)
+        {
+            st.interp = interp;
+            st.decim = (unsigned int)decim;
+            st.ratio = 1.0;
+            return st;
+        }
+    }
+
+    if (rate >= 1.0)
+        return st;
+
+    /* largest integer decimation that does not go below the output rate */
+    st.decim = (unsigned int)std::floor(1.0 / rate + RATE_TOLERANCE);
+    st.ratio = rate * st.decim;
+    if (std::abs(st.ratio - 1.0) < RATE_TOLERANCE)
+        st.ratio = 1.0;
+
+    return st;
+}
+
+double rate_plan_resampler_cost(double rate)
+{
+    rate_stages st = rate_plan_stages(rate);
+    double cost = 0.0;
+
+    /* All stages use cutoff 0.4 and transition 0.2 relative to the lower of
+     * the input and the final output rate, see resampler_xx.cpp. A rational
+     * stage only computes the taps of one polyphase arm per output sample.
+     */
+    if (st.interp > 1)
+        cost += HAMMING_TAPS_K / (0.2 * std::min(rate, 1.0)) * rate;
+    else if (st.decim > 1)
+        cost += HAMMING_TAPS_K / (0.2 * rate) / st.decim;
+
+    /* The PFB computes two filter arms (value and slope) per output sample */
+    if (st.ratio != 1.0)
+    {
+        double r = std::min(st.ratio, 1.0);
+        cost += 2.0 * HAMMING_TAPS_K / (0.2 * r) * st.ratio / st.decim;
+    }
+
+    return cost;
+}
+
+double rate_plan_ddc_cost(double in_rate, unsigned int decim, double bandwidth)
+{
+    if (decim <= 1)
+        return 4.0;     /* rotator only, one complex multiply */
+
+    double out_rate = in_rate / decim;
+    double ntaps = BLACKMAN_TAPS_K * in_rate / (out_rate - bandwidth);
+
+    /* rotator on the input plus the decimating filter */
+    return 4.0 + ntaps / decim;
+}
+
+unsigned int rate_plan_ddc_decim(double in_rate, double bandwidth,
+                                 const std::vector<double> &chan_rates)
+{
+    double min_rate = bandwidth + MIN_DDC_TRANSITION;
+    for (double r : chan_rates)
+        min_rate = std::max(min_rate, r);
+
+    unsigned int max_decim = (unsigned int)std::floor(in_rate / min_rate);
+    unsigned int best = 1;
+    double best_cost = -1.0;
+
+    for (unsigned int d = 1; d <= std::max(max_decim, 1u); d++)
+    {
+        double quad_rate = in_rate / d;
+        double cost = rate_plan_ddc_cost(in_rate, d, bandwidth);
+
+        for (double r : chan_rates)
+            cost += rate_plan_resampler_cost(r / quad_rate) / d / chan_rates.size();
+
+        if (best_cost < 0.0 || cost < best_cost)
+        {
+            best = d;
+            best_cost = cost;
+        }
+    }
+
+    return best;
+}
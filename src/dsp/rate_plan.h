@@ -0,0 +1,76 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include <vector>
+
+/*! \brief Resampler stages for a given output/input ratio.
+ *
+ * Ratios that are a fraction with a small numerator are done exactly by a
+ * rational FIR resampler, which for an integer decimation is a plain
+ * decimating FIR filter. Otherwise the integer part of a decimation is done
+ * with a decimating FIR filter and only the remaining fractional part is
+ * left to the much more expensive polyphase arbitrary resampler.
+ */
+struct rate_stages
+{
+    unsigned int interp;  /*!< Interpolation of the FIR stage, 1 if none. */
+    unsigned int decim;   /*!< Decimation of the FIR stage, 1 if none. */
+    double       ratio;   /*!< Remaining output/input ratio, 1.0 if none. */
+};
+
+/*! \brief Largest interpolation used for a rational FIR stage. */
+#define RATE_PLAN_MAX_INTERP 32
+
+/*! \brief Split a resampling ratio into rational and fractional stages.
+ *  \param rate Resampling ratio, i.e. output/input.
+ */
+rate_stages rate_plan_stages(double rate);
+
+/*! \brief Estimated cost of a resampler in MACs per input sample.
+ *  \param rate Resampling ratio, i.e. output/input.
+ */
+double rate_plan_resampler_cost(double rate);
+
+/*! \brief Estimated cost of the downconverter in MACs per input sample.
+ *  \param in_rate Downconverter input rate.
+ *  \param decim Downconverter decimation.
+ *  \param bandwidth Two-sided bandwidth the downconverter must pass.
+ */
+double rate_plan_ddc_cost(double in_rate, unsigned int decim, double bandwidth);
+
+/*! \brief Choose the downconverter decimation.
+ *  \param in_rate Downconverter input rate.
+ *  \param bandwidth Two-sided bandwidth the downconverter must pass.
+ *  \param chan_rates Internal rates of the demodulator chains fed by the
+ *                    downconverter.
+ *
+ * Returns the decimation that minimises the combined cost of the
+ * downconverter and the channel resamplers, averaged over chan_rates. Rates
+ * where every channel rate is a simple fraction of the quadrature rate are
+ * therefore preferred since they avoid the arbitrary resampler altogether.
+ * At 20 Msps, for example, no integer decimation gives a multiple of
+ * 96 ksps, but 1.333 Msps reaches 96 and 240 ksps as 9/125 and 9/50.
+ */
+unsigned int rate_plan_ddc_decim(double in_rate, double bandwidth,
+                                 const std::vector<double> &chan_rates);
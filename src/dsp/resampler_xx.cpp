@@ -20,12 +20,41 @@
  * the Free Software Foundation, Inc., 51 Franklin Street,
  * Boston, MA 02110-1301, USA.
  */
+#include <algorithm>
 #include <cstdio>
 #include <gnuradio/io_signature.h>
 #include <gnuradio/filter/firdes.h>
+#include "dsp/rate_plan.h"
 #include "dsp/resampler_xx.h"
 
 #define RESAMPLER_OUTPUT_MULTIPLE 4096
+#define RESAMPLER_FILTER_SIZE     32
+
+/* Taps for the integer decimation stage. Cutoff and transition are relative
+ * to the final output rate, like the PFB taps below.
+ */
+static std::vector<float> decim_taps(float rate)
+{
+    return gr::filter::firdes::low_pass(1.0, 1.0, 0.4*(double)rate, 0.2*(double)rate);
+}
+
+/* Taps for the rational stage, designed at interp times the input rate */
+static std::vector<float> rational_taps(unsigned int interp, float rate)
+{
+    double bw = std::min((double)rate, 1.0);
+
+    return gr::filter::firdes::low_pass(interp, interp, 0.4*bw, 0.2*bw);
+}
+
+/* Taps for the PFB stage given its own output/input ratio */
+static std::vector<float> pfb_taps(double ratio)
+{
+    double cutoff = ratio > 1.0 ? 0.4 : 0.4*ratio;
+    double trans_width = ratio > 1.0 ? 0.2 : 0.2*ratio;
+
+    return gr::filter::firdes::low_pass(RESAMPLER_FILTER_SIZE, RESAMPLER_FILTER_SIZE,
+                                        cutoff, trans_width);
+}
 
 /* Create a new instance of resampler_cc and return
  * a shared_ptr. This is effectively the public constructor.
@@ -48,21 +77,8 @@ resampler_cc::resampler_cc(float rate)
        Note: In case of decimation, we limit the cutoff to the output bandwidth to avoid "phantom"
              signals when we have a frequency translation in front of the PFB resampler.
     */
-
-    /* generate taps */
-    double cutoff = rate > 1.0f ? 0.4 : 0.4*(double)rate;
-    double trans_width = rate > 1.0f ? 0.2 : 0.2*(double)rate;
-    unsigned int flt_size = 32;
-
-    d_taps = gr::filter::firdes::low_pass(flt_size, flt_size, cutoff, trans_width);
-
-    /* create the filter */
-    d_filter = gr::filter::pfb_arb_resampler_ccf::make(rate, d_taps, flt_size);
-    d_filter->set_output_multiple(RESAMPLER_OUTPUT_MULTIPLE);
-
-    /* connect filter */
-    connect(self(), 0, d_filter, 0);
-    connect(d_filter, 0, self(), 0);
+    make_stages(rate);
+    connect_all();
 }
 
 resampler_cc::~resampler_cc()
@@ -72,24 +88,56 @@ resampler_cc::~resampler_cc()
 
 void resampler_cc::set_rate(float rate)
 {
-    /* generate taps */
-    double cutoff = rate > 1.0f ? 0.4 : 0.4*(double)rate;
-    double trans_width = rate > 1.0f ? 0.2 : 0.2*(double)rate;
-    unsigned int flt_size = 32;
-    d_taps = gr::filter::firdes::low_pass(flt_size, flt_size, cutoff, trans_width);
-
     /* FIXME: Should implement set_taps() in PFB */
     lock();
-    disconnect(self(), 0, d_filter, 0);
-    disconnect(d_filter, 0, self(), 0);
-    d_filter.reset();
-    d_filter = gr::filter::pfb_arb_resampler_ccf::make(rate, d_taps, flt_size);
-    d_filter->set_output_multiple(RESAMPLER_OUTPUT_MULTIPLE);
-    connect(self(), 0, d_filter, 0);
-    connect(d_filter, 0, self(), 0);
+    disconnect_all();
+    make_stages(rate);
+    connect_all();
     unlock();
 }
 
+void resampler_cc::make_stages(float rate)
+{
+    rate_stages st = rate_plan_stages(rate);
+
+    d_rational.reset();
+    d_decim.reset();
+    d_filter.reset();
+    if (st.interp > 1)
+        d_rational = rational_resampler_ccf_blk::make(st.interp, st.decim,
+                                                       rational_taps(st.interp, rate));
+    else if (st.decim > 1)
+        d_decim = gr::filter::fir_filter_ccf::make(st.decim, decim_taps(rate));
+
+    /* a pass-through hier block is not possible, so keep a PFB at rate 1 */
+    if (st.ratio != 1.0 || (!d_decim && !d_rational))
+    {
+        d_taps = pfb_taps(st.ratio);
+        d_filter = gr::filter::pfb_arb_resampler_ccf::make(st.ratio, d_taps, RESAMPLER_FILTER_SIZE);
+        d_filter->set_output_multiple(RESAMPLER_OUTPUT_MULTIPLE);
+    }
+}
+
+void resampler_cc::connect_all()
+{
+    std::vector<gr::basic_block_sptr> stages;
+
+    if (d_rational)
+        stages.push_back(d_rational);
+    if (d_decim)
+        stages.push_back(d_decim);
+    if (d_filter)
+        stages.push_back(d_filter);
+
+    gr::basic_block_sptr prev = self();
+    for (auto &stage : stages)
+    {
+        connect(prev, 0, stage, 0);
+        prev = stage;
+    }
+    connect(prev, 0, self(), 0);
+}
+
 /* Create a new instance of resampler_ff and return
  * a shared_ptr. This is effectively the public constructor.
  */
@@ -111,20 +159,8 @@ resampler_ff::resampler_ff(float rate)
        Note: In case of decimation, we limit the cutoff to the output bandwidth to avoid "phantom"
              signals when we have a frequency translation in front of the PFB resampler.
     */
-
-    /* generate taps */
-    double cutoff = rate > 1.0f ? 0.4 : 0.4*(double)rate;
-    double trans_width = rate > 1.0f ? 0.2 : 0.2*(double)rate;
-    unsigned int flt_size = 32;
-
-    d_taps = gr::filter::firdes::low_pass(flt_size, flt_size, cutoff, trans_width);
-
-    /* create the filter */
-    d_filter = gr::filter::pfb_arb_resampler_fff::make(rate, d_taps, flt_size);
-
-    /* connect filter */
-    connect(self(), 0, d_filter, 0);
-    connect(d_filter, 0, self(), 0);
+    make_stages(rate);
+    connect_all();
 }
 
 resampler_ff::~resampler_ff()
@@ -134,19 +170,52 @@ resampler_ff::~resampler_ff()
 
 void resampler_ff::set_rate(float rate)
 {
-    /* generate taps */
-    double cutoff = rate > 1.0f ? 0.4 : 0.4*(double)rate;
-    double trans_width = rate > 1.0f ? 0.2 : 0.2*(double)rate;
-    unsigned int flt_size = 32;
-    d_taps = gr::filter::firdes::low_pass(flt_size, flt_size, cutoff, trans_width);
-
     /* FIXME: Should implement set_taps() in PFB */
     lock();
-    disconnect(self(), 0, d_filter, 0);
-    disconnect(d_filter, 0, self(), 0);
-    d_filter.reset();
-    d_filter = gr::filter::pfb_arb_resampler_fff::make(rate, d_taps, flt_size);
-    connect(self(), 0, d_filter, 0);
-    connect(d_filter, 0, self(), 0);
+    disconnect_all();
+    make_stages(rate);
+    connect_all();
     unlock();
 }
+
+void resampler_ff::make_stages(float rate)
+{
+    rate_stages st = rate_plan_stages(rate);
+
+    d_rational.reset();
+    d_decim.reset();
+    d_filter.reset();
+    if (st.interp > 1)
+        d_rational = rational_resampler_fff_blk::make(st.interp, st.decim,
+                                                       rational_taps(st.interp, rate));
+    else if (st.decim > 1)
+        d_decim = gr::filter::fir_filter_fff::make(st.decim, decim_taps(rate));
+
+    /* a pass-through hier block is not possible, so keep a PFB at rate 1 */
+    if (st.ratio != 1.0 || (!d_decim && !d_rational))
+    {
+        d_taps = pfb_taps(st.ratio);
+        d_filter = gr::filter::pfb_arb_resampler_fff::make(st.ratio, d_taps, RESAMPLER_FILTER_SIZE);
+    }
+}
+
+void resampler_ff::connect_all()
+{
+    std::vector<gr::basic_block_sptr> stages;
+
+    if (d_rational)
+        stages.push_back(d_rational);
+    if (d_decim)
+        stages.push_back(d_decim);
+    if (d_filter)
+        stages.push_back(d_filter);
+
+    gr::basic_block_sptr prev = self();
+    for (auto &stage : stages)
+    {
+        connect(prev, 0, stage, 0);
+        prev = stage;
+    }
+    connect(prev, 0, self(), 0);
+}
+
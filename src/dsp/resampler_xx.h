@@ -24,8 +24,14 @@
 #define RESAMPLER_XX_H
 
 #include <gnuradio/hier_block2.h>
+#include <gnuradio/filter/fir_filter_blk.h>
 #include <gnuradio/filter/pfb_arb_resampler_ccf.h>
 #include <gnuradio/filter/pfb_arb_resampler_fff.h>
+#if GNURADIO_VERSION < 0x031000
+#include <gnuradio/filter/rational_resampler_base.h>
+#else
+#include <gnuradio/filter/rational_resampler.h>
+#endif
 
 
 class resampler_cc;
@@ -39,6 +45,14 @@ typedef std::shared_ptr<resampler_cc> resampler_cc_sptr;
 typedef std::shared_ptr<resampler_ff> resampler_ff_sptr;
 #endif
 
+#if GNURADIO_VERSION < 0x031000
+typedef gr::filter::rational_resampler_base_ccf rational_resampler_ccf_blk;
+typedef gr::filter::rational_resampler_base_fff rational_resampler_fff_blk;
+#else
+typedef gr::filter::rational_resampler_ccf rational_resampler_ccf_blk;
+typedef gr::filter::rational_resampler_fff rational_resampler_fff_blk;
+#endif
+
 
 /*! \brief Return a shared_ptr to a new instance of resampler_cc.
  *  \param rate Resampling rate, i.e. output/input.
@@ -53,6 +67,11 @@ resampler_cc_sptr make_resampler_cc(float rate);
  * This block is a convenience wrapper around gr_pfb_arb_resampler_ccf. It takes care
  * of generating filter taps that can be used for the filter, as well as calculating
  * the other required parameters.
+ *
+ * Simple fractions are done exactly by a rational FIR resampler. Otherwise
+ * the integer part of a decimation is done by a decimating FIR filter and
+ * only the remaining fractional ratio by the PFB resampler, see
+ * rate_plan_stages().
  */
 class resampler_cc : public gr::hier_block2
 {
@@ -64,8 +83,13 @@ public:
     void set_rate(float rate);
 
 private:
+    void make_stages(float rate);
+    void connect_all();
+
     std::vector<float>            d_taps;
-    gr::filter::pfb_arb_resampler_ccf::sptr d_filter;
+    rational_resampler_ccf_blk::sptr d_rational; /*!< Rational stage, may be null. */
+    gr::filter::fir_filter_ccf::sptr d_decim;    /*!< Integer decimation stage, may be null. */
+    gr::filter::pfb_arb_resampler_ccf::sptr d_filter; /*!< Fractional stage, may be null. */
 };
 
 
@@ -83,6 +107,11 @@ resampler_ff_sptr make_resampler_ff(float rate);
  * This block is a convenience wrapper around gr_pfb_arb_resampler_fff. It takes care
  * of generating filter taps that can be used for the filter, as well as calculating
  * the other required parameters.
+ *
+ * Simple fractions are done exactly by a rational FIR resampler. Otherwise
+ * the integer part of a decimation is done by a decimating FIR filter and
+ * only the remaining fractional ratio by the PFB resampler, see
+ * rate_plan_stages().
  */
 class resampler_ff : public gr::hier_block2
 {
@@ -94,8 +123,13 @@ public:
     void set_rate(float rate);
 
 private:
+    void make_stages(float rate);
+    void connect_all();
+
     std::vector<float>            d_taps;
-    gr::filter::pfb_arb_resampler_fff::sptr d_filter;
+    rational_resampler_fff_blk::sptr d_rational; /*!< Rational stage, may be null. */
+    gr::filter::fir_filter_fff::sptr d_decim;    /*!< Integer decimation stage, may be null. */
+    gr::filter::pfb_arb_resampler_fff::sptr d_filter; /*!< Fractional stage, may be null. */
 };
 
 #endif // RESAMPLER_XX_H
@@ -24,6 +24,7 @@
 #include <gnuradio/io_signature.h>
 #include <gnuradio/gr_complex.h>
 #include <dsp/rx_agc_xx.h>
+#include <interfaces/trace.h>
 
 rx_agc_cc_sptr make_rx_agc_cc(double sample_rate, bool agc_on, int threshold,
                               int manual_gain, int slope, int decay, bool use_hang)
@@ -71,6 +72,7 @@ int rx_agc_cc::work(int noutput_items,
                     gr_vector_const_void_star &input_items,
                     gr_vector_void_star &output_items)
 {
+    TRACE_SCOPE("rx_agc_cc::work", "dsp");
     const gr_complex *in = (const gr_complex *) input_items[0];
     gr_complex *out = (gr_complex *) output_items[0];
 
@@ -39,34 +39,16 @@ static const int MAX_OUT = 1; /* Maximum number of output streams. */
 rx_demod_am::rx_demod_am(float quad_rate, bool dcr)
     : gr::hier_block2 ("rx_demod_am",
                       gr::io_signature::make (MIN_IN, MAX_IN, sizeof (gr_complex)),
-                      gr::io_signature::make (MIN_OUT, MAX_OUT, sizeof (float))),
-    d_dcr_enabled(dcr)
+                      gr::io_signature::make (MIN_OUT, MAX_OUT, sizeof (float)))
 {
     (void) quad_rate;
 
-    /* demodulator */
-    d_demod = gr::blocks::complex_to_mag::make(1);
+    /* demodulator with DC removal */
+    d_demod = make_am_envelope_cf(dcr);
 
     /* connect blocks */
     connect(self(), 0, d_demod, 0);
-
-    /* DC removal */
-    d_fftaps.resize(2);
-    d_fbtaps.resize(2);
-    d_fftaps[0] = 1.0;      // FIXME: could be configurable with a specified time constant
-    d_fftaps[1] = -1.0;
-    d_fbtaps[0] = 0.0;
-    d_fbtaps[1] = 0.999;
-    d_dcr = gr::filter::iir_filter_ffd::make(d_fftaps, d_fbtaps);
-
-    if (d_dcr_enabled) {
-        connect(d_demod, 0, d_dcr, 0);
-        connect(d_dcr, 0, self(), 0);
-    }
-    else {
-        connect(d_demod, 0, self(), 0);
-    }
-
+    connect(d_demod, 0, self(), 0);
 }
 
 rx_demod_am::~rx_demod_am ()
@@ -79,30 +61,7 @@ rx_demod_am::~rx_demod_am ()
  */
 void rx_demod_am::set_dcr(bool dcr)
 {
-    if (dcr == d_dcr_enabled) {
-        return;
-    }
-
-    if (d_dcr_enabled)
-    {
-        // Switching from ON to OFF
-        lock();
-        disconnect(d_demod, 0, d_dcr, 0);
-        disconnect(d_dcr, 0, self(), 0);
-        connect(d_demod, 0, self(), 0);
-        unlock();
-    }
-    else
-    {
-        // Switching from OFF to ON
-        lock();
-        disconnect(d_demod, 0, self(), 0);
-        connect(d_demod, 0, d_dcr, 0);
-        connect(d_dcr, 0, self(), 0);
-        unlock();
-    }
-
-    d_dcr_enabled = dcr;
+    d_demod->set_dcr(dcr);
 }
 
 /* Create a new instance of rx_demod_amsync and return a shared_ptr. */
@@ -116,35 +75,14 @@ rx_demod_amsync_sptr make_rx_demod_amsync(float quad_rate, bool dcr, float pll_b
 rx_demod_amsync::rx_demod_amsync(float quad_rate, bool dcr, float pll_bw)
     : gr::hier_block2 ("rx_demod_amsync",
                       gr::io_signature::make (MIN_IN, MAX_IN, sizeof (gr_complex)),
-                      gr::io_signature::make (MIN_OUT, MAX_OUT, sizeof (float))),
-    d_dcr_enabled(dcr)
+                      gr::io_signature::make (MIN_OUT, MAX_OUT, sizeof (float)))
 {
-    /* demodulator */
-    d_demod1 = gr::analog::pll_carriertracking_cc::make(pll_bw,
-                                                        (2*(float)M_PI*PLL_FMAX/quad_rate),
-                                                        (2*(float)M_PI*(-PLL_FMAX)/quad_rate));
-    d_demod2 = gr::blocks::complex_to_real::make(1);
+    /* demodulator with DC removal */
+    d_demod = make_am_sync_cf(quad_rate, dcr, pll_bw, PLL_FMAX);
 
     /* connect blocks */
-    connect(self(), 0, d_demod1, 0);
-    connect(d_demod1, 0, d_demod2, 0);
-
-    /* DC removal */
-    d_fftaps.resize(2);
-    d_fbtaps.resize(2);
-    d_fftaps[0] = 1.0;      // FIXME: could be configurable with a specified time constant
-    d_fftaps[1] = -1.0;
-    d_fbtaps[0] = 0.0;
-    d_fbtaps[1] = 0.999;
-    d_dcr = gr::filter::iir_filter_ffd::make(d_fftaps, d_fbtaps);
-
-    if (d_dcr_enabled) {
-        connect(d_demod2, 0, d_dcr, 0);
-        connect(d_dcr, 0, self(), 0);
-    }
-    else {
-        connect(d_demod2, 0, self(), 0);
-    }
+    connect(self(), 0, d_demod, 0);
+    connect(d_demod, 0, self(), 0);
 }
 
 rx_demod_amsync::~rx_demod_amsync ()
@@ -157,30 +95,7 @@ rx_demod_amsync::~rx_demod_amsync ()
  */
 void rx_demod_amsync::set_dcr(bool dcr)
 {
-    if (dcr == d_dcr_enabled) {
-        return;
-    }
-
-    if (d_dcr_enabled)
-    {
-        // Switching from ON to OFF
-        lock();
-        disconnect(d_demod2, 0, d_dcr, 0);
-        disconnect(d_dcr, 0, self(), 0);
-        connect(d_demod2, 0, self(), 0);
-        unlock();
-    }
-    else
-    {
-        // Switching from OFF to ON
-        lock();
-        disconnect(d_demod2, 0, self(), 0);
-        connect(d_demod2, 0, d_dcr, 0);
-        connect(d_dcr, 0, self(), 0);
-        unlock();
-    }
-
-    d_dcr_enabled = dcr;
+    d_demod->set_dcr(dcr);
 }
 
 /*! \brief Set PLL loop bandwidth.
@@ -188,6 +103,5 @@ void rx_demod_amsync::set_dcr(bool dcr)
  */
 void rx_demod_amsync::set_pll_bw(float pll_bw)
 {
-    d_demod1->set_loop_bandwidth(pll_bw);
-    d_demod1->update_gains();
+    d_demod->set_pll_bw(pll_bw);
 }
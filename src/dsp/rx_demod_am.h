@@ -25,11 +25,7 @@
 #define RX_DEMOD_AM_H
 
 #include <gnuradio/hier_block2.h>
-#include <gnuradio/blocks/complex_to_mag.h>
-#include <gnuradio/blocks/complex_to_real.h>
-#include <gnuradio/analog/pll_carriertracking_cc.h>
-#include <gnuradio/filter/iir_filter_ffd.h>
-#include <vector>
+#include "dsp/demod_kernels.h"
 
 class rx_demod_am;
 class rx_demod_amsync;
@@ -55,7 +51,7 @@ rx_demod_am_sptr make_rx_demod_am(float quad_rate, bool dcr=true);
  *
  * This class implements the AM demodulator as envelope detector.
  * AM demodulation is simply a conversion from complex to magnitude.
- * This block implements an optional IIR DC-removal filter for the demodulated signal.
+ * An optional IIR DC-removal filter is applied to the demodulated signal.
  *
  */
 class rx_demod_am : public gr::hier_block2
@@ -69,15 +65,7 @@ public:
 
 private:
     /* GR blocks */
-    gr::blocks::complex_to_mag::sptr    d_demod;  /*! AM demodulation (complex to magnitude). */
-    gr::filter::iir_filter_ffd::sptr    d_dcr;    /*! DC removal (IIR high pass). */
-
-    /* other parameters */
-    bool   d_dcr_enabled;   /*! DC removal flag. */
-
-    /* IIR DC-removal filter taps */
-    std::vector<double> d_fftaps;   /*! Feed forward taps. */
-    std::vector<double> d_fbtaps;   /*! Feed back taps. */
+    am_envelope_cf_sptr d_demod;    /*! Envelope detector and DC removal. */
 
 };
 
@@ -98,7 +86,7 @@ rx_demod_amsync_sptr make_rx_demod_amsync(float quad_rate, bool dcr=true, float
  * This class implements a synchronous AM demodulator.
  * A PLL tracks the carrier frequency and is mixed with the signal, shifting it to
  * 0 Hz.
- * This block implements an optional IIR DC-removal filter for the demodulated signal.
+ * An optional IIR DC-removal filter is applied to the demodulated signal.
  *
  */
 class rx_demod_amsync : public gr::hier_block2
@@ -113,16 +101,7 @@ public:
 
 private:
     /* GR blocks */
-    gr::analog::pll_carriertracking_cc::sptr d_demod1;
-    gr::blocks::complex_to_real::sptr d_demod2;
-    gr::filter::iir_filter_ffd::sptr    d_dcr;    /*! DC removal (IIR high pass). */
-
-    /* other parameters */
-    bool   d_dcr_enabled;   /*! DC removal flag. */
-
-    /* IIR DC-removal filter taps */
-    std::vector<double> d_fftaps;   /*! Feed forward taps. */
-    std::vector<double> d_fbtaps;   /*! Feed back taps. */
+    am_sync_cf_sptr d_demod;        /*! Carrier PLL, detector and DC removal. */
 
 };
 
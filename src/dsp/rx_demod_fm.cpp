@@ -54,16 +54,12 @@ rx_demod_fm::rx_demod_fm(float quad_rate, float max_dev, double tau)
 
     qDebug() << "FM demod gain:" << gain;
 
-    /* demodulator */
-    d_quad = gr::analog::quadrature_demod_cf::make(gain);
-
-    /* de-emphasis */
-    d_deemph = make_fm_deemph(d_quad_rate, tau);
+    /* demodulator and de-emphasis */
+    d_demod = make_fm_discriminator_cf(gain, d_quad_rate, tau);
 
     /* connect block */
-    connect(self(), 0, d_quad, 0);
-    connect(d_quad, 0, d_deemph, 0);
-    connect(d_deemph, 0, self(), 0);
+    connect(self(), 0, d_demod, 0);
+    connect(d_demod, 0, self(), 0);
 
 }
 
@@ -91,7 +87,7 @@ void rx_demod_fm::set_max_dev(float max_dev)
     d_max_dev = max_dev;
 
     gain = d_quad_rate / (2 * (float)M_PI * max_dev);
-    d_quad->set_gain(gain);
+    d_demod->set_gain(gain);
 }
 
 /*! \brief Set FM de-emphasis time constant.
@@ -99,5 +95,5 @@ void rx_demod_fm::set_max_dev(float max_dev)
  */
 void rx_demod_fm::set_tau(double tau)
 {
-    d_deemph->set_tau(tau);
+    d_demod->set_tau(tau);
 }
@@ -22,10 +22,9 @@
  */
 #pragma once
 
-#include <gnuradio/analog/quadrature_demod_cf.h>
 #include <gnuradio/hier_block2.h>
 #include <vector>
-#include "dsp/fm_deemph.h"
+#include "dsp/demod_kernels.h"
 
 class rx_demod_fm;
 #if GNURADIO_VERSION < 0x030900
@@ -48,8 +47,8 @@ rx_demod_fm_sptr make_rx_demod_fm(float quad_rate, float max_dev=5000.0, double
 /*! \brief FM demodulator.
  *  \ingroup DSP
  *
- * This class implements the FM demodulator using the gr_quadrature_demod block.
- * It also provides de-emphasis with variable time constant (use 0.0 to disable).
+ * This class implements the FM demodulator using fm_discriminator_cf, which
+ * also provides de-emphasis with variable time constant (use 0.0 to disable).
  *
  */
 class rx_demod_fm : public gr::hier_block2
@@ -64,8 +63,7 @@ public:
 
 private:
     /* GR blocks */
-    gr::analog::quadrature_demod_cf::sptr   d_quad;      /*! The quadrature demodulator block. */
-    fm_deemph_sptr                          d_deemph;    /*! De-emphasis IIR filter. */
+    fm_discriminator_cf_sptr      d_demod;     /*! Discriminator and de-emphasis. */
     std::vector<float>            d_taps;      /*! Taps for the PFB resampler. */
 
     /* other parameters */
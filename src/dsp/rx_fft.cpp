@@ -27,8 +27,20 @@
 #include <gnuradio/gr_complex.h>
 #include <gnuradio/fft/fft.h>
 #include "dsp/rx_fft.h"
+#include "interfaces/large_buffer.h"
+#include "interfaces/trace.h"
 #include <algorithm>
 
+/* Settle measurement: power is compared over blocks of this duration and the
+ * signal is considered settled after SETTLE_STABLE_BLOCKS blocks within
+ * SETTLE_TOLERANCE of each other. Measurement gives up after SETTLE_MAX_TIME.
+ */
+#define SETTLE_BLOCK_TIME       100e-6
+#define SETTLE_MIN_BLOCK        256
+#define SETTLE_STABLE_BLOCKS    3
+#define SETTLE_TOLERANCE        1.26    /* 1 dB */
+#define SETTLE_MAX_TIME         0.5
+
 
 rx_fft_c_sptr make_rx_fft_c (unsigned int fftsize, double quad_rate,
                              int wintype, bool normalize_energy)
@@ -50,8 +62,24 @@ rx_fft_c::rx_fft_c(unsigned int fftsize, double quad_rate, int wintype, bool nor
       d_fftsize(fftsize),
       d_startup_samples(0),
       d_quadrate(quad_rate),
+      d_settle(0.0),
+      d_discard_until(0),
+      d_measuring(false),
+      d_retune_offset(0),
+      d_stable_offset(0),
+      d_stable_blocks(0),
+      d_block_pwr(0.0),
+      d_block_fill(0),
+      d_prev_pwr(0.0),
+      d_settle_measured(-1.0),
+      d_frame_rate(0.0f),
+      d_sparse(false),
+      d_skip(0),
+      d_frame_fill(0),
+      d_frame_valid(false),
       d_wintype(-1),
-      d_normalize_energy(false)
+      d_normalize_energy(false),
+      d_ring_bound(false)
 {
 
     /* create FFT object */
@@ -68,6 +96,8 @@ rx_fft_c::rx_fft_c(unsigned int fftsize, double quad_rate, int wintype, bool nor
     d_writer = gr::make_buffer(MAX_FFT_SIZE * 2, sizeof(gr_complex), 1, 1);
 #endif
     d_reader = gr::buffer_add_reader(d_writer, 0);
+    d_ring = d_writer->write_pointer();
+    large_buffer::prepare(d_ring, sizeof(gr_complex) * d_writer->bufsize());
 
     memset(d_writer->write_pointer(), 0, sizeof(gr_complex) * MAX_FFT_SIZE);
     d_writer->update_write_pointer(MAX_FFT_SIZE);
@@ -89,42 +119,204 @@ rx_fft_c::~rx_fft_c()
  *  \param output_items
  *
  * This method does nothing except throwing the incoming samples into the
- * circular buffer.
+ * circular buffer, split at retune tags.
  * FFT is only executed when the GUI asks for new FFT data via get_fft_data().
  */
 int rx_fft_c::work(int noutput_items,
                    gr_vector_const_void_star &input_items,
                    gr_vector_void_star &output_items)
 {
+    TRACE_SCOPE("rx_fft_c::work", "dsp");
     const gr_complex *in = (const gr_complex*)input_items[0];
     (void) output_items;
 
-    /* just throw new samples into the buffer */
-    int items_to_copy = std::min(noutput_items, (int)d_writer->bufsize());
-    if (items_to_copy < noutput_items)
-        in += (noutput_items - items_to_copy);
+    /* the ring was allocated by the GUI thread, move it next to this one */
+    if (!d_ring_bound)
+    {
+        large_buffer::bind_local(d_ring, sizeof(gr_complex) * d_writer->bufsize());
+        d_ring_bound = true;
+    }
+
+    static const pmt::pmt_t rx_freq_key = pmt::intern("rx_freq");
+    uint64_t start = nitems_read(0);
+    int pos = 0;
 
+    d_tags.clear();
+    get_tags_in_range(d_tags, 0, start, start + noutput_items, rx_freq_key);
+
+    for (size_t t = 0; t <= d_tags.size(); t++)
     {
-        std::lock_guard<std::mutex> lock(d_in_mutex);
+        int end = (t < d_tags.size()) ? (int)(d_tags[t].offset - start) : noutput_items;
 
-        if (d_writer->space_available() < items_to_copy)
-            d_reader->update_read_pointer(items_to_copy - d_writer->space_available());
-        memcpy(d_writer->write_pointer(), in, sizeof(gr_complex) * items_to_copy);
-        d_writer->update_write_pointer(items_to_copy);
+        add_samples(in + pos, end - pos, start + pos);
+        pos = end;
 
-        if (d_startup_samples < d_writer->bufsize())
-            d_startup_samples += items_to_copy;
+        if (t < d_tags.size())
+            retune(d_tags[t].offset);
     }
 
     return noutput_items;
 }
 
+/*! \brief Throw samples into the circular buffer, skipping the settle time. */
+void rx_fft_c::add_samples(const gr_complex *in, int nitems, uint64_t offset)
+{
+    if (nitems <= 0)
+        return;
+
+    if (d_measuring)
+        measure_settle(in, nitems, offset);
+
+    if (offset + nitems <= d_discard_until)
+        return;
+    if (offset < d_discard_until)
+    {
+        in += d_discard_until - offset;
+        nitems -= (int)(d_discard_until - offset);
+    }
+
+    std::unique_lock<std::mutex> lock(d_in_mutex);
+
+    if (d_sparse)
+    {
+        lock.unlock();
+        capture_frames(in, nitems);
+        return;
+    }
+
+    int items_to_copy = std::min(nitems, (int)d_writer->bufsize());
+    if (items_to_copy < nitems)
+        in += (nitems - items_to_copy);
+
+    if (d_writer->space_available() < items_to_copy)
+        d_reader->update_read_pointer(items_to_copy - d_writer->space_available());
+    memcpy(d_writer->write_pointer(), in, sizeof(gr_complex) * items_to_copy);
+    d_writer->update_write_pointer(items_to_copy);
+
+    if (d_startup_samples < d_writer->bufsize())
+        d_startup_samples += items_to_copy;
+}
+
+/*! \brief Copy the samples of the next frames and skip the rest.
+ *
+ * Each frame is the fftsize samples at the end of a frame period. Only the
+ * work thread touches d_frame, the lock is taken once per frame.
+ */
+void rx_fft_c::capture_frames(const gr_complex *in, int nitems)
+{
+    while (nitems > 0)
+    {
+        if (d_skip > 0)
+        {
+            int n = (int)std::min<uint64_t>(d_skip, nitems);
+            d_skip -= n;
+            in += n;
+            nitems -= n;
+            continue;
+        }
+
+        if (d_frame_fill == 0)
+        {
+            std::lock_guard<std::mutex> lock(d_in_mutex);
+            d_frame.resize(d_fftsize);
+        }
+
+        size_t n = std::min((size_t)nitems, d_frame.size() - d_frame_fill);
+        memcpy(&d_frame[d_frame_fill], in, sizeof(gr_complex) * n);
+        d_frame_fill += n;
+        in += n;
+        nitems -= (int)n;
+
+        if (d_frame_fill == d_frame.size())
+        {
+            std::lock_guard<std::mutex> lock(d_in_mutex);
+            double period = (d_frame_rate > 0.0f) ? d_quadrate / d_frame_rate : 0.0;
+
+            d_frame.swap(d_frame_ready);
+            d_frame_valid = true;
+            d_frame_fill = 0;
+            d_skip = (period > d_frame_ready.size()) ?
+                     (uint64_t)(period - d_frame_ready.size()) : 0;
+        }
+    }
+}
+
+/*! \brief Start over after a retune at the given sample. */
+void rx_fft_c::retune(uint64_t offset)
+{
+    double settle;
+
+    {
+        std::lock_guard<std::mutex> lock(d_in_mutex);
+        d_startup_samples = 0;
+        d_frame_valid = false;
+        settle = d_settle;
+    }
+    d_frame_fill = 0;
+    d_skip = 0;
+
+    d_discard_until = offset + (uint64_t)std::llround(settle * d_quadrate);
+
+    d_measuring = true;
+    d_retune_offset = offset;
+    d_stable_offset = offset;
+    d_stable_blocks = 0;
+    d_block_pwr = 0.0;
+    d_block_fill = 0;
+    d_prev_pwr = -1.0;
+}
+
+/*! \brief Look for the point where the power stops changing after a retune. */
+void rx_fft_c::measure_settle(const gr_complex *in, int nitems, uint64_t offset)
+{
+    int blocklen = std::max(SETTLE_MIN_BLOCK, (int)(SETTLE_BLOCK_TIME * d_quadrate));
+
+    for (int i = 0; i < nitems && d_measuring; i++)
+    {
+        d_block_pwr += std::norm(in[i]);
+        if (++d_block_fill < blocklen)
+            continue;
+
+        uint64_t block_start = offset + i + 1 - blocklen;
+        double pwr = d_block_pwr / blocklen;
+
+        if (d_prev_pwr >= 0.0 && pwr <= d_prev_pwr * SETTLE_TOLERANCE &&
+            pwr * SETTLE_TOLERANCE >= d_prev_pwr)
+        {
+            d_stable_blocks++;
+        }
+        else
+        {
+            d_stable_blocks = 0;
+            d_stable_offset = block_start;
+        }
+        d_prev_pwr = pwr;
+        d_block_pwr = 0.0;
+        d_block_fill = 0;
+
+        double elapsed = (block_start + blocklen - d_retune_offset) / d_quadrate;
+        if (d_stable_blocks >= SETTLE_STABLE_BLOCKS)
+        {
+            std::lock_guard<std::mutex> lock(d_in_mutex);
+            d_settle_measured = (d_stable_offset - d_retune_offset) / d_quadrate;
+            d_measuring = false;
+        }
+        else if (elapsed > SETTLE_MAX_TIME)
+        {
+            std::lock_guard<std::mutex> lock(d_in_mutex);
+            d_settle_measured = SETTLE_MAX_TIME;
+            d_measuring = false;
+        }
+    }
+}
+
 /*! \brief Get FFT data.
  *  \param fftPoints Buffer to copy FFT data
  *  \param fftSize Current FFT size (output).
  */
 int rx_fft_c::get_fft_data(float* fftPoints)
 {
+    TRACE_SCOPE("rx_fft_c::get_fft_data", "gui");
     std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
     std::chrono::duration<double> diff = now - d_lasttime;
     diff = std::min(diff, std::chrono::duration<double>(d_writer->bufsize() / d_quadrate));
@@ -133,12 +325,24 @@ int rx_fft_c::get_fft_data(float* fftPoints)
     {
         std::lock_guard<std::mutex> lock(d_in_mutex);
 
-        d_reader->update_read_pointer(std::min((int)(diff.count() * d_quadrate * 1.001), d_reader->items_available() - MAX_FFT_SIZE));
+        if (d_sparse)
+        {
+            /* repeat the last frame if no new one has arrived yet */
+            if (!d_frame_valid || d_frame_ready.size() != d_fftsize)
+                return -1;
+
+            apply_window(d_frame_ready.data(), d_fftsize);
+        }
+        else
+        {
+            d_reader->update_read_pointer(std::min((int)(diff.count() * d_quadrate * 1.001), d_reader->items_available() - MAX_FFT_SIZE));
 
-        if (d_startup_samples < d_reader->items_available() - (MAX_FFT_SIZE - d_fftsize))
-            return -1;
+            if (d_startup_samples < d_reader->items_available() - (MAX_FFT_SIZE - d_fftsize))
+                return -1;
 
-        apply_window(d_fftsize);
+            gr_complex *p = (gr_complex *)d_reader->read_pointer();
+            apply_window(p + (MAX_FFT_SIZE - d_fftsize), d_fftsize);
+        }
     }
 
     /* compute FFT */
@@ -156,17 +360,15 @@ int rx_fft_c::get_fft_data(float* fftPoints)
 }
 
 /*! \brief Compute FFT on the available input data.
- *  \param data_in The data to compute FFT on.
+ *  \param p The data to compute FFT on.
  *  \param size The size of data_in.
  *
  * Note that this function does not lock the mutex since the caller, get_fft_data()
  * has already locked it.
  */
-void rx_fft_c::apply_window(unsigned int size)
+void rx_fft_c::apply_window(const gr_complex *p, unsigned int size)
 {
     /* apply window, if any */
-    gr_complex * p = (gr_complex *)d_reader->read_pointer();
-    p += (MAX_FFT_SIZE - d_fftsize);
     if (d_window.size())
     {
         gr_complex *dst = d_fft->get_inbuf();
@@ -194,6 +396,7 @@ void rx_fft_c::set_fft_size(unsigned int fftsize)
 #endif
 
         update_window();
+        update_sparse();
     }
 }
 
@@ -201,6 +404,59 @@ void rx_fft_c::set_fft_size(unsigned int fftsize)
 void rx_fft_c::set_quad_rate(double quad_rate)
 {
     d_quadrate = quad_rate;
+    update_sparse();
+}
+
+/*! \brief Set the rate at which get_fft_data() is called.
+ *  \param fps Frames per second, 0 to capture every sample.
+ */
+void rx_fft_c::set_frame_rate(float fps)
+{
+    d_frame_rate = std::max(fps, 0.0f);
+    update_sparse();
+}
+
+/*! \brief Use sparse capture if the frames do not overlap. */
+void rx_fft_c::update_sparse()
+{
+    std::lock_guard<std::mutex> lock(d_in_mutex);
+
+    bool sparse = d_frame_rate > 0.0f && d_quadrate / d_frame_rate >= 2.0 * d_fftsize;
+    if (sparse != d_sparse)
+    {
+        /* stale data in the ring or the frame buffer, wait for new samples */
+        d_sparse = sparse;
+        d_startup_samples = 0;
+        d_frame_valid = false;
+    }
+}
+
+/*! \brief Set how long to discard samples after a retune.
+ *  \param seconds The settle time. 0 only holds the spectrum until a full
+ *                 FFT of new samples is available.
+ */
+void rx_fft_c::set_retune_settle(double seconds)
+{
+    std::lock_guard<std::mutex> lock(d_in_mutex);
+    d_settle = std::max(seconds, 0.0);
+}
+
+/*! \brief Get the settle time measured after the last retune.
+ *  \returns The settle time in seconds or -1 if nothing has been measured.
+ *
+ * Measured from the "rx_freq" tag, so it includes the front end latency.
+ */
+double rx_fft_c::get_retune_settle_time()
+{
+    std::lock_guard<std::mutex> lock(d_in_mutex);
+    return d_settle_measured;
+}
+
+/*! \brief Forget the measured settle time, e.g. when the device changes. */
+void rx_fft_c::reset_retune_settle_time()
+{
+    std::lock_guard<std::mutex> lock(d_in_mutex);
+    d_settle_measured = -1.0;
 }
 
 /*! \brief Set new window type. */
@@ -307,13 +563,27 @@ int rx_fft_f::work(int noutput_items,
                    gr_vector_const_void_star &input_items,
                    gr_vector_void_star &output_items)
 {
-    const float *in = (const float*)input_items[0];
+    TRACE_SCOPE("rx_fft_f::work", "dsp");
     (void) output_items;
 
+    add_samples((const float*)input_items[0], noutput_items);
+
+    return noutput_items;
+}
+
+/*! \brief Add samples to the circular buffer.
+ *  \param in The samples.
+ *  \param nitems The number of samples.
+ *
+ * Used by work() and by audio_output, which feeds the audio FFT without
+ * connecting it to the flow graph.
+ */
+void rx_fft_f::add_samples(const float *in, int nitems)
+{
     /* just throw new samples into the buffer */
-    int items_to_copy = std::min(noutput_items, (int)d_writer->bufsize());
-    if (items_to_copy < noutput_items)
-        in += (noutput_items - items_to_copy);
+    int items_to_copy = std::min(nitems, (int)d_writer->bufsize());
+    if (items_to_copy < nitems)
+        in += (nitems - items_to_copy);
 
     {
         std::lock_guard<std::mutex> lock(d_in_mutex);
@@ -326,8 +596,6 @@ int rx_fft_f::work(int noutput_items,
         if (d_startup_samples < d_writer->bufsize())
             d_startup_samples += items_to_copy;
     }
-
-    return noutput_items;
 }
 
 /*! \brief Get FFT data.
@@ -336,6 +604,7 @@ int rx_fft_f::work(int noutput_items,
  */
 int rx_fft_f::get_fft_data(float* fftPoints)
 {
+    TRACE_SCOPE("rx_fft_f::get_fft_data", "gui");
     std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
     std::chrono::duration<double> diff = now - d_lasttime;
     diff = std::min(diff, std::chrono::duration<double>(d_writer->bufsize() / d_audiorate));
@@ -33,6 +33,7 @@
 #include <gnuradio/buffer_reader.h>
 #endif
 #include <chrono>
+#include "interfaces/large_buffer.h"
 
 
 #define MAX_FFT_SIZE (1024 * 1024 * 4)
@@ -74,6 +75,19 @@ rx_fft_c_sptr make_rx_fft_c(unsigned int fftsize=4096,
  * will be performed on the data stored in the circular buffer - assuming
  * of course that the buffer contains at least fftsize samples.
  *
+ * Samples carrying an "rx_freq" tag mark a retune. The spectrum is held
+ * until a full FFT of samples after the tag is available, and samples
+ * within the settle time after the tag are discarded. The tag is placed
+ * before the samples still buffered in the front end, so the settle time
+ * covers that latency as well as the tuner. The block also measures how
+ * long the signal power takes to stabilise after each tag, see
+ * get_retune_settle_time(), which includes the same latency.
+ *
+ * When the frame rate is known and frames are further apart than two FFT
+ * lengths, only the fftsize samples needed for each frame are copied and
+ * the samples in between are skipped, so the cost scales with frame rate
+ * times FFT size instead of with the sample rate.
+ *
  * \note Uses code from qtgui_sink_c
  */
 class rx_fft_c : public gr::sync_block
@@ -103,14 +117,43 @@ public:
     void set_quad_rate(double quad_rate);
     unsigned int fft_size() const {return d_fftsize;}
 
+    void set_frame_rate(float fps);
+
+    void   set_retune_settle(double seconds);
+    double get_retune_settle_time();
+    void   reset_retune_settle_time();
+
 private:
     unsigned int d_fftsize;   /*! Current FFT size. */
     unsigned int d_startup_samples;
     double       d_quadrate;
+
+    /* retune handling */
+    double       d_settle;           /*! Time to discard after retune, in seconds. */
+    uint64_t     d_discard_until;    /*! First sample used after the last retune. */
+    bool         d_measuring;        /*! Settle measurement in progress. */
+    uint64_t     d_retune_offset;    /*! Sample where the last retune took effect. */
+    uint64_t     d_stable_offset;    /*! Start of the current stable run. */
+    int          d_stable_blocks;    /*! Consecutive blocks with similar power. */
+    double       d_block_pwr;        /*! Power accumulator of the current block. */
+    int          d_block_fill;       /*! Samples in the current block. */
+    double       d_prev_pwr;         /*! Mean power of the previous block. */
+    double       d_settle_measured;  /*! Last measured settle time, -1 if none. */
+    std::vector<gr::tag_t> d_tags;
+
+    /* sparse capture */
+    float        d_frame_rate;       /*! Expected FFT frames per second, 0 if unknown. */
+    bool         d_sparse;           /*! Capture single frames instead of everything. */
+    uint64_t     d_skip;             /*! Samples to skip before the next frame. */
+    large_buffer::vector<gr_complex> d_frame;       /*! Frame being captured. */
+    large_buffer::vector<gr_complex> d_frame_ready; /*! Last complete frame. */
+    size_t       d_frame_fill;       /*! Samples in d_frame. */
+    bool         d_frame_valid;      /*! d_frame_ready holds a frame. */
+
     int          d_wintype;   /*! Current window type. */
     bool         d_normalize_energy;
 
-    std::mutex   d_in_mutex;   /*! Used to lock input buffer. */
+    std::mutex   d_in_mutex;   /*! Used to lock input buffer and the settle parameters. */
 
 #if GNURADIO_VERSION < 0x030900
     gr::fft::fft_complex    *d_fft;    /*! FFT object. */
@@ -121,10 +164,17 @@ private:
 
     gr::buffer_sptr d_writer;
     gr::buffer_reader_sptr d_reader;
+    void          *d_ring;         /*! Start of the circular buffer mapping. */
+    bool           d_ring_bound;   /*! Ring moved to the NUMA node of work(). */
     std::chrono::time_point<std::chrono::steady_clock> d_lasttime;
 
-    void apply_window(unsigned int size);
+    void apply_window(const gr_complex *in, unsigned int size);
     void update_window();
+    void update_sparse();
+    void capture_frames(const gr_complex *in, int nitems);
+    void retune(uint64_t offset);
+    void add_samples(const gr_complex *in, int nitems, uint64_t offset);
+    void measure_settle(const gr_complex *in, int nitems, uint64_t offset);
 };
 
 
@@ -173,6 +223,7 @@ public:
              gr_vector_const_void_star &input_items,
              gr_vector_void_star &output_items);
 
+    void add_samples(const float *in, int nitems);
     int get_fft_data(float* fftPoints);
 
     void set_window_type(int wintype, bool normalize_energy);
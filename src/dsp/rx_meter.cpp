@@ -24,6 +24,7 @@
 #include <volk/volk.h>
 #include <gnuradio/io_signature.h>
 #include <dsp/rx_meter.h>
+#include <interfaces/trace.h>
 #include <iostream>
 
 
@@ -59,6 +60,7 @@ int rx_meter_c::work(int noutput_items,
                      gr_vector_const_void_star &input_items,
                      gr_vector_void_star &output_items)
 {
+    TRACE_SCOPE("rx_meter_c::work", "dsp");
     std::lock_guard<std::mutex> lock(d_mutex);
 
     const gr_complex *in = (const gr_complex *) input_items[0];
@@ -24,6 +24,7 @@
 #include <gnuradio/io_signature.h>
 #include <gnuradio/gr_complex.h>
 #include "dsp/rx_noise_blanker_cc.h"
+#include "interfaces/trace.h"
 
 rx_nb_cc_sptr make_rx_nb_cc(double sample_rate, float thld1, float thld2)
 {
@@ -68,6 +69,7 @@ int rx_nb_cc::work(int noutput_items,
                    gr_vector_const_void_star &input_items,
                    gr_vector_void_star &output_items)
 {
+    TRACE_SCOPE("rx_nb_cc::work", "dsp");
     const gr_complex *in = (const gr_complex *) input_items[0];
     gr_complex *out = (gr_complex *) output_items[0];
     int i;
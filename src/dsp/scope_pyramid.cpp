@@ -0,0 +1,227 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "dsp/scope_pyramid.h"
+
+/**
+ * @brief Create an envelope pyramid.
+ * @param raw_size Number of samples kept at full resolution.
+ * @param level_size Number of min/max entries kept on each further level.
+ * @param factor Samples or entries merged into one entry of the next level.
+ * @param levels Number of levels including the samples.
+ */
+scope_pyramid::scope_pyramid(unsigned int raw_size, unsigned int level_size,
+                             unsigned int factor, unsigned int levels)
+    : d_factor(std::max(factor, 2u))
+{
+    uint64_t scale = 1;
+
+    d_levels.resize(std::max(levels, 1u));
+    for (auto &l : d_levels)
+    {
+        if (scale == 1)
+        {
+            l.min.resize(raw_size);
+        }
+        else
+        {
+            l.min.resize(level_size);
+            l.max.resize(level_size);
+        }
+        l.scale = scale;
+        scale *= d_factor;
+    }
+    clear();
+}
+
+void scope_pyramid::clear()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    for (auto &l : d_levels)
+    {
+        l.count = 0;
+        l.acc_min = std::numeric_limits<float>::max();
+        l.acc_max = std::numeric_limits<float>::lowest();
+        l.acc_n = 0;
+    }
+}
+
+uint64_t scope_pyramid::count() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    return d_levels[0].count;
+}
+
+/** Add samples, each one updates at most one entry per level. */
+void scope_pyramid::add(const float *in, int n)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    const size_t nlevels = d_levels.size();
+    level_ring &raw = d_levels[0];
+    const size_t raw_size = raw.min.size();
+
+    for (int k = 0; k < n; k++)
+    {
+        float mn = in[k];
+        float mx = in[k];
+
+        raw.min[raw.count % raw_size] = mn;
+        raw.count++;
+
+        // carry completed entries upwards
+        for (size_t L = 1; L < nlevels; L++)
+        {
+            level_ring &l = d_levels[L];
+
+            l.acc_min = std::min(l.acc_min, mn);
+            l.acc_max = std::max(l.acc_max, mx);
+            if (++l.acc_n < d_factor)
+                break;
+
+            mn = l.acc_min;
+            mx = l.acc_max;
+            l.min[l.count % l.min.size()] = mn;
+            l.max[l.count % l.max.size()] = mx;
+            l.count++;
+            l.acc_min = std::numeric_limits<float>::max();
+            l.acc_max = std::numeric_limits<float>::lowest();
+            l.acc_n = 0;
+        }
+    }
+}
+
+void scope_pyramid::get(const level_ring &l, uint64_t i, float &mn, float &mx)
+{
+    mn = l.min[i % l.min.size()];
+    mx = l.max.empty() ? mn : l.max[i % l.max.size()];
+}
+
+/** Latest entry in [first, last) where the signal crosses the level, -1 if none. */
+int64_t scope_pyramid::find_trigger(const level_ring &l, uint64_t first, uint64_t last,
+                                    trigger_mode trigger, float level)
+{
+    float pmn, pmx, mn, mx;
+
+    for (uint64_t i = last; i > first + 1; )
+    {
+        i--;
+        get(l, i, mn, mx);
+        get(l, i - 1, pmn, pmx);
+        if (trigger == TRIGGER_RISING && pmx < level && mx >= level)
+            return (int64_t)i;
+        if (trigger == TRIGGER_FALLING && pmn > level && mn <= level)
+            return (int64_t)i;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Get the envelope of the latest samples.
+ * @param span The time span in samples.
+ * @param pixels Number of columns to fill.
+ * @param mins Minimum of each column, NaN if there is no data.
+ * @param maxs Maximum of each column, NaN if there is no data.
+ * @param trigger Trigger mode. When no crossing is found within the last
+ *                four spans the latest samples are shown.
+ * @param level Trigger level.
+ * @param pretrigger Part of the span shown before the trigger point.
+ * @return The number of columns filled.
+ */
+int scope_pyramid::envelope(double span, int pixels, float *mins, float *maxs,
+                            trigger_mode trigger, float level, double pretrigger) const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    if (pixels <= 0 || span <= 0.0)
+        return 0;
+
+    // coarsest level with an entry per pixel, or a coarser one if it does
+    // not reach back far enough
+    const double per_pixel = span / pixels;
+    size_t L = 0;
+    while (L + 1 < d_levels.size() && (double)d_levels[L + 1].scale <= per_pixel)
+        L++;
+    while (L + 1 < d_levels.size() &&
+           (double)d_levels[L].min.size() * d_levels[L].scale < span &&
+           d_levels[L].count > d_levels[L].min.size())
+        L++;
+
+    const level_ring &l = d_levels[L];
+    const uint64_t last = l.count;
+    const uint64_t first = last > l.min.size() ? last - l.min.size() : 0;
+    const double span_e = span / (double)l.scale;
+    double end = (double)last;
+
+    if (trigger != TRIGGER_NONE)
+    {
+        double post = (1.0 - pretrigger) * span_e;
+        double from = std::max((double)first, end - 4.0 * span_e);
+        double to = end - post;
+
+        if (to > from)
+        {
+            int64_t t = find_trigger(l, (uint64_t)from, (uint64_t)to, trigger, level);
+            if (t >= 0)
+                end = (double)t + post;
+        }
+    }
+
+    const double start = end - span_e;
+    const double per_px = span_e / pixels;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    for (int p = 0; p < pixels; p++)
+    {
+        double a = std::floor(start + p * per_px);
+        double b = std::max(a + 1.0, std::floor(start + (p + 1) * per_px));
+
+        if (a >= (double)last || b <= (double)first)
+        {
+            mins[p] = nan;
+            maxs[p] = nan;
+            continue;
+        }
+
+        uint64_t i0 = a < (double)first ? first : (uint64_t)a;
+        uint64_t i1 = b > (double)last ? last : (uint64_t)b;
+
+        float mn, mx, emn, emx;
+        get(l, i0, mn, mx);
+        for (uint64_t i = i0 + 1; i < i1; i++)
+        {
+            get(l, i, emn, emx);
+            mn = std::min(mn, emn);
+            mx = std::max(mx, emx);
+        }
+        mins[p] = mn;
+        maxs[p] = mx;
+    }
+
+    return pixels;
+}
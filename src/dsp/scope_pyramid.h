@@ -0,0 +1,85 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/*! \brief Min/max envelope of a sample stream at several time scales.
+ *  \ingroup DSP
+ *
+ * The latest samples are kept in a ring (level 0). Each further level keeps
+ * the minimum and maximum of groups of `factor` entries of the level below,
+ * in a ring of its own, so level L covers factor^L samples per entry. The
+ * levels are updated incrementally as samples are added.
+ *
+ * envelope() picks the coarsest level that still has at least one entry per
+ * pixel, so any time span is drawn with at most `factor` entries per pixel.
+ *
+ * add() and the readers may run in different threads.
+ */
+class scope_pyramid
+{
+public:
+    enum trigger_mode {
+        TRIGGER_NONE    = 0,  /*!< Show the latest samples. */
+        TRIGGER_RISING  = 1,  /*!< Align to the latest rising crossing of the level. */
+        TRIGGER_FALLING = 2   /*!< Align to the latest falling crossing of the level. */
+    };
+
+    scope_pyramid(unsigned int raw_size = 1u << 20,
+                  unsigned int level_size = 1u << 16,
+                  unsigned int factor = 8,
+                  unsigned int levels = 8);
+
+    void clear();
+    void add(const float *in, int n);
+
+    /*! \brief Number of samples added since the last clear(). */
+    uint64_t count() const;
+
+    int envelope(double span, int pixels, float *mins, float *maxs,
+                 trigger_mode trigger = TRIGGER_NONE, float level = 0.0f,
+                 double pretrigger = 0.1) const;
+
+private:
+    struct level_ring
+    {
+        std::vector<float>  min;     /*!< The samples on level 0. */
+        std::vector<float>  max;     /*!< Empty on level 0. */
+        uint64_t            count;   /*!< Entries written. */
+        uint64_t            scale;   /*!< Samples per entry. */
+        float               acc_min; /*!< Entry being built. */
+        float               acc_max;
+        unsigned int        acc_n;
+    };
+
+    static void get(const level_ring &l, uint64_t i, float &mn, float &mx);
+    static int64_t find_trigger(const level_ring &l, uint64_t first, uint64_t last,
+                                trigger_mode trigger, float level);
+
+    mutable std::mutex      d_mutex;
+    unsigned int            d_factor;
+    std::vector<level_ring> d_levels;
+};
@@ -0,0 +1,66 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+
+#include "dsp/scope_sink.h"
+#include "interfaces/trace.h"
+
+scope_sink_sptr make_scope_sink(std::shared_ptr<scope_pyramid> pyramid,
+                                bool complex_input)
+{
+    return gnuradio::get_initial_sptr(new scope_sink(pyramid, complex_input));
+}
+
+scope_sink::scope_sink(std::shared_ptr<scope_pyramid> pyramid, bool complex_input)
+    : gr::sync_block("scope_sink",
+          gr::io_signature::make(1, 1, complex_input ? sizeof(gr_complex) : sizeof(float)),
+          gr::io_signature::make(0, 0, 0)),
+      d_pyramid(pyramid),
+      d_complex(complex_input)
+{
+}
+
+int scope_sink::work(int noutput_items,
+                     gr_vector_const_void_star &input_items,
+                     gr_vector_void_star &output_items)
+{
+    (void) output_items;
+    TRACE_SCOPE("scope_sink::work", "dsp");
+
+    if (d_complex)
+    {
+        const gr_complex *in = (const gr_complex *) input_items[0];
+
+        if (d_mag.size() < (size_t)noutput_items)
+            d_mag.resize(noutput_items);
+        volk_32fc_magnitude_32f(d_mag.data(), in, noutput_items);
+        d_pyramid->add(d_mag.data(), noutput_items);
+    }
+    else
+    {
+        d_pyramid->add((const float *) input_items[0], noutput_items);
+    }
+
+    return noutput_items;
+}
@@ -0,0 +1,70 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <gnuradio/sync_block.h>
+
+#include "dsp/scope_pyramid.h"
+
+class scope_sink;
+
+#if GNURADIO_VERSION < 0x030900
+typedef boost::shared_ptr<scope_sink> scope_sink_sptr;
+#else
+typedef std::shared_ptr<scope_sink> scope_sink_sptr;
+#endif
+
+/*! \brief Return a shared_ptr to a new instance of scope_sink.
+ *  \param pyramid The envelope pyramid to fill.
+ *  \param complex_input Whether the input is gr_complex or float.
+ */
+scope_sink_sptr make_scope_sink(std::shared_ptr<scope_pyramid> pyramid,
+                                bool complex_input);
+
+/*! \brief Feed the time domain scope.
+ *  \ingroup DSP
+ *
+ * Float samples are added to the pyramid as they are, complex samples as
+ * their magnitude. Several sinks can share one pyramid as long as only one
+ * of them is connected at a time.
+ */
+class scope_sink : public gr::sync_block
+{
+    friend scope_sink_sptr make_scope_sink(std::shared_ptr<scope_pyramid> pyramid,
+                                           bool complex_input);
+
+protected:
+    scope_sink(std::shared_ptr<scope_pyramid> pyramid, bool complex_input);
+
+public:
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+
+private:
+    std::shared_ptr<scope_pyramid>  d_pyramid;
+    bool                            d_complex;
+    std::vector<float>              d_mag;
+};
@@ -0,0 +1,91 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <gnuradio/io_signature.h>
+
+#include "dsp/snapshot_sink.h"
+#include "interfaces/trace.h"
+
+snapshot_sink_sptr make_snapshot_sink(std::shared_ptr<iq_ring> ring)
+{
+    return gnuradio::get_initial_sptr(new snapshot_sink(ring));
+}
+
+snapshot_sink::snapshot_sink(std::shared_ptr<iq_ring> ring)
+    : gr::sync_block("snapshot_sink",
+          gr::io_signature::make(1, 1, sizeof(gr_complex)),
+          gr::io_signature::make(0, 0, 0)),
+      d_ring(ring),
+      d_rate(0.0),
+      d_rf_freq(0.0),
+      d_offset(0.0)
+{
+}
+
+/*!
+ * \brief Set the metadata used for segments started by a tag.
+ * \param sample_rate The sample rate of the input.
+ * \param rf_freq The RF frequency until the next "rx_freq" tag.
+ * \param offset The input center frequency relative to the RF frequency,
+ *               until the next "ch_offset" tag.
+ */
+void snapshot_sink::set_params(double sample_rate, double rf_freq, double offset)
+{
+    d_rate = sample_rate;
+    d_rf_freq = rf_freq;
+    d_offset = offset;
+}
+
+int snapshot_sink::work(int noutput_items,
+                        gr_vector_const_void_star &input_items,
+                        gr_vector_void_star &output_items)
+{
+    (void) output_items;
+    TRACE_SCOPE("snapshot_sink::work", "dsp");
+
+    const gr_complex *in = (const gr_complex *) input_items[0];
+    uint64_t start = nitems_read(0);
+    int done = 0;
+
+    static const pmt::pmt_t rx_freq_key = pmt::intern("rx_freq");
+    static const pmt::pmt_t ch_offset_key = pmt::intern("ch_offset");
+
+    get_tags_in_range(d_tags, 0, start, start + noutput_items);
+    for (const auto &tag : d_tags)
+    {
+        if (pmt::eq(tag.key, rx_freq_key))
+            d_rf_freq = pmt::to_double(tag.value);
+        else if (pmt::eq(tag.key, ch_offset_key))
+            d_offset = pmt::to_double(tag.value);
+        else
+            continue;
+
+        int pos = (int)(tag.offset - start);
+
+        d_ring->write(in + done, pos - done);
+        d_ring->reset(d_rate, d_rf_freq + d_offset);
+        done = pos;
+    }
+    d_ring->write(in + done, noutput_items - done);
+
+    return noutput_items;
+}
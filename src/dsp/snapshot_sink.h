@@ -0,0 +1,76 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <gnuradio/sync_block.h>
+
+#include "dsp/iq_ring.h"
+
+class snapshot_sink;
+
+#if GNURADIO_VERSION < 0x030900
+typedef boost::shared_ptr<snapshot_sink> snapshot_sink_sptr;
+#else
+typedef std::shared_ptr<snapshot_sink> snapshot_sink_sptr;
+#endif
+
+/*! \brief Return a shared_ptr to a new instance of snapshot_sink.
+ *  \param ring The ring to fill.
+ */
+snapshot_sink_sptr make_snapshot_sink(std::shared_ptr<iq_ring> ring);
+
+/*! \brief Keep the latest I/Q samples in a ring for snapshots.
+ *  \ingroup DSP
+ *
+ * A new ring segment is started at every "rx_freq" stream tag, so samples
+ * already in the receiver when the device is retuned keep the old
+ * frequency. The tag precedes the samples still buffered in the front end,
+ * so the first samples of a segment can be from the old frequency.
+ *
+ * Likewise a "ch_offset" tag from the downconverter starts a segment with
+ * the new channel offset.
+ */
+class snapshot_sink : public gr::sync_block
+{
+    friend snapshot_sink_sptr make_snapshot_sink(std::shared_ptr<iq_ring> ring);
+
+protected:
+    snapshot_sink(std::shared_ptr<iq_ring> ring);
+
+public:
+    void set_params(double sample_rate, double rf_freq, double offset);
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+
+private:
+    std::shared_ptr<iq_ring>    d_ring;
+    std::atomic<double>         d_rate;     /*!< Sample rate for new segments. */
+    std::atomic<double>         d_rf_freq;  /*!< RF frequency of the current segment. */
+    std::atomic<double>         d_offset;   /*!< Offset from the RF frequency. */
+    std::vector<gr::tag_t>      d_tags;
+};
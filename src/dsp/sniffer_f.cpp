@@ -23,6 +23,7 @@
 #include <math.h>
 #include <gnuradio/io_signature.h>
 #include <dsp/sniffer_f.h>
+#include <interfaces/trace.h>
 
 
 /* Return a shared_ptr to a new instance of sniffer_f */
@@ -75,6 +76,7 @@ int sniffer_f::work(int noutput_items,
                     gr_vector_const_void_star &input_items,
                     gr_vector_void_star &output_items)
 {
+    TRACE_SCOPE("sniffer_f::work", "dsp");
     const float *in = (const float *)input_items[0];
 
     (void) output_items;
@@ -38,7 +38,7 @@ stereo_demod_sptr make_stereo_demod(float quad_rate, float audio_rate,
 
 static const int MIN_IN  = 1; /* Minimum number of input streams. */
 static const int MAX_IN  = 1; /* Maximum number of input streams. */
-static const int MIN_OUT = 2; /* Minimum number of output streams. */
+static const int MIN_OUT = 1; /* Minimum number of output streams. */
 static const int MAX_OUT = 2; /* Maximum number of output streams. */
 
 /*! \brief Create stereo demodulator object.
@@ -142,7 +142,6 @@ stereo_demod::stereo_demod(float input_rate, float audio_rate, bool stereo, bool
     connect(lpf0,   0, audio_rr0, 0);
     connect(audio_rr0, 0, deemph0, 0);
     connect(deemph0, 0, self(), 0);
-    connect(deemph0, 0, self(), 1);
   }
 }
 
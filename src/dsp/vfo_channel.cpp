@@ -0,0 +1,375 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <gnuradio/filter/firdes.h>
+#include <volk/volk.h>
+#include "dsp/vfo_channel.h"
+#include "interfaces/trace.h"
+
+#define VFO_MIN_RATE    16000.0     /*!< Lowest channel rate, in Hz. */
+#define VFO_CUTOFF      5000.0      /*!< Channel filter cutoff, in Hz. */
+#define VFO_MAX_STAGE   8           /*!< Largest decimation of one filter stage. */
+#define VFO_FM_MAX_DEV  5000.0      /*!< Narrow FM deviation, in Hz. */
+#define VFO_LEVEL_ALPHA 0.3f        /*!< Level smoothing per chunk. */
+#define VFO_AM_ALPHA    0.05f       /*!< AM carrier smoothing per chunk. */
+#define VFO_QUEUE_SIZE  (256 * 1024)    /*!< About 8 s of audio per channel. */
+#define VFO_WRITE_MS    100
+
+
+vfo_writer::vfo_writer()
+    : d_quit(false)
+{
+    d_thread = std::thread(&vfo_writer::loop, this);
+}
+
+vfo_writer::~vfo_writer()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_quit = true;
+    }
+    d_cv.notify_all();
+    d_thread.join();
+}
+
+void vfo_writer::add(vfo_channel *channel)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_channels.push_back(channel);
+}
+
+/*! \brief Stop draining a channel, waits for a write in progress. */
+void vfo_writer::remove(vfo_channel *channel)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_channels.erase(std::remove(d_channels.begin(), d_channels.end(), channel),
+                     d_channels.end());
+}
+
+void vfo_writer::loop()
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+
+    while (!d_quit)
+    {
+        d_cv.wait_for(lock, std::chrono::milliseconds(VFO_WRITE_MS));
+        for (auto *channel : d_channels)
+            channel->drain();
+    }
+}
+
+
+/*!
+ * \brief Split a decimation into stages of at most VFO_MAX_STAGE, largest first.
+ * \param decim The total decimation.
+ * \param ratios Filled with the stage decimations.
+ * \returns False if decim has a prime factor larger than VFO_MAX_STAGE.
+ */
+static bool plan_stages(int decim, std::vector<int> &ratios)
+{
+    std::vector<int> factors;
+
+    for (int p = VFO_MAX_STAGE; p >= 2; p--)
+    {
+        while (decim % p == 0)
+        {
+            factors.push_back(p);
+            decim /= p;
+        }
+    }
+    if (decim != 1)
+        return false;
+
+    /* combine small factors, e.g. 2 * 3 into one stage of 6 */
+    ratios.clear();
+    for (int f : factors)
+    {
+        if (!ratios.empty() && ratios.back() * f <= VFO_MAX_STAGE)
+            ratios.back() *= f;
+        else
+            ratios.push_back(f);
+    }
+    std::sort(ratios.rbegin(), ratios.rend());
+
+    return true;
+}
+
+
+/*!
+ * \brief Create a channel.
+ * \param input_rate Sample rate of the baseband fed to process().
+ * \param offset Channel frequency relative to the baseband center, in Hz.
+ * \param demod DEMOD_AM or DEMOD_FM.
+ * \param squelch Squelch level in dBFS.
+ * \param writer Writes the recordings of the channel.
+ */
+vfo_channel::vfo_channel(double input_rate, double offset, int demod, float squelch,
+                         std::shared_ptr<vfo_writer> writer)
+    : d_demod(demod),
+      d_input_rate(input_rate),
+      d_output_rate(input_rate),
+      d_offset(offset),
+      d_phase(1.0f, 0.0f),
+      d_last(0.0f, 0.0f),
+      d_carrier(0.0f),
+      d_squelch(squelch),
+      d_level(-150.0f),
+      d_writer(writer),
+      d_queue(VFO_QUEUE_SIZE),
+      d_recorder(file_recorder::FORMAT_WAV, 1, VFO_MIN_RATE),
+      d_recording(false)
+{
+    d_dcr.reset();
+    update_filter();
+}
+
+vfo_channel::~vfo_channel()
+{
+    close_recording();
+}
+
+/*!
+ * \brief Set the baseband sample rate, e.g. after the input decimation changed.
+ *
+ * A recording is stopped if the channel rate changes, since the rate of a
+ * WAV file can not change midway.
+ */
+void vfo_channel::set_input_rate(double input_rate)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    double old_rate = d_output_rate;
+
+    d_input_rate = input_rate;
+    update_filter();
+    if (d_recording && d_output_rate != old_rate)
+    {
+        std::cerr << "vfo_channel: channel rate changed, recording of "
+                  << d_filename << " stopped" << std::endl;
+        stop_recording();
+    }
+}
+
+/*! \brief Set the channel frequency relative to the baseband center. */
+void vfo_channel::set_offset(double offset)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_offset = offset;
+}
+
+void vfo_channel::set_squelch(float level_db)
+{
+    d_squelch = level_db;
+}
+
+/*! \brief Sample rate of the channel and of its recordings. */
+double vfo_channel::output_rate()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_output_rate;
+}
+
+/*!
+ * \brief Record the audio of the channel while the squelch is open.
+ * \param filename The WAV file, rollover segments are not used.
+ * \returns False if the file could not be opened.
+ */
+bool vfo_channel::open_recording(const std::string &filename)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    stop_recording();
+    d_recorder.set_sample_rate(d_output_rate);
+    if (!d_recorder.open(filename))
+        return false;
+
+    d_filename = filename;
+    d_recording = true;
+    d_writer->add(this);
+
+    return true;
+}
+
+void vfo_channel::close_recording()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    stop_recording();
+}
+
+/*! \brief The file being recorded, empty if none. */
+std::string vfo_channel::recording() const
+{
+    return d_recording ? d_filename : std::string();
+}
+
+/*!
+ * \brief Write the queued audio and close the recording.
+ *
+ * Called with d_mutex held, so process() does not queue more audio.
+ */
+void vfo_channel::stop_recording()
+{
+    if (!d_recording)
+        return;
+
+    d_recording = false;
+    d_writer->remove(this);
+    drain();
+    d_recorder.close();
+    d_filename.clear();
+}
+
+/*! \brief Write the queued audio, called by one thread at a time. */
+void vfo_channel::drain()
+{
+    d_queue.drain([this](const int16_t *pcm, int nframes, int channels) {
+        d_recorder.write_frames(pcm, nframes, channels);
+    });
+}
+
+/*!
+ * \brief Plan the decimation and design the filters, called with d_mutex held.
+ *
+ * Each stage only has to keep the aliases of its output rate out of the
+ * channel, so the early stages at the high rates need very few taps.
+ */
+void vfo_channel::update_filter()
+{
+    std::vector<int> ratios;
+    int decim = std::max(1, (int)(d_input_rate / VFO_MIN_RATE));
+
+    /* the output rate may be a little higher to get small stages */
+    while (!plan_stages(decim, ratios))
+        decim--;
+
+    double rate = d_input_rate;
+    d_stages.clear();
+    for (int ratio : ratios)
+    {
+        stage s;
+        double out_rate = rate / ratio;
+
+        s.decim = ratio;
+        s.taps = gr::filter::firdes::low_pass(1.0, rate, VFO_CUTOFF,
+                                              out_rate - 2.0 * VFO_CUTOFF);
+        s.hist.assign(s.taps.size() - 1, gr_complex(0.0f, 0.0f));
+        s.pos = 0;
+        d_stages.push_back(s);
+        rate = out_rate;
+    }
+    d_output_rate = rate;
+}
+
+/*! \brief Decimating FIR, only the outputs that are kept are computed. */
+void vfo_channel::stage::filter(const gr_complex *in, size_t nitems,
+                                std::vector<gr_complex> &out)
+{
+    const size_t ntaps = taps.size();
+
+    hist.insert(hist.end(), in, in + nitems);
+    out.clear();
+    while (pos + ntaps <= hist.size())
+    {
+        gr_complex y;
+        volk_32fc_32f_dot_prod_32fc(&y, &hist[pos], taps.data(), ntaps);
+        out.push_back(y);
+        pos += decim;
+    }
+
+    const size_t used = std::min(pos, hist.size());
+    hist.erase(hist.begin(), hist.begin() + used);
+    pos -= used;
+}
+
+void vfo_channel::process(const std::complex<float> *in, int nitems)
+{
+    TRACE_SCOPE("vfo_channel::process", "dsp");
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    /* move the channel to 0 Hz */
+    const double w = -2.0 * M_PI * d_offset / d_input_rate;
+
+    d_buf[0].resize(nitems);
+    volk_32fc_s32fc_x2_rotator_32fc(d_buf[0].data(), in,
+                                    gr_complex((float)std::cos(w), (float)std::sin(w)),
+                                    &d_phase, nitems);
+
+    int cur = 0;
+    for (auto &s : d_stages)
+    {
+        s.filter(d_buf[cur].data(), d_buf[cur].size(), d_buf[1 - cur]);
+        cur = 1 - cur;
+    }
+
+    std::vector<gr_complex> &filt = d_buf[cur];
+    const int nout = (int)filt.size();
+    if (nout == 0)
+        return;
+
+    float power = 0.0f;
+    for (const auto &y : filt)
+        power += std::norm(y);
+    power = 10.0f * std::log10(power / nout + 1.0e-20f);
+    float level = d_level.load(std::memory_order_relaxed);
+    level += VFO_LEVEL_ALPHA * (power - level);
+    d_level.store(level, std::memory_order_relaxed);
+
+    const gr_complex last = filt[nout - 1];
+    const bool open = level >= d_squelch.load(std::memory_order_relaxed);
+
+    if (!open || !d_recording.load(std::memory_order_relaxed))
+    {
+        d_last = last;
+        return;
+    }
+
+    d_audio.resize(nout);
+    if (d_demod == DEMOD_FM)
+    {
+        /* conjugate products and atan2 as in fm_discriminator_cf, no de-emphasis */
+        const float gain = (float)(d_output_rate / (2.0 * M_PI * VFO_FM_MAX_DEV));
+
+        for (int i = nout - 1; i > 0; i--)
+            filt[i] *= std::conj(filt[i - 1]);
+        filt[0] *= std::conj(d_last);
+        volk_32fc_s32f_atan2_32f(d_audio.data(), filt.data(), 1.0f / gain, nout);
+    }
+    else
+    {
+        /* envelope with DC removal, normalized by the carrier as a simple AGC */
+        float mean = 0.0f;
+
+        volk_32fc_magnitude_32f(d_audio.data(), filt.data(), nout);
+        for (int i = 0; i < nout; i++)
+            mean += d_audio[i];
+        d_carrier += VFO_AM_ALPHA * (mean / nout - d_carrier);
+        d_dcr.process(d_audio.data(), nout);
+        volk_32f_s32f_multiply_32f(d_audio.data(), d_audio.data(),
+                                   0.5f / std::max(d_carrier, 1.0e-6f), nout);
+    }
+    d_last = last;
+
+    const float *ch[1] = { d_audio.data() };
+    d_queue.push(ch, 1, nout, 32767.0f);
+}
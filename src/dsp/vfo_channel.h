@@ -0,0 +1,152 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include <atomic>
+#include <complex>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dsp/demod_kernels.h"
+#include "dsp/vfo_executor.h"
+#include "interfaces/file_recorder.h"
+#include "interfaces/pcm_queue.h"
+
+class vfo_channel;
+
+
+/*! \brief Disk writer shared by the recording VFO channels.
+ *  \ingroup DSP
+ *
+ * The channels queue their audio as 16 bit PCM from the executor workers;
+ * one thread drains all queues into the WAV files every 100 ms, so
+ * the workers never wait for the disk.
+ */
+class vfo_writer
+{
+public:
+    vfo_writer();
+    ~vfo_writer();
+
+    vfo_writer(const vfo_writer &) = delete;
+    vfo_writer &operator=(const vfo_writer &) = delete;
+
+    void add(vfo_channel *channel);
+    void remove(vfo_channel *channel);
+
+private:
+    void loop();
+
+    std::mutex                  d_mutex;    /*!< Protects d_channels, held while writing. */
+    std::condition_variable     d_cv;
+    std::vector<vfo_channel *>  d_channels;
+    bool                        d_quit;
+    std::thread                 d_thread;
+};
+
+
+/*! \brief AM or FM channel demodulated on the VFO executor.
+ *  \ingroup DSP
+ *
+ * Each chunk of baseband runs through the whole channel in one pass: the
+ * VOLK rotator moves the channel to 0 Hz, a chain of short decimating FIR
+ * filters brings it down to 16 ksps or a little more, the level is
+ * measured, and while the squelch is open the demodulated audio is queued
+ * for the WAV recording.
+ *
+ * The settings are changed from the GUI thread and read by the worker
+ * running process(), so both take d_mutex. The level is published as an
+ * atomic so it can be polled without waiting for a chunk.
+ */
+class vfo_channel : public vfo_task
+{
+    friend class vfo_writer;
+
+public:
+    enum demod_type {
+        DEMOD_AM = 0,
+        DEMOD_FM = 1
+    };
+
+    vfo_channel(double input_rate, double offset, int demod, float squelch,
+                std::shared_ptr<vfo_writer> writer);
+    ~vfo_channel();
+
+    void process(const std::complex<float> *in, int nitems);
+
+    void set_input_rate(double input_rate);
+    void set_offset(double offset);
+    void set_squelch(float level_db);
+
+    int    demod() const { return d_demod; }
+    float  squelch() const { return d_squelch.load(); }
+    float  level() const { return d_level.load(); }
+    double output_rate();
+
+    bool open_recording(const std::string &filename);
+    void close_recording();
+    std::string recording() const;
+
+private:
+    /*! \brief One decimating FIR stage. */
+    struct stage
+    {
+        int                     decim;
+        std::vector<float>      taps;
+        std::vector<gr_complex> hist;   /*!< Input not consumed yet. */
+        size_t                  pos;    /*!< Position of the next output in hist. */
+
+        void filter(const gr_complex *in, size_t nitems, std::vector<gr_complex> &out);
+    };
+
+    void update_filter();
+    void stop_recording();
+    void drain();
+
+    std::mutex  d_mutex;
+    const int   d_demod;
+    double      d_input_rate;
+    double      d_output_rate;
+    double      d_offset;       /*!< Channel frequency relative to the input center. */
+    std::vector<stage>      d_stages;
+    std::vector<gr_complex> d_buf[2];   /*!< Input and output of the current stage. */
+    std::vector<float>      d_audio;
+    gr_complex  d_phase;        /*!< Rotator state. */
+
+    gr_complex  d_last;         /*!< FM: last channel sample of the previous chunk. */
+    dcr_state   d_dcr;          /*!< AM: DC removal. */
+    float       d_carrier;      /*!< AM: average carrier magnitude. */
+
+    std::atomic<float>  d_squelch;  /*!< Squelch level in dBFS. */
+    std::atomic<float>  d_level;    /*!< Smoothed channel power in dBFS. */
+
+    std::shared_ptr<vfo_writer> d_writer;
+    pcm_queue           d_queue;        /*!< Audio waiting for d_writer. */
+    file_recorder       d_recorder;     /*!< Written by d_writer only while recording. */
+    std::atomic<bool>   d_recording;
+    std::string         d_filename;
+};
@@ -0,0 +1,194 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <exception>
+#include <iostream>
+#include "dsp/vfo_executor.h"
+
+
+vfo_executor::vfo_executor(unsigned int nthreads)
+    : d_queued(0),
+      d_quit(false)
+{
+    if (nthreads == 0)
+    {
+        unsigned int hw = std::thread::hardware_concurrency();
+        nthreads = (hw > 1) ? hw - 1 : 1;
+    }
+
+    d_workers.reserve(nthreads);
+    for (unsigned int i = 0; i < nthreads; i++)
+        d_workers.push_back(std::unique_ptr<worker>(new worker()));
+
+    /* start the threads only after all deques exist since they steal from each other */
+    for (unsigned int i = 0; i < nthreads; i++)
+        d_workers[i]->thread = std::thread(&vfo_executor::worker_loop, this, i);
+}
+
+vfo_executor::~vfo_executor()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_wait_mutex);
+        d_quit = true;
+    }
+    d_work_cv.notify_all();
+
+    for (auto &w : d_workers)
+        w->thread.join();
+}
+
+/*! \brief Run channels on a chunk of samples.
+ *  \param tasks The channels, each one gets the whole chunk.
+ *  \param in Pointer to the input samples.
+ *  \param nitems The number of samples in the chunk.
+ *
+ * One job per channel is queued and the function returns once all of them
+ * have completed, so the input buffer only needs to be valid for the duration
+ * of the call. The calling thread steals jobs too instead of sleeping.
+ *
+ * Calls from different threads may overlap as long as they do not share a
+ * task; their jobs are mixed in the same deques.
+ */
+void vfo_executor::process(const std::vector<std::shared_ptr<vfo_task>> &tasks,
+                           const std::complex<float> *in, int nitems)
+{
+    size_t njobs = tasks.size();
+    if (njobs == 0 || nitems <= 0)
+        return;
+
+    std::atomic<size_t> pending(njobs);
+
+    /* count the jobs first, a worker may pop one as soon as it is pushed */
+    {
+        std::lock_guard<std::mutex> lock(d_wait_mutex);
+        d_queued.fetch_add(njobs);
+    }
+
+    /* same channel -> same worker for every chunk unless it gets stolen */
+    size_t nworkers = d_workers.size();
+    for (size_t i = 0; i < njobs; i++)
+    {
+        worker &w = *d_workers[i % nworkers];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.queue.push_back(job{tasks[i].get(), in, nitems, &pending});
+    }
+    d_work_cv.notify_all();
+
+    job j;
+    while (pending.load() > 0)
+    {
+        if (steal_job((unsigned int)nworkers, j))
+        {
+            run_job(j);
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(d_done_mutex);
+            d_done_cv.wait(lock, [&pending] { return pending.load() == 0; });
+        }
+    }
+}
+
+void vfo_executor::worker_loop(unsigned int id)
+{
+    job j;
+
+    while (true)
+    {
+        if (pop_job(id, j) || steal_job(id, j))
+        {
+            run_job(j);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(d_wait_mutex);
+        d_work_cv.wait(lock, [this] { return d_quit || d_queued.load() > 0; });
+        if (d_quit)
+            return;
+    }
+}
+
+/*! \brief Take the most recently queued job from the worker's own deque. */
+bool vfo_executor::pop_job(unsigned int id, job &j)
+{
+    worker &w = *d_workers[id];
+    std::lock_guard<std::mutex> lock(w.mutex);
+
+    if (w.queue.empty())
+        return false;
+
+    j = w.queue.back();
+    w.queue.pop_back();
+    d_queued.fetch_sub(1);
+
+    return true;
+}
+
+/*! \brief Take the oldest job from another worker's deque.
+ *  \param id The thief. Pass num_threads() for a non-worker thread.
+ *
+ * A feeder thread may steal a job of another call, which only delays its
+ * own return by one channel.
+ */
+bool vfo_executor::steal_job(unsigned int id, job &j)
+{
+    unsigned int nworkers = (unsigned int)d_workers.size();
+
+    for (unsigned int i = 1; i <= nworkers; i++)
+    {
+        unsigned int victim = (id + i) % nworkers;
+        if (victim == id)
+            continue;
+
+        worker &w = *d_workers[victim];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (w.queue.empty())
+            continue;
+
+        j = w.queue.front();
+        w.queue.pop_front();
+        d_queued.fetch_sub(1);
+
+        return true;
+    }
+
+    return false;
+}
+
+void vfo_executor::run_job(const job &j)
+{
+    try
+    {
+        j.task->process(j.in, j.nitems);
+    }
+    catch (std::exception &x)
+    {
+        std::cerr << "vfo_executor: channel task failed: " << x.what() << std::endl;
+    }
+
+    /* the caller may return, and its counter go away, right after this */
+    if (j.pending->fetch_sub(1) == 1)
+    {
+        std::lock_guard<std::mutex> lock(d_done_mutex);
+        d_done_cv.notify_all();
+    }
+}
@@ -0,0 +1,122 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include <atomic>
+#include <complex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/*! \brief A narrowband channel processed by the VFO executor.
+ *  \ingroup DSP
+ *
+ * Each VFO implements process(), which takes one chunk of samples from the
+ * shared channelizer / downconverter output and runs the complete channel
+ * chain (filter, demodulator, meter, ...) on it.
+ *
+ * process() is never called concurrently for the same task, and chunks are
+ * delivered in stream order, so implementations can keep state in plain
+ * members without locking.
+ */
+class vfo_task
+{
+public:
+    virtual ~vfo_task() = default;
+
+    virtual void process(const std::complex<float> *in, int nitems) = 0;
+};
+
+
+/*! \brief Fixed size worker pool running VFO channels with work stealing.
+ *  \ingroup DSP
+ *
+ * Instead of giving every block in every channel its own thread, each
+ * channel is a single task that processes a chunk end to end. For every
+ * chunk one task per channel is pushed onto the per-worker deques. A worker
+ * takes tasks from the back of its own deque and steals from the front of
+ * the others when it runs dry, so the load is spread evenly over the cores
+ * while the number of threads stays constant regardless of channel count.
+ *
+ * Channels are assigned to the same worker for every chunk as long as no
+ * stealing occurs, which keeps the channel state warm in that core's cache.
+ *
+ * The executor does not own the channels. Several feeders, e.g. the
+ * vfo_sink_c of each input source, can call process() at the same time with
+ * their own channel lists and share the one pool.
+ */
+class vfo_executor
+{
+public:
+    /*! \brief Create a new executor.
+     *  \param nthreads Number of worker threads. 0 selects one less than the
+     *                  number of hardware threads, since the caller of
+     *                  process() takes part in the work as well.
+     */
+    explicit vfo_executor(unsigned int nthreads = 0);
+    ~vfo_executor();
+
+    vfo_executor(const vfo_executor &) = delete;
+    vfo_executor &operator=(const vfo_executor &) = delete;
+
+    unsigned int num_threads() const { return (unsigned int)d_workers.size(); }
+
+    void process(const std::vector<std::shared_ptr<vfo_task>> &tasks,
+                 const std::complex<float> *in, int nitems);
+
+private:
+    /*! \brief One channel's share of a process() call. */
+    struct job
+    {
+        vfo_task                   *task;
+        const std::complex<float>  *in;
+        int                         nitems;
+        std::atomic<size_t>        *pending;   /*!< Jobs of the call not yet completed. */
+    };
+
+    struct worker
+    {
+        std::mutex              mutex;
+        std::deque<job>         queue;
+        std::thread             thread;
+    };
+
+    void worker_loop(unsigned int id);
+    bool pop_job(unsigned int id, job &j);
+    bool steal_job(unsigned int id, job &j);
+    void run_job(const job &j);
+
+    std::vector<std::unique_ptr<worker>>    d_workers;
+
+    std::atomic<size_t>     d_queued;           /*!< Jobs sitting in the worker deques. */
+    bool                    d_quit;
+
+    std::mutex              d_wait_mutex;
+    std::condition_variable d_work_cv;          /*!< Signalled when new jobs are queued. */
+    std::mutex              d_done_mutex;
+    std::condition_variable d_done_cv;          /*!< Signalled when the last job of a call completes. */
+};
@@ -0,0 +1,96 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/gr_complex.h>
+#include "dsp/vfo_sink_c.h"
+#include "interfaces/trace.h"
+
+
+vfo_sink_c_sptr make_vfo_sink_c(std::shared_ptr<vfo_executor> executor,
+                                int chunk_size)
+{
+    return gnuradio::get_initial_sptr(new vfo_sink_c(executor, chunk_size));
+}
+
+vfo_sink_c::vfo_sink_c(std::shared_ptr<vfo_executor> executor, int chunk_size)
+    : gr::sync_block ("vfo_sink_c",
+          gr::io_signature::make(1, 1, sizeof(gr_complex)),
+          gr::io_signature::make(0, 0, 0)),
+      d_executor(executor),
+      d_chunk_size(std::max(chunk_size, 1))
+{
+}
+
+vfo_sink_c::~vfo_sink_c()
+{
+}
+
+int vfo_sink_c::work(int noutput_items,
+                     gr_vector_const_void_star &input_items,
+                     gr_vector_void_star &output_items)
+{
+    TRACE_SCOPE("vfo_sink_c::work", "dsp");
+    const gr_complex *in = (const gr_complex *)input_items[0];
+
+    (void) output_items;
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    for (int i = 0; i < noutput_items; i += d_chunk_size)
+        d_executor->process(d_channels, in + i, std::min(d_chunk_size, noutput_items - i));
+
+    return noutput_items;
+}
+
+/*! \brief Add a channel.
+ *
+ * The channel will receive every sample after the chunk in progress, the
+ * call blocks until that chunk is done.
+ */
+void vfo_sink_c::add_channel(std::shared_ptr<vfo_task> task)
+{
+    if (!task)
+        return;
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_channels.push_back(std::move(task));
+}
+
+/*! \brief Remove a channel.
+ *
+ * When this function returns the task is guaranteed not to be running and
+ * will not be called again.
+ */
+void vfo_sink_c::remove_channel(const std::shared_ptr<vfo_task> &task)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_channels.erase(std::remove(d_channels.begin(), d_channels.end(), task),
+                     d_channels.end());
+}
+
+size_t vfo_sink_c::num_channels()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_channels.size();
+}
@@ -0,0 +1,82 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <gnuradio/sync_block.h>
+#include "dsp/vfo_executor.h"
+
+class vfo_sink_c;
+
+#if GNURADIO_VERSION < 0x030900
+typedef boost::shared_ptr<vfo_sink_c> vfo_sink_c_sptr;
+#else
+typedef std::shared_ptr<vfo_sink_c> vfo_sink_c_sptr;
+#endif
+
+/*! \brief Return a shared_ptr to a new instance of vfo_sink_c.
+ *  \param executor The executor running the channels.
+ *  \param chunk_size Maximum number of samples handed to the channels at once.
+ */
+vfo_sink_c_sptr make_vfo_sink_c(std::shared_ptr<vfo_executor> executor,
+                                int chunk_size = 8192);
+
+/*! \brief Flow graph sink feeding a VFO executor.
+ *  \ingroup DSP
+ *
+ * Connect this block to the output of the shared channelizer or
+ * downconverter. Every work() call is split into chunks of at most
+ * chunk_size samples and each chunk is run through all channels added to
+ * this block. Only this block occupies a GNU Radio thread; the channel
+ * processing happens on the executor's fixed worker pool, which may be
+ * shared with the sinks of other flow graphs.
+ */
+class vfo_sink_c : public gr::sync_block
+{
+    friend vfo_sink_c_sptr make_vfo_sink_c(std::shared_ptr<vfo_executor> executor,
+                                           int chunk_size);
+
+protected:
+    vfo_sink_c(std::shared_ptr<vfo_executor> executor, int chunk_size);
+
+public:
+    ~vfo_sink_c();
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+
+    void add_channel(std::shared_ptr<vfo_task> task);
+    void remove_channel(const std::shared_ptr<vfo_task> &task);
+    size_t num_channels();
+
+    std::shared_ptr<vfo_executor> executor() const { return d_executor; }
+
+private:
+    std::shared_ptr<vfo_executor> d_executor;
+    std::vector<std::shared_ptr<vfo_task>> d_channels;
+    std::mutex d_mutex; /*!< Protects d_channels, held while a chunk is processed. */
+    int d_chunk_size;   /*!< Upper limit on samples per task, keeps channel buffers in cache. */
+};
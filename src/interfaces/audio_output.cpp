@@ -0,0 +1,261 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <iostream>
+#include <QHostAddress>
+#include <QHostInfo>
+#include <QUdpSocket>
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include "interfaces/audio_output.h"
+#include "interfaces/trace.h"
+
+#define QUEUE_SIZE  (1024 * 1024)   /*!< About 5 s of 48 kHz stereo per queue. */
+
+// nc is used widely for receiving UDP streams and some versions of nc,
+// notably on MacOS, use a 1024 byte buffer so we need to make sure we
+// don't send packets that are larger than that, otherwise data will be
+// lost.
+static const int PAYLOAD_SIZE = 1024;
+
+audio_output_sptr make_audio_output(rx_fft_f_sptr fft, file_recorder_ptr recorder)
+{
+    return gnuradio::get_initial_sptr(new audio_output(fft, recorder));
+}
+
+audio_output::audio_output(rx_fft_f_sptr fft, file_recorder_ptr recorder)
+    : gr::sync_block ("audio_output",
+          gr::io_signature::make(1, 2, sizeof(float)),
+          gr::io_signature::make(1, 2, sizeof(float))),
+      d_fft(fft),
+      d_recorder(recorder),
+      d_udp_stereo(false),
+      d_rec_queue(QUEUE_SIZE),
+      d_udp_queue(QUEUE_SIZE),
+      d_udp_port(0),
+      d_udp_serial(0),
+      d_quit(false)
+{
+    for (int i = 0; i < OUTPUT_NUM; i++)
+    {
+        d_gain[i] = 1.0f;
+        d_enabled[i] = (i != OUTPUT_UDP);
+    }
+
+    d_rec_thread = std::thread(&audio_output::recorder_loop, this);
+    d_udp_thread = std::thread(&audio_output::udp_loop, this);
+}
+
+audio_output::~audio_output()
+{
+    d_quit = true;
+    d_rec_queue.wake();
+    d_udp_queue.wake();
+    d_rec_thread.join();
+    d_udp_thread.join();
+}
+
+/*! \brief Require one device output per input channel. */
+bool audio_output::check_topology(int ninputs, int noutputs)
+{
+    return ninputs == noutputs;
+}
+
+int audio_output::work(int noutput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items)
+{
+    TRACE_SCOPE("audio_output::work", "dsp");
+    const int channels = (int)input_items.size();
+    const float *in[2] = { (const float *)input_items[0],
+                           (const float *)input_items[channels - 1] };
+
+    float gain = d_enabled[OUTPUT_DEVICE].load(std::memory_order_relaxed) ?
+                 d_gain[OUTPUT_DEVICE].load(std::memory_order_relaxed) : 0.0f;
+    for (int ch = 0; ch < channels; ch++)
+        volk_32f_s32f_multiply_32f((float *)output_items[ch], in[ch], gain, noutput_items);
+
+    if (d_fft && d_enabled[OUTPUT_SPECTRUM].load(std::memory_order_relaxed))
+        d_fft->add_samples(in[0], noutput_items);
+
+    if (d_recorder && d_recorder->is_recording() &&
+        d_enabled[OUTPUT_RECORDER].load(std::memory_order_relaxed))
+    {
+        gain = d_gain[OUTPUT_RECORDER].load(std::memory_order_relaxed);
+        d_rec_queue.push(in, channels, noutput_items, gain * 32767.0f);
+    }
+
+    if (d_enabled[OUTPUT_UDP].load(std::memory_order_relaxed))
+    {
+        /* the stream format is chosen by the client, not by the source */
+        int udp_channels = d_udp_stereo.load(std::memory_order_relaxed) ? 2 : 1;
+        gain = d_gain[OUTPUT_UDP].load(std::memory_order_relaxed);
+        d_udp_queue.push(in, udp_channels, noutput_items, gain * 32767.0f);
+    }
+
+    return noutput_items;
+}
+
+/*! \brief Set the linear gain of an output.
+ *
+ * The spectrum output always receives the unscaled input.
+ */
+void audio_output::set_gain(int output, float gain)
+{
+    if (output >= 0 && output < OUTPUT_NUM)
+        d_gain[output] = gain;
+}
+
+/*! \brief Enable or disable an output. Takes effect at the next work() call.
+ *
+ * A disabled device output is fed with silence so the sink keeps pacing the
+ * flow graph. The recorder output additionally requires the recorder to be
+ * open.
+ */
+void audio_output::set_enabled(int output, bool enabled)
+{
+    if (output >= 0 && output < OUTPUT_NUM)
+        d_enabled[output] = enabled;
+}
+
+bool audio_output::is_enabled(int output) const
+{
+    return output >= 0 && output < OUTPUT_NUM && d_enabled[output].load();
+}
+
+/*! \brief Wait until the recorder has written everything queued so far.
+ *
+ * Call this before closing the recorder so the end of the recording is not
+ * lost.
+ */
+bool audio_output::flush_recorder()
+{
+    return d_rec_queue.flush(std::chrono::milliseconds(500));
+}
+
+/*! \brief Start streaming through UDP
+ *  \param host The hostname or IP address of the client.
+ *  \param port The port used for the UDP stream
+ *  \param stereo Select mono or stereo streaming
+ */
+void audio_output::start_udp(const std::string &host, int port, bool stereo)
+{
+    std::cout << "Starting UDP streaming, Host: " << host;
+    std::cout << ", Port: " << std::to_string(port) << ", ";
+    std::cout << (stereo ? "Stereo" : "Mono") << std::endl;
+
+    {
+        std::lock_guard<std::mutex> lock(d_udp_mutex);
+        d_udp_host = host;
+        d_udp_port = port;
+        d_udp_serial++;
+    }
+    d_udp_stereo = stereo;
+    d_enabled[OUTPUT_UDP] = true;
+}
+
+void audio_output::stop_udp()
+{
+    d_enabled[OUTPUT_UDP] = false;
+
+    std::cout << "Disconnected UDP streaming" << std::endl;
+}
+
+void audio_output::recorder_loop()
+{
+    auto writer = [this](const int16_t *pcm, int nframes, int channels) {
+        d_recorder->write_frames(pcm, nframes, channels);
+    };
+
+    while (!d_quit)
+    {
+        /* nothing is queued without a recorder */
+        d_rec_queue.wait(std::chrono::milliseconds(100));
+        d_rec_queue.drain(writer);
+    }
+}
+
+/*! \brief UDP sender thread.
+ *
+ * The socket is created, used and destroyed in this thread only. Host names
+ * are resolved here too, so a slow DNS lookup does not stall the GUI or the
+ * audio.
+ */
+void audio_output::udp_loop()
+{
+    QUdpSocket   socket;
+    QHostAddress address;
+    quint16      port = 0;
+    unsigned int serial = 0;
+
+    auto writer = [&](const int16_t *pcm, int nframes, int channels) {
+        if (address.isNull())
+            return;
+
+        const int frames_per_packet = PAYLOAD_SIZE / (int)(sizeof(int16_t) * channels);
+        for (int offset = 0; offset < nframes; offset += frames_per_packet)
+        {
+            int n = std::min(frames_per_packet, nframes - offset);
+            socket.writeDatagram((const char *)(pcm + (size_t)offset * channels),
+                                 (qint64)sizeof(int16_t) * n * channels, address, port);
+        }
+    };
+
+    while (!d_quit)
+    {
+        d_udp_queue.wait(std::chrono::milliseconds(100));
+
+        std::string host;
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(d_udp_mutex);
+            if (serial != d_udp_serial)
+            {
+                serial = d_udp_serial;
+                host = d_udp_host;
+                port = (quint16)d_udp_port;
+                changed = true;
+            }
+        }
+        if (changed)
+        {
+            address = QHostAddress(QString::fromStdString(host));
+            if (address.isNull())
+            {
+                /* prefer IPv4, which is what most clients listen on */
+                QHostInfo info = QHostInfo::fromName(QString::fromStdString(host));
+                for (const QHostAddress &a : info.addresses())
+                {
+                    if (address.isNull() || a.protocol() == QAbstractSocket::IPv4Protocol)
+                        address = a;
+                    if (a.protocol() == QAbstractSocket::IPv4Protocol)
+                        break;
+                }
+                if (address.isNull())
+                    std::cerr << "audio_output: can not resolve " << host << std::endl;
+            }
+        }
+
+        d_udp_queue.drain(writer);
+    }
+}
@@ -0,0 +1,130 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef AUDIO_OUTPUT_H
+#define AUDIO_OUTPUT_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <gnuradio/sync_block.h>
+#include "dsp/rx_fft.h"
+#include "interfaces/file_recorder.h"
+#include "interfaces/pcm_queue.h"
+
+
+class audio_output;
+
+#if GNURADIO_VERSION < 0x030900
+typedef boost::shared_ptr<audio_output> audio_output_sptr;
+#else
+typedef std::shared_ptr<audio_output> audio_output_sptr;
+#endif
+
+
+/*! \brief Return a shared_ptr to a new instance of audio_output.
+ *  \param fft Audio FFT fed with the left channel, may be null.
+ *  \param recorder WAV recorder, may be null.
+ */
+audio_output_sptr make_audio_output(rx_fft_f_sptr fft, file_recorder_ptr recorder);
+
+
+/*! \brief Audio output stage.
+ *  \ingroup IO
+ *
+ * Single block between the audio source (demodulator or WAV playback) and
+ * the output device. Every work() call makes one pass over the input per
+ * output:
+ *
+ *  - device: gain applied into the block outputs, which feed the audio sink
+ *    that paces the flow graph.
+ *  - spectrum: left channel copied into the audio FFT buffer.
+ *  - recorder: gain and 16 bit conversion into a pcm_queue drained to the
+ *    WAV recorder by a writer thread.
+ *  - UDP: 16 bit conversion into a pcm_queue drained to a UDP socket by a
+ *    sender thread.
+ *
+ * Outputs are switched with atomic flags, so enabling or disabling one never
+ * touches the flow graph. The number of inputs (1 or 2) must match the
+ * number of connected outputs.
+ */
+class audio_output : public gr::sync_block
+{
+    friend audio_output_sptr make_audio_output(rx_fft_f_sptr fft, file_recorder_ptr recorder);
+
+public:
+    enum output_id {
+        OUTPUT_DEVICE   = 0,
+        OUTPUT_SPECTRUM = 1,
+        OUTPUT_RECORDER = 2,
+        OUTPUT_UDP      = 3,
+        OUTPUT_NUM      = 4
+    };
+
+protected:
+    audio_output(rx_fft_f_sptr fft, file_recorder_ptr recorder);
+
+public:
+    ~audio_output();
+
+    bool check_topology(int ninputs, int noutputs);
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+
+    void set_gain(int output, float gain);
+    void set_enabled(int output, bool enabled);
+    bool is_enabled(int output) const;
+
+    bool flush_recorder();
+    unsigned int recorder_dropped() const { return d_rec_queue.dropped(); }
+
+    void start_udp(const std::string &host, int port, bool stereo);
+    void stop_udp();
+
+private:
+    void recorder_loop();
+    void udp_loop();
+
+    rx_fft_f_sptr           d_fft;
+    file_recorder_ptr      d_recorder;
+
+    std::atomic<float>      d_gain[OUTPUT_NUM];
+    std::atomic<bool>       d_enabled[OUTPUT_NUM];
+    std::atomic<bool>       d_udp_stereo;
+
+    pcm_queue               d_rec_queue;
+    pcm_queue               d_udp_queue;
+
+    std::mutex              d_udp_mutex;    /*!< Protects the destination below. */
+    std::string             d_udp_host;
+    int                     d_udp_port;
+    unsigned int            d_udp_serial;   /*!< Bumped when the destination changes. */
+
+    std::atomic<bool>       d_quit;
+    std::thread             d_rec_thread;
+    std::thread             d_udp_thread;
+};
+
+#endif // AUDIO_OUTPUT_H
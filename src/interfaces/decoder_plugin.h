@@ -0,0 +1,121 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef DECODER_PLUGIN_H
+#define DECODER_PLUGIN_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Decoder plugin interface.
+ *
+ * A decoder plugin is a shared library exporting the two C functions
+ * declared at the end of this file. Gqrx loads it, asks which stream it
+ * wants at which sample rate, and calls process() with blocks of samples
+ * from a pool of worker threads. The calls for one plugin never overlap and
+ * arrive in stream order, but they may come from different threads. Blocks
+ * are shared between all plugins of the same stream and rate and are only
+ * valid during the call.
+ *
+ * Decoded data is handed back with decoder_host::publish(), which may be
+ * called from any thread. Gqrx logs the events and makes them available to
+ * remote control clients (DECODER EVENTS).
+ *
+ * This header only depends on the C++ standard library, and the plugin
+ * must be built with a compiler ABI compatible to the one gqrx was built
+ * with. GQRX_DECODER_API_VERSION is bumped whenever the interface changes.
+ */
+#define GQRX_DECODER_API_VERSION 1
+
+/*! \brief Signal a decoder subscribes to. */
+enum decoder_stream {
+    DECODER_STREAM_AUDIO    = 0,  /*!< Demodulator output, float, first channel. */
+    DECODER_STREAM_BASEBAND = 1,  /*!< Input after decimation, interleaved float I/Q. */
+    DECODER_STREAM_CHANNEL  = 2   /*!< Down-converted channel, interleaved float I/Q. */
+};
+
+/*! \brief A block of samples delivered to decoder_plugin::process(). */
+struct decoder_block
+{
+    const float    *samples;      /*!< count values, or count I/Q pairs. */
+    size_t          count;        /*!< Number of samples. */
+    uint64_t        offset;       /*!< Index of the first sample in the stream. */
+    double          sample_rate;  /*!< Rate of the block, may change between blocks. */
+    uint64_t        dropped;      /*!< Blocks lost since the previous call because
+                                       the plugin did not keep up. */
+};
+
+/*! \brief Services gqrx offers to a plugin. */
+class decoder_host
+{
+public:
+    /*! \brief Publish a decoded event.
+     *  \param type Short event type without spaces, e.g. "pocsag".
+     *  \param text Decoded text, one line.
+     */
+    virtual void publish(const char *type, const char *text) = 0;
+
+protected:
+    ~decoder_host() {}
+};
+
+/*! \brief Interface implemented by a decoder plugin. */
+class decoder_plugin
+{
+public:
+    virtual ~decoder_plugin() {}
+
+    /*! \brief Short name shown to the user. */
+    virtual const char *name() const = 0;
+
+    /*! \brief The stream to deliver. */
+    virtual decoder_stream stream() const = 0;
+
+    /*! \brief Wanted sample rate in Hz, 0 for the rate of the stream. */
+    virtual double sample_rate() const = 0;
+
+    /*! \brief Prepare for process().
+     *  \param host Valid until stop() returns.
+     *  \param sample_rate The rate of the first blocks.
+     *  \returns false to refuse loading.
+     */
+    virtual bool start(decoder_host *host, double sample_rate) = 0;
+
+    /*! \brief Decode a block of samples. Must not block for long. */
+    virtual void process(const decoder_block &block) = 0;
+
+    /*! \brief No more process() calls will follow. */
+    virtual void stop() = 0;
+};
+
+typedef decoder_plugin *(*decoder_create_fn)(int api_version);
+typedef void (*decoder_destroy_fn)(decoder_plugin *plugin);
+
+extern "C" {
+    /*! \brief Create a plugin instance, nullptr if api_version is not supported. */
+    decoder_plugin *gqrx_decoder_create(int api_version);
+    /*! \brief Destroy an instance created by gqrx_decoder_create(). */
+    void gqrx_decoder_destroy(decoder_plugin *plugin);
+}
+
+#endif // DECODER_PLUGIN_H
@@ -0,0 +1,273 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <chrono>
+
+#include "interfaces/decoder_pool.h"
+
+#define MAX_QUEUED_BLOCKS   64      /* per plugin */
+#define MAX_FREE_BUFFERS    64
+#define MAX_EVENTS          1024
+
+/*! \brief A loaded plugin and its queue. */
+class decoder_pool::entry : public decoder_host
+{
+public:
+    decoder_pool               *pool;
+    int                         id;
+    decoder_plugin             *plugin;
+    decoder_destroy_fn          destroy;
+    int                         stream;
+    double                      rate;       /*!< Requested rate, 0 for native. */
+    std::string                 name;
+    std::deque<std::pair<buffer_sptr, uint64_t>> queue; /*!< Blocks and drops before each. */
+    uint64_t                    dropped{0}; /*!< Blocks dropped since the last queued one. */
+    bool                        queued{false};
+    bool                        busy{false};
+    bool                        removing{false};
+
+    void publish(const char *type, const char *text)
+    {
+        pool->publish(this, type, text);
+    }
+};
+
+/*!
+ * \brief Create the pool.
+ * \param threads Number of worker threads, 0 for half the CPU cores (1 to 4).
+ */
+decoder_pool::decoder_pool(unsigned int threads)
+    : d_quit(false),
+      d_next_id(1),
+      d_free(std::make_shared<free_list>())
+{
+    if (threads == 0)
+        threads = std::min(std::max(std::thread::hardware_concurrency() / 2, 1u), 4u);
+
+    for (unsigned int i = 0; i < threads; i++)
+        d_threads.emplace_back(&decoder_pool::worker, this);
+}
+
+decoder_pool::~decoder_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_quit = true;
+    }
+    d_ready_cv.notify_all();
+    for (auto &t : d_threads)
+        t.join();
+
+    for (auto &e : d_entries)
+    {
+        e->plugin->stop();
+        e->destroy(e->plugin);
+    }
+}
+
+/*!
+ * \brief Start a plugin and subscribe it to its stream.
+ * \param plugin The plugin, owned by the pool on success.
+ * \param destroy Called to destroy the plugin when it is removed.
+ * \param sample_rate The rate of the first blocks.
+ * \returns The id of the plugin, -1 if it refused to start.
+ */
+int decoder_pool::add(decoder_plugin *plugin, decoder_destroy_fn destroy, double sample_rate)
+{
+    std::unique_ptr<entry> e(new entry);
+
+    e->pool = this;
+    e->plugin = plugin;
+    e->destroy = destroy;
+    e->stream = plugin->stream();
+    e->rate = plugin->sample_rate();
+    e->name = plugin->name();
+
+    if (!plugin->start(e.get(), sample_rate))
+        return -1;
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+    e->id = d_next_id++;
+    d_entries.push_back(std::move(e));
+
+    return d_entries.back()->id;
+}
+
+/*!
+ * \brief Stop and destroy a plugin.
+ *
+ * Waits for a running process() call of the plugin to return.
+ */
+bool decoder_pool::remove(int id)
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    auto match = [id](const std::unique_ptr<entry> &e) { return e->id == id; };
+    auto it = std::find_if(d_entries.begin(), d_entries.end(), match);
+
+    if (it == d_entries.end())
+        return false;
+
+    entry *e = it->get();
+    e->removing = true;
+    e->queue.clear();
+    d_ready.erase(std::remove(d_ready.begin(), d_ready.end(), e), d_ready.end());
+    d_idle_cv.wait(lock, [e] { return !e->busy; });
+
+    // d_entries may have changed while waiting
+    it = std::find_if(d_entries.begin(), d_entries.end(), match);
+    std::unique_ptr<entry> removed = std::move(*it);
+    d_entries.erase(it);
+    lock.unlock();
+
+    removed->plugin->stop();
+    removed->destroy(removed->plugin);
+
+    return true;
+}
+
+/*! \brief Get a buffer for at least the given number of floats. */
+decoder_pool::buffer_sptr decoder_pool::get_buffer(size_t values)
+{
+    std::shared_ptr<free_list> fl = d_free;
+    buffer *buf = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(fl->mutex);
+        if (!fl->buffers.empty())
+        {
+            buf = fl->buffers.back().release();
+            fl->buffers.pop_back();
+        }
+    }
+    if (!buf)
+        buf = new buffer;
+    buf->data.resize(values);
+
+    return buffer_sptr(buf, [fl](buffer *b) {
+        std::lock_guard<std::mutex> lock(fl->mutex);
+        if (fl->buffers.size() < MAX_FREE_BUFFERS)
+            fl->buffers.emplace_back(b);
+        else
+            delete b;
+    });
+}
+
+/*! \brief Queue a block for the plugins subscribed to a stream and rate. */
+void decoder_pool::deliver(int stream, double rate, buffer_sptr buf)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    for (auto &e : d_entries)
+    {
+        if (e->stream != stream || e->rate != rate || e->removing)
+            continue;
+
+        if (e->queue.size() >= MAX_QUEUED_BLOCKS)
+        {
+            e->dropped++;
+            continue;
+        }
+
+        e->queue.emplace_back(buf, e->dropped);
+        e->dropped = 0;
+        if (!e->queued && !e->busy)
+        {
+            e->queued = true;
+            d_ready.push_back(e.get());
+            d_ready_cv.notify_one();
+        }
+    }
+}
+
+/*! \brief Get the oldest event not read yet. */
+bool decoder_pool::get_event(event &ev)
+{
+    std::lock_guard<std::mutex> lock(d_event_mutex);
+
+    if (d_events.empty())
+        return false;
+
+    ev = std::move(d_events.front());
+    d_events.pop_front();
+
+    return true;
+}
+
+void decoder_pool::publish(entry *e, const char *type, const char *text)
+{
+    event ev;
+
+    ev.id = e->id;
+    ev.name = e->name;
+    ev.type = type ? type : "";
+    ev.text = text ? text : "";
+    ev.time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::lock_guard<std::mutex> lock(d_event_mutex);
+    if (d_events.size() >= MAX_EVENTS)
+        d_events.pop_front();
+    d_events.push_back(std::move(ev));
+}
+
+void decoder_pool::worker()
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+
+    while (true)
+    {
+        d_ready_cv.wait(lock, [this] { return d_quit || !d_ready.empty(); });
+        if (d_quit)
+            break;
+
+        entry *e = d_ready.front();
+        d_ready.pop_front();
+        e->queued = false;
+        if (e->queue.empty())
+            continue;
+
+        buffer_sptr buf = std::move(e->queue.front().first);
+        decoder_block block;
+        block.samples = buf->data.data();
+        block.count = buf->count;
+        block.offset = buf->offset;
+        block.sample_rate = buf->sample_rate;
+        block.dropped = e->queue.front().second;
+        e->queue.pop_front();
+        e->busy = true;
+        lock.unlock();
+
+        e->plugin->process(block);
+        buf.reset();
+
+        lock.lock();
+        e->busy = false;
+        if (!e->queue.empty() && !e->removing)
+        {
+            e->queued = true;
+            d_ready.push_back(e);
+            d_ready_cv.notify_one();
+        }
+        d_idle_cv.notify_all();
+    }
+}
@@ -0,0 +1,113 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef DECODER_POOL_H
+#define DECODER_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "interfaces/decoder_plugin.h"
+
+
+/*! \brief Run decoder plugins on a pool of worker threads.
+ *  \ingroup IO
+ *
+ * The flow graph hands each block of a stream to deliver() once; the block
+ * is queued by reference for every plugin subscribed to that stream and
+ * rate, so a block is copied out of the flow graph only once however many
+ * plugins use it. Buffers are recycled through a free list.
+ *
+ * Each plugin has a queue of its own and is run by at most one worker at a
+ * time. When a queue is full new blocks for that plugin are dropped and
+ * counted, the flow graph is never blocked.
+ */
+class decoder_pool
+{
+public:
+    /*! \brief A block of samples shared between plugins. */
+    struct buffer
+    {
+        std::vector<float>  data;
+        size_t              count;      /*!< Samples, or I/Q pairs. */
+        uint64_t            offset;
+        double              sample_rate;
+    };
+    typedef std::shared_ptr<buffer> buffer_sptr;
+
+    /*! \brief An event published by a plugin. */
+    struct event
+    {
+        int         id;         /*!< Plugin that published it. */
+        std::string name;       /*!< Name of the plugin. */
+        std::string type;
+        std::string text;
+        int64_t     time_ms;    /*!< Wall clock, ms since the UNIX epoch. */
+    };
+
+    explicit decoder_pool(unsigned int threads = 0);
+    ~decoder_pool();
+
+    decoder_pool(const decoder_pool &) = delete;
+    decoder_pool &operator=(const decoder_pool &) = delete;
+
+    int  add(decoder_plugin *plugin, decoder_destroy_fn destroy, double sample_rate);
+    bool remove(int id);
+
+    buffer_sptr get_buffer(size_t values);
+    void deliver(int stream, double rate, buffer_sptr buf);
+
+    bool get_event(event &ev);
+
+private:
+    class entry;
+
+    void worker();
+    void publish(entry *e, const char *type, const char *text);
+
+    std::mutex                          d_mutex;
+    std::condition_variable             d_ready_cv;  /*!< Work in d_ready, or quit. */
+    std::condition_variable             d_idle_cv;   /*!< A plugin call has finished. */
+    std::vector<std::unique_ptr<entry>> d_entries;
+    std::deque<entry *>                 d_ready;     /*!< Plugins with queued blocks, not running. */
+    bool                                d_quit;
+    int                                 d_next_id;
+    std::vector<std::thread>            d_threads;
+
+    struct free_list
+    {
+        std::mutex                              mutex;
+        std::vector<std::unique_ptr<buffer>>    buffers;
+    };
+    std::shared_ptr<free_list>          d_free;      /*!< Recycled buffers, may outlive the pool. */
+
+    std::mutex                          d_event_mutex;
+    std::deque<event>                   d_events;
+};
+
+#endif // DECODER_POOL_H
@@ -0,0 +1,321 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/gr_complex.h>
+#include "interfaces/file_recorder.h"
+#include "interfaces/trace.h"
+
+#define WAV_HEADER_SIZE 44
+
+/*! \brief Create an idle recorder.
+ *  \param format The file format.
+ *  \param channels Maximum number of WAV channels, ignored for raw I/Q.
+ *  \param samp_rate The sample rate, used for the WAV header and rollover.
+ */
+file_recorder::file_recorder(int format, int channels, double samp_rate)
+    : d_format(format),
+      d_channels(format == FORMAT_WAV ? channels : 1),
+      d_new_channels(d_channels),
+      d_max_channels(d_channels),
+      d_enabled(false),
+      d_samp_rate(samp_rate),
+      d_rollover(0.0),
+      d_rollover_items(0),
+      d_segment(0),
+      d_fp(nullptr),
+      d_items(0)
+{
+}
+
+file_recorder::~file_recorder()
+{
+    close();
+}
+
+/*! \brief Start recording to a new file.
+ *  \param filename The file name; further segments are derived from it.
+ *  \returns True if the file could be opened.
+ *
+ * Any file being recorded is closed first.
+ */
+bool file_recorder::open(const std::string &filename)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    close_segment();
+    d_filename = filename;
+    d_segment = 0;
+    d_channels = d_new_channels;
+
+    bool ok = open_segment();
+    d_enabled = ok;
+
+    return ok;
+}
+
+/*! \brief Stop recording.
+ *
+ * Blocks until a write in progress has finished.
+ */
+void file_recorder::close()
+{
+    d_enabled = false;
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+    close_segment();
+}
+
+void file_recorder::set_sample_rate(double samp_rate)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_samp_rate = samp_rate;
+    d_rollover_items = (uint64_t)std::llround(d_rollover * d_samp_rate);
+}
+
+/*! \brief Set the number of channels of WAV files opened from now on.
+ *  \param channels 1 or up to the number given to the constructor.
+ */
+void file_recorder::set_channels(int channels)
+{
+    if (d_format != FORMAT_WAV)
+        return;
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_new_channels = std::max(1, std::min(channels, d_max_channels));
+}
+
+/*! \brief Set the segment length.
+ *  \param seconds Length of each file in seconds. 0 disables rollover.
+ */
+void file_recorder::set_rollover(double seconds)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_rollover = std::max(seconds, 0.0);
+    d_rollover_items = (uint64_t)std::llround(d_rollover * d_samp_rate);
+}
+
+/*! \brief Append samples to a raw I/Q recording.
+ *  \param in Complex float samples.
+ *  \param nsamples The number of samples.
+ */
+void file_recorder::write_samples(const gr_complex *in, int nsamples)
+{
+    if (d_format != FORMAT_RAW_IQ || !d_enabled.load(std::memory_order_relaxed))
+        return;
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+    write_items((const char *)in, nsamples);
+}
+
+/*! \brief Append PCM frames to a WAV recording.
+ *  \param pcm Interleaved native endian 16 bit samples.
+ *  \param nframes The number of frames.
+ *  \param channels Samples per frame in pcm, 1 or 2.
+ */
+void file_recorder::write_frames(const int16_t *pcm, int nframes, int channels)
+{
+    TRACE_SCOPE("file_recorder::write_frames", "io");
+
+    if (d_format != FORMAT_WAV || !d_enabled.load(std::memory_order_relaxed))
+        return;
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (channels == d_channels)
+    {
+        write_items((const char *)pcm, nframes);
+        return;
+    }
+#endif
+
+    /* match the channel count of the file and convert to little endian */
+    d_pcm.resize((size_t)nframes * d_channels);
+    for (int i = 0; i < nframes; i++)
+    {
+        for (int ch = 0; ch < d_channels; ch++)
+        {
+            uint16_t v = (uint16_t)pcm[(size_t)i * channels + std::min(ch, channels - 1)];
+            unsigned char *b = (unsigned char *)&d_pcm[(size_t)i * d_channels + ch];
+            b[0] = v & 0xff;
+            b[1] = v >> 8;
+        }
+    }
+    write_items((const char *)d_pcm.data(), nframes);
+}
+
+/*! \brief Write items in file format, splitting at segment boundaries.
+ *
+ * Must be called with d_mutex held.
+ */
+void file_recorder::write_items(const char *data, int nitems)
+{
+    const size_t item_size = (d_format == FORMAT_WAV) ?
+                             d_channels * sizeof(int16_t) : sizeof(gr_complex);
+
+    int offset = 0;
+    while (offset < nitems && d_fp)
+    {
+        int n = nitems - offset;
+        if (d_rollover_items > 0)
+            n = (int)std::min<uint64_t>(n, d_rollover_items - d_items);
+
+        if (std::fwrite(data + offset * item_size, item_size, n, d_fp) != (size_t)n)
+        {
+            std::cerr << "file_recorder: error writing " << segment_name(d_segment)
+                      << ", recording stopped" << std::endl;
+            close_segment();
+            d_enabled = false;
+            break;
+        }
+        offset += n;
+        d_items += n;
+
+        /* split exactly at the segment boundary */
+        if (d_rollover_items > 0 && d_items >= d_rollover_items)
+        {
+            close_segment();
+            d_segment++;
+            if (!open_segment())
+            {
+                d_enabled = false;
+                break;
+            }
+        }
+    }
+}
+
+bool file_recorder::open_segment()
+{
+    std::string name = segment_name(d_segment);
+
+    d_fp = std::fopen(name.c_str(), "wb");
+    if (!d_fp)
+    {
+        std::cerr << "file_recorder: can not open " << name << std::endl;
+        return false;
+    }
+
+    d_items = 0;
+    if (d_format == FORMAT_WAV)
+        write_wav_header();
+
+    return true;
+}
+
+void file_recorder::close_segment()
+{
+    if (!d_fp)
+        return;
+
+    if (d_format == FORMAT_WAV)
+    {
+        /* patch the sizes now that they are known */
+        std::fseek(d_fp, 0, SEEK_SET);
+        write_wav_header();
+    }
+
+    std::fclose(d_fp);
+    d_fp = nullptr;
+}
+
+/*! \brief Write a canonical 44 byte PCM WAV header for the current segment. */
+void file_recorder::write_wav_header()
+{
+    uint64_t data_bytes = d_items * d_channels * sizeof(int16_t);
+    uint32_t data_size = (uint32_t)std::min<uint64_t>(data_bytes, 0xffffffffULL - 36);
+    uint32_t rate = (uint32_t)std::lround(d_samp_rate);
+    uint16_t block_align = (uint16_t)(d_channels * sizeof(int16_t));
+    unsigned char hdr[WAV_HEADER_SIZE];
+
+    auto put16 = [&hdr](int pos, uint16_t v) {
+        hdr[pos] = v & 0xff;
+        hdr[pos + 1] = v >> 8;
+    };
+    auto put32 = [&hdr](int pos, uint32_t v) {
+        for (int i = 0; i < 4; i++)
+            hdr[pos + i] = (v >> (8 * i)) & 0xff;
+    };
+
+    std::copy_n("RIFF", 4, hdr);
+    put32(4, 36 + data_size);
+    std::copy_n("WAVEfmt ", 8, hdr + 8);
+    put32(16, 16);                      // fmt chunk size
+    put16(20, 1);                       // PCM
+    put16(22, (uint16_t)d_channels);
+    put32(24, rate);
+    put32(28, rate * block_align);
+    put16(32, block_align);
+    put16(34, 16);                      // bits per sample
+    std::copy_n("data", 4, hdr + 36);
+    put32(40, data_size);
+
+    std::fwrite(hdr, 1, WAV_HEADER_SIZE, d_fp);
+    std::fseek(d_fp, 0, SEEK_END);
+}
+
+/*! \brief File name of a segment; the first one uses the name given to open(). */
+std::string file_recorder::segment_name(unsigned int segment) const
+{
+    if (segment == 0)
+        return d_filename;
+
+    char num[16];
+    std::snprintf(num, sizeof(num), ".%03u", segment);
+
+    size_t slash = d_filename.find_last_of("/\\");
+    size_t dot = d_filename.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return d_filename + num;
+
+    return d_filename.substr(0, dot) + num + d_filename.substr(dot);
+}
+
+
+file_recorder_sink_sptr make_file_recorder_sink(file_recorder_ptr recorder)
+{
+    return gnuradio::get_initial_sptr(new file_recorder_sink(recorder));
+}
+
+file_recorder_sink::file_recorder_sink(file_recorder_ptr recorder)
+    : gr::sync_block ("file_recorder_sink",
+          gr::io_signature::make(1, 1, sizeof(gr_complex)),
+          gr::io_signature::make(0, 0, 0)),
+      d_recorder(recorder)
+{
+}
+
+int file_recorder_sink::work(int noutput_items,
+                             gr_vector_const_void_star &input_items,
+                             gr_vector_void_star &output_items)
+{
+    TRACE_SCOPE("file_recorder_sink::work", "dsp");
+    (void) output_items;
+
+    d_recorder->write_samples((const gr_complex *)input_items[0], noutput_items);
+
+    return noutput_items;
+}
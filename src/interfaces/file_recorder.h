@@ -0,0 +1,142 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef FILE_RECORDER_H
+#define FILE_RECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/sync_block.h>
+
+
+/*! \brief Recorder that stays attached to the receiver.
+ *  \ingroup IO
+ *
+ * Unlike file_sink and wavfile_sink, a recorder is created once and never
+ * rewired. Recording is switched on and off with open() and close(); while
+ * idle, the writers check an atomic flag and drop the samples.
+ *
+ * When a rollover length is set, the writer splits the stream at exactly
+ * that many samples and continues in a new file named after the original
+ * with a segment number inserted before the extension, for example
+ * gqrx_..._fc.001.raw. The split happens inside the writer, so no samples are
+ * lost or duplicated between segments.
+ *
+ * Raw I/Q recorders are fed by a file_recorder_sink in the flow graph. WAV
+ * recorders are fed 16 bit PCM through write_frames() by audio_output, which
+ * does the gain and conversion in the audio thread and leaves the disk I/O
+ * to its writer thread. Files are written with the number of channels
+ * selected by set_channels() when they are opened; a mono block is
+ * duplicated into a stereo file and the right channel of a stereo block is
+ * dropped from a mono file.
+ */
+class file_recorder
+{
+public:
+    enum file_format {
+        FORMAT_RAW_IQ = 0,  /*!< Raw native endian complex float. */
+        FORMAT_WAV    = 1   /*!< 16 bit PCM WAV, see write_frames(). */
+    };
+
+    file_recorder(int format, int channels, double samp_rate);
+    ~file_recorder();
+
+    file_recorder(const file_recorder &) = delete;
+    file_recorder &operator=(const file_recorder &) = delete;
+
+    void write_samples(const gr_complex *in, int nsamples);
+    void write_frames(const int16_t *pcm, int nframes, int channels);
+
+    bool open(const std::string &filename);
+    void close();
+    bool is_recording() const { return d_enabled.load(); }
+
+    void set_sample_rate(double samp_rate);
+    void set_rollover(double seconds);
+    void set_channels(int channels);
+
+private:
+    bool open_segment();
+    void close_segment();
+    void write_items(const char *data, int nitems);
+    void write_wav_header();
+    std::string segment_name(unsigned int segment) const;
+
+    int             d_format;
+    int             d_channels;     /*!< Channels in the current file. */
+    int             d_new_channels; /*!< Channels for the next file. */
+    int             d_max_channels;
+
+    std::atomic<bool>   d_enabled;  /*!< Checked by the writers without locking. */
+    std::mutex      d_mutex;        /*!< Protects the file state below. */
+    double          d_samp_rate;
+    double          d_rollover;     /*!< Segment length in seconds, 0 disables. */
+    uint64_t        d_rollover_items;
+    std::string     d_filename;     /*!< Name of the first segment. */
+    unsigned int    d_segment;
+    FILE           *d_fp;
+    uint64_t        d_items;        /*!< Items written to the current segment. */
+    std::vector<int16_t> d_pcm;     /*!< Channel and byte order conversion for WAV. */
+};
+
+typedef std::shared_ptr<file_recorder> file_recorder_ptr;
+
+
+class file_recorder_sink;
+
+#if GNURADIO_VERSION < 0x030900
+typedef boost::shared_ptr<file_recorder_sink> file_recorder_sink_sptr;
+#else
+typedef std::shared_ptr<file_recorder_sink> file_recorder_sink_sptr;
+#endif
+
+/*! \brief Return a shared_ptr to a new instance of file_recorder_sink.
+ *  \param recorder The raw I/Q recorder to feed.
+ */
+file_recorder_sink_sptr make_file_recorder_sink(file_recorder_ptr recorder);
+
+/*! \brief Feeds a raw I/Q file_recorder from the flow graph.
+ *  \ingroup IO
+ */
+class file_recorder_sink : public gr::sync_block
+{
+    friend file_recorder_sink_sptr make_file_recorder_sink(file_recorder_ptr recorder);
+
+protected:
+    file_recorder_sink(file_recorder_ptr recorder);
+
+public:
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+
+private:
+    file_recorder_ptr   d_recorder;
+};
+
+#endif // FILE_RECORDER_H
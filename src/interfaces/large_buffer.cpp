@@ -0,0 +1,238 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define HAVE_MMAP
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#include "interfaces/large_buffer.h"
+
+#define LARGE_BUFFER_MIN    (1024 * 1024)       /* smaller buffers use the heap */
+#define HUGE_PAGE_SIZE      (2 * 1024 * 1024)
+
+/* From <numaif.h>, which is only available with libnuma */
+#define LB_MPOL_PREFERRED   1
+#define LB_MPOL_MF_MOVE     (1 << 1)
+
+namespace large_buffer
+{
+
+static std::atomic<int> g_flags(0);
+
+void set_flags(int flags)
+{
+    g_flags = flags;
+}
+
+int get_flags(void)
+{
+    return g_flags;
+}
+
+#ifdef HAVE_MMAP
+
+static size_t page_size(void)
+{
+    static const size_t size = (size_t)sysconf(_SC_PAGESIZE);
+    return size;
+}
+
+static size_t map_size(size_t size)
+{
+    return (size + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1);
+}
+
+/*! \brief Map len bytes, aligned so they can be backed by huge pages. */
+static void *map_aligned(size_t len)
+{
+#if defined(__linux__) && defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    /* Explicit huge pages are reserved here, so this fails if too few are free */
+    void *huge = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT),
+                      -1, 0);
+    if (huge != MAP_FAILED)
+        return huge;
+#endif
+
+    /* Over-allocate and trim to get huge page alignment */
+    char *raw = (char *)mmap(nullptr, len + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+        return nullptr;
+
+    uintptr_t addr = (uintptr_t)raw;
+    uintptr_t aligned = (addr + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+    size_t head = aligned - addr;
+    if (head > 0)
+        munmap(raw, head);
+    if (HUGE_PAGE_SIZE - head > 0)
+        munmap((char *)aligned + len, HUGE_PAGE_SIZE - head);
+
+#ifdef MADV_HUGEPAGE
+    madvise((void *)aligned, len, MADV_HUGEPAGE);
+#endif
+    return (void *)aligned;
+}
+
+/*! \brief Write to every page of a range without changing its contents. */
+static void touch(void *ptr, size_t size)
+{
+    volatile char *p = (volatile char *)ptr;
+    for (size_t i = 0; i < size; i += page_size())
+        p[i] = p[i];
+    p[size - 1] = p[size - 1];
+}
+
+static void fault_in(void *ptr, size_t size)
+{
+    int flags = g_flags;
+
+    if (flags & LOCK)
+    {
+        if (mlock(ptr, size) == 0)
+            return;
+
+        static std::atomic<bool> warned(false);
+        if (!warned.exchange(true))
+            std::cerr << "large_buffer: can not lock buffers in memory ("
+                      << std::strerror(errno) << "), check the memlock limit" << std::endl;
+    }
+
+    if (flags & (PREFAULT | LOCK))
+        touch(ptr, size);
+}
+
+/*! \brief Allocate a buffer.
+ *  \param size Size in bytes.
+ *  \returns The buffer, or nullptr if out of memory.
+ *
+ * Large buffers are aligned to a huge page and faulted in according to the
+ * flags given to set_flags(). The size must be passed to dealloc() again.
+ */
+void *alloc(size_t size)
+{
+    if (size < LARGE_BUFFER_MIN)
+        return std::malloc(size > 0 ? size : 1);
+
+    size_t len = map_size(size);
+    void *ptr = map_aligned(len);
+    if (ptr)
+        fault_in(ptr, len);
+
+    return ptr;
+}
+
+void dealloc(void *ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (size < LARGE_BUFFER_MIN)
+        std::free(ptr);
+    else
+        munmap(ptr, map_size(size));
+}
+
+/*! \brief Apply the huge page and locking policy to memory allocated elsewhere.
+ *
+ * For buffers that have their own allocator, e.g. gr::buffer. Contents are
+ * preserved; locked pages stay locked until the memory is unmapped.
+ */
+void prepare(void *ptr, size_t size)
+{
+    if (!ptr || size < LARGE_BUFFER_MIN)
+        return;
+
+    uintptr_t start = (uintptr_t)ptr & ~(uintptr_t)(page_size() - 1);
+    size_t len = size + ((uintptr_t)ptr - start);
+
+#ifdef MADV_HUGEPAGE
+    madvise((void *)start, len, MADV_HUGEPAGE);
+#endif
+    if ((g_flags & LOCK) && mlock((void *)start, len) == 0)
+        return;
+    if (g_flags & (PREFAULT | LOCK))
+        touch(ptr, size);
+}
+
+#else // HAVE_MMAP
+
+void *alloc(size_t size)
+{
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void dealloc(void *ptr, size_t)
+{
+    std::free(ptr);
+}
+
+void prepare(void *, size_t)
+{
+}
+
+#endif // HAVE_MMAP
+
+/*! \brief Move a buffer to the NUMA node of the calling thread.
+ *
+ * Pages already touched are migrated, later ones are allocated on that
+ * node. Does nothing on systems with a single node.
+ */
+void bind_local(void *ptr, size_t size)
+{
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_getcpu)
+    static const bool numa = (access("/sys/devices/system/node/node1", F_OK) == 0);
+    if (!numa || !ptr || size < LARGE_BUFFER_MIN)
+        return;
+
+    unsigned int cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+        return;
+
+    const unsigned int bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(node / bits + 1, 0);
+    mask[node / bits] |= 1UL << (node % bits);
+
+    uintptr_t start = (uintptr_t)ptr & ~(uintptr_t)(page_size() - 1);
+    size_t len = size + ((uintptr_t)ptr - start);
+    if (syscall(SYS_mbind, start, len, LB_MPOL_PREFERRED, mask.data(),
+                mask.size() * bits + 1, LB_MPOL_MF_MOVE) != 0)
+        std::cerr << "large_buffer: can not move buffer to node " << node
+                  << " (" << std::strerror(errno) << ")" << std::endl;
+#else
+    (void) ptr;
+    (void) size;
+#endif
+}
+
+} // namespace large_buffer
@@ -0,0 +1,94 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef LARGE_BUFFER_H
+#define LARGE_BUFFER_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+
+/*! \brief Allocation of large sample buffers.
+ *
+ * Buffers of a few megabytes that are streamed through continuously, such
+ * as the FFT sample ring, suffer from TLB misses and from page faults the
+ * first time each page is touched. Buffers allocated here are backed by
+ * huge pages where the platform offers them: explicit (hugetlbfs) pages
+ * if some are reserved, transparent huge pages otherwise, and ordinary
+ * pages as the last resort. Small buffers come from the normal heap.
+ *
+ * The PREFAULT and LOCK flags, set once at startup, make the buffers fault
+ * in all their pages when allocated, and lock them in RAM. Failing to lock
+ * is reported once and otherwise ignored.
+ *
+ * On NUMA systems, bind_local() called from the consuming thread moves a
+ * buffer to the memory node of that thread.
+ */
+namespace large_buffer
+{
+    enum flags_t {
+        PREFAULT = 0x1,     /*!< Touch every page on allocation. */
+        LOCK     = 0x2,     /*!< Lock the pages in RAM, implies PREFAULT. */
+    };
+
+    void  set_flags(int flags);
+    int   get_flags(void);
+
+    void *alloc(size_t size);
+    void  dealloc(void *ptr, size_t size);
+    void  prepare(void *ptr, size_t size);
+    void  bind_local(void *ptr, size_t size);
+
+    /*! \brief Standard allocator using alloc() and dealloc(). */
+    template <class T>
+    struct allocator
+    {
+        using value_type = T;
+
+        allocator() noexcept = default;
+        template <class U> allocator(const allocator<U> &) noexcept {}
+
+        T *allocate(size_t n)
+        {
+            void *ptr = alloc(n * sizeof(T));
+            if (!ptr)
+                throw std::bad_alloc();
+            return static_cast<T *>(ptr);
+        }
+
+        void deallocate(T *ptr, size_t n) noexcept
+        {
+            dealloc(ptr, n * sizeof(T));
+        }
+    };
+
+    template <class T, class U>
+    bool operator==(const allocator<T> &, const allocator<U> &) { return true; }
+    template <class T, class U>
+    bool operator!=(const allocator<T> &, const allocator<U> &) { return false; }
+
+    template <class T>
+    using vector = std::vector<T, allocator<T>>;
+}
+
+#endif // LARGE_BUFFER_H
@@ -0,0 +1,182 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <volk/volk.h>
+#include "interfaces/pcm_queue.h"
+
+/*! \brief Create a queue.
+ *  \param size Ring size in bytes, rounded up to a multiple of 8.
+ */
+pcm_queue::pcm_queue(size_t size)
+    : d_buf((size + 7) / 8),
+      d_size(d_buf.size() * 8),
+      d_head(0),
+      d_tail(0),
+      d_dropped(0)
+{
+}
+
+/*! \brief Convert a block of float samples and queue it.
+ *  \param in One pointer per channel.
+ *  \param channels Number of channels, 1 or 2.
+ *  \param nframes Number of samples per channel.
+ *  \param scale Factor applied before saturating to 16 bit.
+ *  \returns False if all or part of the block was dropped.
+ *
+ * Blocks larger than a quarter of the ring are split so a single work() call
+ * can not fill it.
+ */
+bool pcm_queue::push(const float *const *in, int channels, int nframes, float scale)
+{
+    const int max_frames = (int)(d_size / 4 / (sizeof(int16_t) * channels));
+    bool ok = true;
+
+    for (int offset = 0; offset < nframes; offset += max_frames)
+    {
+        const float *ptr[2] = { in[0] + offset, in[channels - 1] + offset };
+        ok &= push_record(ptr, channels, std::min(max_frames, nframes - offset), scale);
+    }
+
+    /* unlocked notify: a wakeup lost to the race is recovered by the timeout in wait() */
+    d_data_cv.notify_one();
+
+    return ok;
+}
+
+bool pcm_queue::push_record(const float *const *in, int channels, int nframes, float scale)
+{
+    const size_t need = record_size(nframes, channels);
+    uint64_t head = d_head.load(std::memory_order_relaxed);
+    uint64_t tail = d_tail.load(std::memory_order_acquire);
+    size_t pos = head % d_size;
+
+    /* records never wrap; pad to the end of the ring instead */
+    size_t pad = (d_size - pos < need) ? d_size - pos : 0;
+    if (d_size - (head - tail) < pad + need)
+    {
+        d_dropped++;
+        return false;
+    }
+
+    char *base = (char *)d_buf.data();
+    if (pad > 0)
+    {
+        ((header *)(base + pos))->channels = 0;
+        head += pad;
+        pos = 0;
+    }
+
+    header *hdr = (header *)(base + pos);
+    hdr->nframes = (uint32_t)nframes;
+    hdr->channels = (uint32_t)channels;
+    int16_t *out = (int16_t *)(hdr + 1);
+
+    if (channels == 1)
+    {
+        volk_32f_s32f_convert_16i(out, in[0], scale, nframes);
+    }
+    else
+    {
+        d_scratch.resize(2 * (size_t)nframes);
+        volk_32f_x2_interleave_32fc((lv_32fc_t *)d_scratch.data(), in[0], in[1], nframes);
+        volk_32f_s32f_convert_16i(out, d_scratch.data(), scale, 2 * nframes);
+    }
+
+    d_head.store(head + need, std::memory_order_release);
+
+    return true;
+}
+
+/*! \brief Wait until the queue is not empty, wake() is called or the timeout expires. */
+void pcm_queue::wait(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(d_wait_mutex);
+    if (d_head.load(std::memory_order_acquire) != d_tail.load(std::memory_order_relaxed))
+        return;
+    d_data_cv.wait_for(lock, timeout);
+}
+
+/*! \brief Pass all queued blocks to writer, in order.
+ *  \returns The number of blocks written.
+ */
+int pcm_queue::drain(const writer_fn &writer)
+{
+    const char *base = (const char *)d_buf.data();
+    uint64_t head = d_head.load(std::memory_order_acquire);
+    const uint64_t start = d_tail.load(std::memory_order_relaxed);
+    uint64_t tail = start;
+    int count = 0;
+
+    while (tail != head)
+    {
+        size_t pos = tail % d_size;
+        const header *hdr = (const header *)(base + pos);
+
+        if (hdr->channels == 0)
+        {
+            tail += d_size - pos;
+        }
+        else
+        {
+            writer((const int16_t *)(hdr + 1), (int)hdr->nframes, (int)hdr->channels);
+            tail += record_size((int)hdr->nframes, (int)hdr->channels);
+            count++;
+        }
+        d_tail.store(tail, std::memory_order_release);
+    }
+
+    if (tail != start)
+    {
+        std::lock_guard<std::mutex> lock(d_wait_mutex);
+        d_drain_cv.notify_all();
+    }
+
+    return count;
+}
+
+/*! \brief Wait until everything pushed so far has been drained.
+ *  \returns False on timeout.
+ */
+bool pcm_queue::flush(std::chrono::milliseconds timeout)
+{
+    const uint64_t head = d_head.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(d_wait_mutex);
+
+    d_data_cv.notify_one();
+    return d_drain_cv.wait_for(lock, timeout, [this, head] {
+        return d_tail.load(std::memory_order_acquire) >= head;
+    });
+}
+
+/*! \brief Interrupt a wait() in progress, e.g. to stop the consumer thread. */
+void pcm_queue::wake()
+{
+    std::lock_guard<std::mutex> lock(d_wait_mutex);
+    d_data_cv.notify_all();
+}
+
+size_t pcm_queue::record_size(int nframes, int channels)
+{
+    size_t bytes = sizeof(header) + sizeof(int16_t) * (size_t)nframes * channels;
+    return (bytes + 7) & ~(size_t)7;
+}
@@ -0,0 +1,96 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef PCM_QUEUE_H
+#define PCM_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+
+/*! \brief Lock-free queue of 16 bit PCM blocks.
+ *  \ingroup IO
+ *
+ * Single producer, single consumer ring used by audio_output to hand audio
+ * to threads doing blocking I/O. The producer converts float samples straight
+ * into the ring, so the audio thread never waits for a disk or a socket.
+ *
+ * Each push() stores one record holding its frame and channel count, so a
+ * change between mono and stereo can never misalign the consumer. When the
+ * ring is full the new block is dropped and counted; the producer is never
+ * blocked.
+ */
+class pcm_queue
+{
+public:
+    /*! \brief Consumer callback.
+     *  \param pcm Interleaved native endian samples.
+     *  \param nframes Number of frames.
+     *  \param channels Samples per frame.
+     */
+    typedef std::function<void(const int16_t *pcm, int nframes, int channels)> writer_fn;
+
+    explicit pcm_queue(size_t size);
+
+    pcm_queue(const pcm_queue &) = delete;
+    pcm_queue &operator=(const pcm_queue &) = delete;
+
+    /* producer */
+    bool push(const float *const *in, int channels, int nframes, float scale);
+
+    /* consumer */
+    void wait(std::chrono::milliseconds timeout);
+    int  drain(const writer_fn &writer);
+    bool flush(std::chrono::milliseconds timeout);
+    void wake();
+
+    unsigned int dropped() const { return d_dropped.load(); }
+
+private:
+    struct header
+    {
+        uint32_t nframes;
+        uint32_t channels;     /*!< 0 marks padding up to the end of the ring. */
+    };
+
+    bool push_record(const float *const *in, int channels, int nframes, float scale);
+    static size_t record_size(int nframes, int channels);
+
+    std::vector<uint64_t>   d_buf;      /*!< 8 byte units keep the headers aligned. */
+    size_t                  d_size;     /*!< Ring size in bytes. */
+    std::vector<float>      d_scratch;  /*!< Interleaving buffer, producer only. */
+
+    std::atomic<uint64_t>   d_head;     /*!< Bytes written, owned by the producer. */
+    std::atomic<uint64_t>   d_tail;     /*!< Bytes consumed, owned by the consumer. */
+    std::atomic<unsigned int> d_dropped;
+
+    std::mutex              d_wait_mutex;
+    std::condition_variable d_data_cv;  /*!< Signalled after each push(). */
+    std::condition_variable d_drain_cv; /*!< Signalled after drain() consumed data. */
+};
+
+#endif // PCM_QUEUE_H
@@ -0,0 +1,217 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <chrono>
+#include <gnuradio/io_signature.h>
+#include <pmt/pmt.h>
+#include "interfaces/source_bridge.h"
+#include "interfaces/trace.h"
+
+/* Short enough that stop() and lock() on either flow graph are not delayed */
+#define BRIDGE_WRITE_TIMEOUT_MS 100
+#define BRIDGE_READ_TIMEOUT_MS  50
+
+
+source_bridge::source_bridge(size_t capacity)
+    : d_buf(capacity),
+      d_head(0),
+      d_count(0),
+      d_nread(0),
+      d_overflows(0)
+{
+}
+
+/*! \brief Append samples to the FIFO.
+ *  \param in The samples.
+ *  \param nitems The number of samples.
+ *  \param timeout_ms How long to wait for space before dropping.
+ *  \returns The number of samples written, the rest are dropped.
+ */
+size_t source_bridge::write(const gr_complex *in, size_t nitems, int timeout_ms)
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    size_t size = d_buf.size();
+    size_t written = 0;
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(timeout_ms);
+
+    while (written < nitems)
+    {
+        if (d_count == size &&
+            !d_writable.wait_until(lock, deadline, [this, size] { return d_count < size; }))
+            break;
+
+        size_t tail = (d_head + d_count) % size;
+        size_t n = std::min({nitems - written, size - d_count, size - tail});
+
+        std::copy_n(in + written, n, &d_buf[tail]);
+        d_count += n;
+        written += n;
+        d_readable.notify_one();
+    }
+
+    d_overflows += nitems - written;
+
+    return written;
+}
+
+/*! \brief Fraction of the FIFO waiting to be read. */
+double source_bridge::backlog()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    return (double)d_count / (double)d_buf.size();
+}
+
+/*! \brief Take samples from the FIFO.
+ *  \param out Where to put the samples.
+ *  \param nitems Maximum number of samples to read.
+ *  \param timeout_ms How long to wait if the FIFO is empty.
+ *  \param retunes If not null, receives the retune events of this chunk.
+ *  \returns The number of samples read, 0 on timeout.
+ */
+size_t source_bridge::read(gr_complex *out, size_t nitems, int timeout_ms,
+                           std::vector<retune> *retunes)
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    size_t size = d_buf.size();
+
+    if (!d_readable.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                             [this] { return d_count > 0; }))
+        return 0;
+
+    size_t nread = 0;
+    while (nread < nitems && d_count > 0)
+    {
+        size_t n = std::min({nitems - nread, d_count, size - d_head});
+
+        std::copy_n(&d_buf[d_head], n, out + nread);
+        d_head = (d_head + n) % size;
+        d_count -= n;
+        nread += n;
+    }
+    d_writable.notify_one();
+
+    uint64_t start = d_nread;
+    d_nread += nread;
+
+    while (!d_retunes.empty() && d_retunes.front().first < d_nread)
+    {
+        /* events on flushed samples move to the first sample we have */
+        if (retunes)
+            retunes->push_back({(size_t)(std::max(d_retunes.front().first, start) - start),
+                                d_retunes.front().second});
+        d_retunes.pop_front();
+    }
+
+    return nread;
+}
+
+/*! \brief Queue a retune event for the next sample written.
+ *  \param freq The new center frequency in Hz.
+ *
+ * Samples the device produced before the retune may still follow, see the
+ * class description.
+ */
+void source_bridge::mark_retune(double freq)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_retunes.emplace_back(d_nread + d_count, freq);
+}
+
+/*! \brief Discard everything in the FIFO, e.g. samples from the old device. */
+void source_bridge::flush()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_nread += d_count;
+    d_head = 0;
+    d_count = 0;
+    d_writable.notify_one();
+}
+
+
+source_bridge_sink_sptr make_source_bridge_sink(source_bridge_ptr bridge)
+{
+    return gnuradio::get_initial_sptr(new source_bridge_sink(bridge));
+}
+
+source_bridge_sink::source_bridge_sink(source_bridge_ptr bridge)
+    : gr::sync_block ("source_bridge_sink",
+          gr::io_signature::make(1, 1, sizeof(gr_complex)),
+          gr::io_signature::make(0, 0, 0)),
+      d_bridge(bridge)
+{
+}
+
+source_bridge_sink::~source_bridge_sink()
+{
+}
+
+int source_bridge_sink::work(int noutput_items,
+                             gr_vector_const_void_star &input_items,
+                             gr_vector_void_star &output_items)
+{
+    TRACE_SCOPE("source_bridge_sink::work", "dsp");
+    (void) output_items;
+
+    d_bridge->write((const gr_complex *)input_items[0], noutput_items,
+                    BRIDGE_WRITE_TIMEOUT_MS);
+
+    return noutput_items;
+}
+
+
+source_bridge_source_sptr make_source_bridge_source(source_bridge_ptr bridge)
+{
+    return gnuradio::get_initial_sptr(new source_bridge_source(bridge));
+}
+
+source_bridge_source::source_bridge_source(source_bridge_ptr bridge)
+    : gr::sync_block ("source_bridge_source",
+          gr::io_signature::make(0, 0, 0),
+          gr::io_signature::make(1, 1, sizeof(gr_complex))),
+      d_bridge(bridge)
+{
+}
+
+source_bridge_source::~source_bridge_source()
+{
+}
+
+int source_bridge_source::work(int noutput_items,
+                               gr_vector_const_void_star &input_items,
+                               gr_vector_void_star &output_items)
+{
+    TRACE_SCOPE("source_bridge_source::work", "dsp");
+    (void) input_items;
+
+    d_retunes.clear();
+    int nread = (int)d_bridge->read((gr_complex *)output_items[0], noutput_items,
+                                    BRIDGE_READ_TIMEOUT_MS, &d_retunes);
+
+    for (const auto &r : d_retunes)
+        add_item_tag(0, nitems_written(0) + r.index,
+                     pmt::intern("rx_freq"), pmt::from_double(r.freq));
+
+    return nread;
+}
@@ -0,0 +1,157 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef SOURCE_BRIDGE_H
+#define SOURCE_BRIDGE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/sync_block.h>
+
+
+/*! \brief Sample FIFO between the input front end and the receiver.
+ *
+ * The input device and the input decimator run in their own small flow
+ * graph which ends in a source_bridge_sink. The receiver flow graph starts
+ * with a source_bridge_source reading from the same FIFO. This allows the
+ * front end to be stopped, rebuilt and restarted while the DSP chain,
+ * the FFT and the audio output keep running.
+ *
+ * Retune events are queued with the position of the next sample the front
+ * end writes, and handed to the reader together with that sample. This is
+ * only the earliest sample that can be at the new frequency: the samples
+ * still in the device buffers and in the group delay of the input decimator
+ * when the device was retuned arrive after it, so the actual change follows
+ * the event by that latency, which is not known here.
+ */
+class source_bridge
+{
+public:
+    /*! \brief A retune event, index is relative to the start of a read. */
+    struct retune {
+        size_t  index;
+        double  freq;
+    };
+
+    explicit source_bridge(size_t capacity);
+
+    size_t write(const gr_complex *in, size_t nitems, int timeout_ms);
+    size_t read(gr_complex *out, size_t nitems, int timeout_ms,
+                std::vector<retune> *retunes = nullptr);
+    void flush();
+    void mark_retune(double freq);
+
+    uint64_t overflows() const { return d_overflows.load(); }
+    double backlog();
+
+private:
+    std::mutex                  d_mutex;
+    std::condition_variable     d_readable;
+    std::condition_variable     d_writable;
+    std::vector<gr_complex>     d_buf;
+    size_t                      d_head;     /*!< Next item to read. */
+    size_t                      d_count;    /*!< Items in the FIFO. */
+    uint64_t                    d_nread;    /*!< Total items read or flushed. */
+    std::atomic<uint64_t>       d_overflows;/*!< Items dropped because the FIFO was full. */
+    std::deque<std::pair<uint64_t, double>> d_retunes; /*!< Pending (position, frequency). */
+};
+
+typedef std::shared_ptr<source_bridge> source_bridge_ptr;
+
+
+class source_bridge_sink;
+class source_bridge_source;
+
+#if GNURADIO_VERSION < 0x030900
+typedef boost::shared_ptr<source_bridge_sink> source_bridge_sink_sptr;
+typedef boost::shared_ptr<source_bridge_source> source_bridge_source_sptr;
+#else
+typedef std::shared_ptr<source_bridge_sink> source_bridge_sink_sptr;
+typedef std::shared_ptr<source_bridge_source> source_bridge_source_sptr;
+#endif
+
+source_bridge_sink_sptr make_source_bridge_sink(source_bridge_ptr bridge);
+source_bridge_source_sptr make_source_bridge_source(source_bridge_ptr bridge);
+
+
+/*! \brief Front end side of a source_bridge.
+ *  \ingroup IO
+ *
+ * Waits briefly for space when the receiver falls behind and drops samples
+ * if it does not catch up, so a stalled receiver never blocks the device.
+ */
+class source_bridge_sink : public gr::sync_block
+{
+    friend source_bridge_sink_sptr make_source_bridge_sink(source_bridge_ptr bridge);
+
+protected:
+    source_bridge_sink(source_bridge_ptr bridge);
+
+public:
+    ~source_bridge_sink();
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+
+private:
+    source_bridge_ptr   d_bridge;
+};
+
+
+/*! \brief Receiver side of a source_bridge.
+ *  \ingroup IO
+ *
+ * Produces whatever the front end has delivered. While the front end is
+ * being replaced it produces nothing, which idles the downstream blocks
+ * without stopping them.
+ *
+ * Retune events are emitted as "rx_freq" stream tags, the same key UHD
+ * uses, on the first sample written after the retune. The tags are early
+ * by the front end latency, see source_bridge.
+ */
+class source_bridge_source : public gr::sync_block
+{
+    friend source_bridge_source_sptr make_source_bridge_source(source_bridge_ptr bridge);
+
+protected:
+    source_bridge_source(source_bridge_ptr bridge);
+
+public:
+    ~source_bridge_source();
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+
+private:
+    source_bridge_ptr   d_bridge;
+    std::vector<source_bridge::retune> d_retunes;
+};
+
+#endif // SOURCE_BRIDGE_H
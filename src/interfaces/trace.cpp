@@ -0,0 +1,262 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#endif
+#include "interfaces/trace.h"
+
+/* Events per thread and session, later events are dropped */
+#define TRACE_BUFFER_SIZE 65536
+
+namespace trace
+{
+
+std::atomic<bool> g_enabled(false);
+
+#ifdef ENABLE_TRACING
+
+namespace
+{
+    struct event
+    {
+        const char *name;
+        const char *cat;
+        int64_t     begin;
+        int64_t     end;
+    };
+
+    /* Written by its thread only; count is published with release order. */
+    struct thread_buffer
+    {
+        std::vector<event>      events;
+        std::atomic<size_t>     count{0};
+        std::atomic<unsigned>   session{0};
+        std::atomic<bool>       alive{true};
+        std::atomic<uint64_t>   dropped{0};
+        unsigned                tid = 0;
+        std::string             name;
+    };
+
+    std::mutex                                  s_mutex;    /* registry */
+    std::vector<std::shared_ptr<thread_buffer>> s_buffers;
+    std::atomic<int>                            s_writers(0);   /* threads inside record() */
+    std::atomic<unsigned>                       s_session(0);
+    unsigned                                    s_next_tid = 1;
+    int64_t                                     s_start_ns = 0;
+
+    /* Marks the buffer as orphaned when the thread exits */
+    struct thread_handle
+    {
+        std::shared_ptr<thread_buffer> buf;
+
+        ~thread_handle()
+        {
+            if (buf)
+                buf->alive = false;
+        }
+    };
+
+    thread_local thread_handle t_handle;
+
+    thread_buffer *get_buffer()
+    {
+        if (!t_handle.buf)
+        {
+            auto buf = std::make_shared<thread_buffer>();
+            buf->events.resize(TRACE_BUFFER_SIZE);
+#ifdef __linux__
+            char name[16] = {0};
+            if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0)
+                buf->name = name;
+#endif
+            std::lock_guard<std::mutex> lock(s_mutex);
+            buf->tid = s_next_tid++;
+            if (buf->name.empty())
+                buf->name = "thread " + std::to_string(buf->tid);
+            s_buffers.push_back(buf);
+            t_handle.buf = buf;
+        }
+
+        return t_handle.buf.get();
+    }
+
+    void write_json_string(FILE *fp, const char *str)
+    {
+        std::fputc('"', fp);
+        for (const char *p = str; *p; p++)
+        {
+            if (*p == '"' || *p == '\\')
+                std::fputc('\\', fp);
+            if ((unsigned char)*p >= 0x20)
+                std::fputc(*p, fp);
+        }
+        std::fputc('"', fp);
+    }
+}
+
+/*! \brief Start a new trace, discarding any previous events. */
+bool start(void)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    /* buffers of threads that have exited are only kept for one trace */
+    s_buffers.erase(std::remove_if(s_buffers.begin(), s_buffers.end(),
+                                   [](const std::shared_ptr<thread_buffer> &b) {
+                                       return !b->alive;
+                                   }),
+                    s_buffers.end());
+
+    s_start_ns = now_ns();
+    s_session++;
+    g_enabled = true;
+
+    return true;
+}
+
+/*! \brief Stop tracing and write the events.
+ *  \param filename The JSON file to write.
+ *  \returns False if tracing was not running or the file could not be written.
+ */
+bool stop(const std::string &filename)
+{
+    if (!g_enabled.exchange(false))
+        return false;
+
+    /* wait for writers that saw the flag before it was cleared */
+    while (s_writers.load() > 0)
+        std::this_thread::yield();
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    FILE *fp = std::fopen(filename.c_str(), "w");
+    if (!fp)
+        return false;
+
+    unsigned session = s_session.load();
+    bool first = true;
+
+    std::fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (const auto &buf : s_buffers)
+    {
+        if (buf->session.load(std::memory_order_acquire) != session)
+            continue;
+
+        std::fprintf(fp, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                     first ? "" : ",\n", buf->tid);
+        write_json_string(fp, buf->name.c_str());
+        std::fprintf(fp, "}}");
+        first = false;
+
+        size_t count = buf->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++)
+        {
+            const event &e = buf->events[i];
+
+            std::fprintf(fp, ",\n{\"ph\":\"X\",\"name\":");
+            write_json_string(fp, e.name);
+            std::fprintf(fp, ",\"cat\":");
+            write_json_string(fp, e.cat);
+            std::fprintf(fp, ",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         buf->tid, (e.begin - s_start_ns) * 1e-3,
+                         (e.end - e.begin) * 1e-3);
+        }
+
+        if (buf->dropped > 0)
+            std::fprintf(fp, ",\n{\"ph\":\"C\",\"name\":\"dropped events\",\"pid\":1,\"tid\":%u,\"ts\":0,\"args\":{\"count\":%llu}}",
+                         buf->tid, (unsigned long long)buf->dropped.load());
+    }
+    std::fprintf(fp, "\n]}\n");
+
+    return std::fclose(fp) == 0;
+}
+
+/*! \brief Append an event to the buffer of the calling thread. */
+void record(const char *name, const char *cat, int64_t begin_ns, int64_t end_ns)
+{
+    if (!enabled())
+        return;
+
+    /* stop() waits for the count to drop to zero after clearing g_enabled,
+     * so a writer that still sees the flag set finishes before the dump */
+    s_writers++;
+    if (!g_enabled.load())
+    {
+        s_writers--;
+        return;
+    }
+
+    thread_buffer *buf = get_buffer();
+    unsigned session = s_session.load(std::memory_order_relaxed);
+
+    /* first event of a new trace, the owner resets its own buffer */
+    if (buf->session.load(std::memory_order_relaxed) != session)
+    {
+        buf->count.store(0, std::memory_order_relaxed);
+        buf->dropped = 0;
+        buf->session.store(session, std::memory_order_release);
+    }
+
+    size_t n = buf->count.load(std::memory_order_relaxed);
+    if (n < buf->events.size())
+    {
+        buf->events[n] = {name, cat, begin_ns, end_ns};
+        buf->count.store(n + 1, std::memory_order_release);
+    }
+    else
+    {
+        buf->dropped++;
+    }
+
+    s_writers--;
+}
+
+#else
+
+bool start(void)
+{
+    return false;
+}
+
+bool stop(const std::string &filename)
+{
+    (void) filename;
+    return false;
+}
+
+void record(const char *name, const char *cat, int64_t begin_ns, int64_t end_ns)
+{
+    (void) name;
+    (void) cat;
+    (void) begin_ns;
+    (void) end_ns;
+}
+
+#endif
+
+}
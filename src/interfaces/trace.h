@@ -0,0 +1,97 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+
+/*! \brief Timeline trace recorder.
+ *
+ * Records scoped events from any thread and writes them as a Chrome trace
+ * (JSON), which can be opened in Perfetto or chrome://tracing.
+ *
+ * Each thread appends to its own fixed size buffer, so recording takes no
+ * locks. While tracing is stopped, TRACE_SCOPE costs one relaxed atomic
+ * load. Builds without ENABLE_TRACING compile the scopes out entirely and
+ * start() fails.
+ *
+ * Event names and categories must outlive the trace; use string literals.
+ */
+namespace trace
+{
+    extern std::atomic<bool> g_enabled;
+
+    inline bool enabled()
+    {
+        return g_enabled.load(std::memory_order_relaxed);
+    }
+
+    inline int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool start(void);
+    bool stop(const std::string &filename);
+    void record(const char *name, const char *cat, int64_t begin_ns, int64_t end_ns);
+
+    /*! \brief Record the lifetime of this object as one event. */
+    class scope
+    {
+    public:
+        scope(const char *name, const char *cat)
+            : d_name(name), d_cat(cat), d_begin(enabled() ? now_ns() : -1)
+        {
+        }
+
+        ~scope()
+        {
+            if (d_begin >= 0)
+                record(d_name, d_cat, d_begin, now_ns());
+        }
+
+        scope(const scope &) = delete;
+        scope &operator=(const scope &) = delete;
+
+    private:
+        const char *d_name;
+        const char *d_cat;
+        int64_t     d_begin;
+    };
+}
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b)  TRACE_CONCAT2(a, b)
+
+#ifdef ENABLE_TRACING
+#define TRACE_SCOPE(name, cat) trace::scope TRACE_CONCAT(trace_scope_, __LINE__)(name, cat)
+#else
+#define TRACE_SCOPE(name, cat) do {} while (0)
+#endif
+
+#endif // TRACE_H
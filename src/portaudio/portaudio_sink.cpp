@@ -169,25 +169,6 @@ int portaudio_sink::work(int noutput_items,
     if (noutput_items > BUFFER_SIZE/2)
         noutput_items = BUFFER_SIZE/2;
 
-    // two channels (stereo)
-    const float *data_l = (const float*) input_items[0];
-    const float *data_r = (const float*) input_items[1];
-    for (i = noutput_items; i > 0; i--)
-    {
-        *ptr++ = *data_l++;
-        *ptr++ = *data_r++;
-    }
-
-    err = Pa_WriteStream(d_stream, audio_buffer, noutput_items);
-    if (err)
-        fprintf(stderr,
-                "portaudio_sink::work(): Error writing to audio device: %s\n",
-                Pa_GetErrorText(err));
-
-    return noutput_items;
-
-// code below supports 1 or 2 channels
-#if 0
     if (input_items.size() == 2)
     {
         // two channels (stereo)
@@ -201,15 +182,22 @@ int portaudio_sink::work(int noutput_items,
     }
     else
     {
-        // assume 1 channel (mono)
+        // one channel (mono), the device is always opened as stereo
         const float *data = (const float*) input_items[0];
         for (i = noutput_items; i > 0; i--)
         {
             float a = *data++;
-            *ptr++ = a; // same data in left and right channel
+            *ptr++ = a;
             *ptr++ = a;
         }
     }
-#endif
+
+    err = Pa_WriteStream(d_stream, audio_buffer, noutput_items);
+    if (err)
+        fprintf(stderr,
+                "portaudio_sink::work(): Error writing to audio device: %s\n",
+                Pa_GetErrorText(err));
+
+    return noutput_items;
 
 }
@@ -34,7 +34,8 @@ const QColor TagInfo::DefaultColor(Qt::lightGray);
 const QString TagInfo::strUntagged("Untagged");
 Bookmarks* Bookmarks::m_pThis = 0;
 
-Bookmarks::Bookmarks()
+Bookmarks::Bookmarks() :
+    m_TagIndexValid(false)
 {
      TagInfo::sptr tag = TagInfo::make(TagInfo::strUntagged);
      m_TagList.append(tag);
@@ -58,14 +59,19 @@ void Bookmarks::setConfigDir(const QString& cfg_dir)
 
 void Bookmarks::add(BookmarkInfo &info)
 {
-    m_BookmarkList.append(info);
-    std::stable_sort(m_BookmarkList.begin(),m_BookmarkList.end());
+    // Insert after any bookmarks with the same frequency to keep the list sorted.
+    int index = std::upper_bound(m_BookmarkList.begin(), m_BookmarkList.end(), info) - m_BookmarkList.begin();
+    m_BookmarkList.insert(index, info);
+    m_TagIndexValid = false;
+    emit BookmarkAdded(index);
     save();
 }
 
 void Bookmarks::remove(int index)
 {
     m_BookmarkList.removeAt(index);
+    m_TagIndexValid = false;
+    emit BookmarkRemoved(index);
     save();
 }
 
@@ -138,7 +144,9 @@ bool Bookmarks::load()
         }
         file.close();
         std::stable_sort(m_BookmarkList.begin(),m_BookmarkList.end());
+        m_TagIndexValid = false;
 
+        emit BookmarksReset();
         emit BookmarksChanged();
         return true;
     }
@@ -279,7 +287,9 @@ bool Bookmarks::removeTag(QString tagName)
 
     // Delete Tag.
     m_TagList.removeAt(idx);
+    m_TagIndexValid = false;
 
+    emit BookmarksReset();
     emit BookmarksChanged();
     emit TagListChanged();
 
@@ -291,11 +301,63 @@ bool Bookmarks::setTagChecked(QString tagName, bool bChecked)
     int idx = getTagIndex(tagName);
     if (idx == -1) return false;
     m_TagList[idx]->active = bChecked;
+    emit TagFilterChanged();
     emit BookmarksChanged();
-    emit TagListChanged();
     return true;
 }
 
+/*! \brief Replace the tags of a bookmark.
+ *
+ * The caller is responsible for saving the bookmarks afterwards.
+ */
+void Bookmarks::setBookmarkTags(int index, const QList<TagInfo::sptr> &tags)
+{
+    m_BookmarkList[index].tags = tags;
+    m_TagIndexValid = false;
+    emit BookmarkTagsChanged(index);
+}
+
+/*! \brief Get the bookmarks that have at least one active tag.
+ *  \returns One bit per bookmark, set if the bookmark is shown.
+ */
+QBitArray Bookmarks::getActiveBookmarks()
+{
+    updateTagIndex();
+
+    QBitArray active(m_BookmarkList.size());
+    for (int i = 0; i < m_TagList.size(); i++)
+    {
+        if (!m_TagList[i]->active)
+            continue;
+
+        auto it = m_TagMembers.constFind(m_TagList[i].get());
+        if (it != m_TagMembers.constEnd())
+            active |= *it;
+    }
+    return active;
+}
+
+void Bookmarks::updateTagIndex()
+{
+    if (m_TagIndexValid)
+        return;
+
+    const int n = m_BookmarkList.size();
+    m_TagMembers.clear();
+    for (int i = 0; i < n; i++)
+    {
+        const BookmarkInfo& info = m_BookmarkList[i];
+        for (int iTag = 0; iTag < info.tags.size(); ++iTag)
+        {
+            QBitArray &members = m_TagMembers[info.tags[iTag].get()];
+            if (members.size() != n)
+                members.resize(n);
+            members.setBit(i);
+        }
+    }
+    m_TagIndexValid = true;
+}
+
 int Bookmarks::getTagIndex(QString tagName)
 {
     tagName = tagName.trimmed();
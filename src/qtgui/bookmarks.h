@@ -27,6 +27,8 @@
 #include <QObject>
 #include <QString>
 #include <QMap>
+#include <QBitArray>
+#include <QHash>
 #include <QList>
 #include <QStringList>
 #include <QColor>
@@ -118,19 +120,32 @@ public:
     int getTagIndex(QString tagName);
     bool removeTag(QString tagName);
     bool setTagChecked(QString tagName, bool bChecked);
+    void setBookmarkTags(int index, const QList<TagInfo::sptr> &tags);
+    QBitArray getActiveBookmarks();
 
     void setConfigDir(const QString&);
 
 private:
     Bookmarks(); // Singleton Constructor is private.
+    void updateTagIndex();
+
     QList<BookmarkInfo>  m_BookmarkList;
     QList<TagInfo::sptr> m_TagList;
     QString              m_bookmarksFile;
     static Bookmarks*    m_pThis;
 
+    // For each tag, one bit per bookmark carrying it. Rebuilt on demand.
+    QHash<const TagInfo*, QBitArray> m_TagMembers;
+    bool                 m_TagIndexValid;
+
 signals:
     void BookmarksChanged(void);
     void TagListChanged(void);
+    void BookmarksReset(void);
+    void BookmarkAdded(int index);
+    void BookmarkRemoved(int index);
+    void BookmarkTagsChanged(int index);
+    void TagFilterChanged(void);
 };
 
 #endif // BOOKMARKS_H
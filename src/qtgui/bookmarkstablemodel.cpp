@@ -22,6 +22,7 @@
  */
 #include <QFile>
 #include <QStringList>
+#include <algorithm>
 #include "bookmarks.h"
 #include "bookmarkstablemodel.h"
 #include "dockrxopt.h"
@@ -30,11 +31,16 @@
 BookmarksTableModel::BookmarksTableModel(QObject *parent) :
     QAbstractTableModel(parent)
 {
+    connect(&Bookmarks::Get(), SIGNAL(BookmarksReset()), this, SLOT(update()));
+    connect(&Bookmarks::Get(), SIGNAL(TagFilterChanged()), this, SLOT(updateFilter()));
+    connect(&Bookmarks::Get(), SIGNAL(BookmarkAdded(int)), this, SLOT(bookmarkAdded(int)));
+    connect(&Bookmarks::Get(), SIGNAL(BookmarkRemoved(int)), this, SLOT(bookmarkRemoved(int)));
+    connect(&Bookmarks::Get(), SIGNAL(BookmarkTagsChanged(int)), this, SLOT(bookmarkTagsChanged(int)));
 }
 
 int BookmarksTableModel::rowCount ( const QModelIndex & /*parent*/ ) const
 {
-    return m_Bookmarks.size();
+    return m_rows.size();
 }
 int BookmarksTableModel::columnCount ( const QModelIndex & /*parent*/ ) const
 {
@@ -73,7 +79,7 @@ QVariant BookmarksTableModel::headerData ( int section, Qt::Orientation orientat
 
 QVariant BookmarksTableModel::data ( const QModelIndex & index, int role ) const
 {
-    BookmarkInfo& info = *m_Bookmarks[index.row()];
+    const BookmarkInfo& info = Bookmarks::Get().getBookmark(m_rows[index.row()]);
 
     if(role==Qt::BackgroundRole)
     {
@@ -114,7 +120,7 @@ bool BookmarksTableModel::setData(const QModelIndex &index, const QVariant &valu
 {
     if(role==Qt::EditRole)
     {
-        BookmarkInfo &info = *m_Bookmarks[index.row()];
+        BookmarkInfo &info = Bookmarks::Get().getBookmark(m_rows[index.row()]);
         switch(index.column())
         {
         case COL_FREQUENCY:
@@ -127,7 +133,6 @@ bool BookmarksTableModel::setData(const QModelIndex &index, const QVariant &valu
             {
                 info.name = value.toString();
                 emit dataChanged(index, index);
-                return true;
             }
             break;
         case COL_MODULATION:
@@ -148,19 +153,19 @@ bool BookmarksTableModel::setData(const QModelIndex &index, const QVariant &valu
             break;
         case COL_TAGS:
             {
-                info.tags.clear();
+                QList<TagInfo::sptr> tags;
                 QString strValue = value.toString();
                 QStringList strList = strValue.split(",");
                 for(int i=0; i<strList.size(); ++i)
                 {
                     QString strTag = strList[i].trimmed();
-                    info.tags.append( Bookmarks::Get().findOrAddTag(strTag) );
+                    tags.append( Bookmarks::Get().findOrAddTag(strTag) );
                 }
-                emit dataChanged(index, index);
-                return true;
+                Bookmarks::Get().setBookmarkTags(m_rows[index.row()], tags);
             }
             break;
         }
+        Bookmarks::Get().save();
         return true; // return true means success
     }
     return false;
@@ -185,41 +190,137 @@ Qt::ItemFlags BookmarksTableModel::flags ( const QModelIndex& index ) const
     return flags;
 }
 
+/*! \brief Rebuild the list of visible rows from scratch. */
 void BookmarksTableModel::update()
 {
-    int iRow = 0;
-    m_Bookmarks.clear();
-    for(int iBookmark=0; iBookmark<Bookmarks::Get().size(); iBookmark++)
+    QBitArray active = Bookmarks::Get().getActiveBookmarks();
+
+    beginResetModel();
+    m_rows.clear();
+    for(int iBookmark=0; iBookmark<active.size(); iBookmark++)
     {
-        BookmarkInfo& info = Bookmarks::Get().getBookmark(iBookmark);
+        if(active.testBit(iBookmark))
+            m_rows.append(iBookmark);
+    }
+    endResetModel();
+}
+
+/*! \brief Apply a change of the tag filter.
+ *
+ * The rows that appear or disappear are announced as ranges of inserted and
+ * removed rows, so views keep their selection and scroll position.
+ */
+void BookmarksTableModel::updateFilter()
+{
+    QBitArray active = Bookmarks::Get().getActiveBookmarks();
 
-        bool bActive = false;
-        for(int iTag=0; iTag<info.tags.size(); ++iTag)
+    int row = 0;
+    int iBookmark = 0;
+    const int count = active.size();
+    while (iBookmark < count)
+    {
+        // Bookmarks are either visible or not, row by row in the same order.
+        bool shown = row < m_rows.size() && m_rows[row] == iBookmark;
+        if (shown == active.testBit(iBookmark))
         {
-            TagInfo::sptr tag = info.tags[iTag];
-            if(tag->active)
-            {
-                bActive = true;
-                break;
-            }
+            if (shown)
+                row++;
+            iBookmark++;
+            continue;
         }
-        if(bActive)
+
+        // Find the end of the run of bookmarks changing the same way.
+        int last = iBookmark;
+        if (shown)
         {
-            m_mapRowToBookmarksIndex[iRow]=iBookmark;
-            m_Bookmarks.append(&info);
-            ++iRow;
+            int lastRow = row;
+            while (lastRow + 1 < m_rows.size() && m_rows[lastRow + 1] == m_rows[lastRow] + 1 &&
+                   !active.testBit(m_rows[lastRow + 1]))
+                lastRow++;
+            beginRemoveRows(QModelIndex(), row, lastRow);
+            m_rows.remove(row, lastRow - row + 1);
+            endRemoveRows();
+            last = iBookmark + lastRow - row;
         }
+        else
+        {
+            const int next = row < m_rows.size() ? m_rows[row] : count;
+            while (last + 1 < next && active.testBit(last + 1))
+                last++;
+            beginInsertRows(QModelIndex(), row, row + last - iBookmark);
+            m_rows.insert(row, last - iBookmark + 1, 0);
+            for (int i = iBookmark; i <= last; i++)
+                m_rows[row++] = i;
+            endInsertRows();
+        }
+        iBookmark = last + 1;
+    }
+}
+
+void BookmarksTableModel::bookmarkAdded(int iBookmark)
+{
+    int row = findRow(iBookmark);
+    for (int i = row; i < m_rows.size(); i++)
+        m_rows[i]++;
+
+    if (Bookmarks::Get().getBookmark(iBookmark).IsActive())
+    {
+        beginInsertRows(QModelIndex(), row, row);
+        m_rows.insert(row, iBookmark);
+        endInsertRows();
+    }
+}
+
+void BookmarksTableModel::bookmarkRemoved(int iBookmark)
+{
+    int row = findRow(iBookmark);
+    if (row < m_rows.size() && m_rows[row] == iBookmark)
+    {
+        beginRemoveRows(QModelIndex(), row, row);
+        m_rows.remove(row);
+        endRemoveRows();
     }
 
-    emit layoutChanged();
+    for (int i = row; i < m_rows.size(); i++)
+        m_rows[i]--;
+}
+
+void BookmarksTableModel::bookmarkTagsChanged(int iBookmark)
+{
+    int row = findRow(iBookmark);
+    bool shown = row < m_rows.size() && m_rows[row] == iBookmark;
+    bool active = Bookmarks::Get().getBookmark(iBookmark).IsActive();
+
+    if (shown && !active)
+    {
+        beginRemoveRows(QModelIndex(), row, row);
+        m_rows.remove(row);
+        endRemoveRows();
+    }
+    else if (!shown && active)
+    {
+        beginInsertRows(QModelIndex(), row, row);
+        m_rows.insert(row, iBookmark);
+        endInsertRows();
+    }
+    else if (shown)
+    {
+        emit dataChanged(index(row, 0), index(row, COL_TAGS));
+    }
+}
+
+/*! \brief Row of a bookmark, or of the first visible bookmark after it. */
+int BookmarksTableModel::findRow(int iBookmark) const
+{
+    return std::lower_bound(m_rows.begin(), m_rows.end(), iBookmark) - m_rows.begin();
 }
 
 BookmarkInfo *BookmarksTableModel::getBookmarkAtRow(int row)
 {
-    return m_Bookmarks[row];
+    return &Bookmarks::Get().getBookmark(m_rows[row]);
 }
 
 int BookmarksTableModel::GetBookmarksIndexForRow(int iRow)
 {
-  return m_mapRowToBookmarksIndex[iRow];
+  return m_rows[iRow];
 }
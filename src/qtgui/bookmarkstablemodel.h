@@ -24,7 +24,7 @@
 #define BOOKMARKSTABLEMODEL_H
 
 #include <QAbstractTableModel>
-#include <QList>
+#include <QVector>
 
 #include "bookmarks.h"
 
@@ -56,12 +56,18 @@ public:
     int GetBookmarksIndexForRow(int iRow);
 
 private:
-    QList<BookmarkInfo*> m_Bookmarks;
-    QMap<int,int> m_mapRowToBookmarksIndex;
+    int findRow(int iBookmark) const;
+
+    // Bookmarks index of each visible row, in ascending order.
+    QVector<int> m_rows;
 
 signals:
 public slots:
     void update();
+    void updateFilter();
+    void bookmarkAdded(int iBookmark);
+    void bookmarkRemoved(int iBookmark);
+    void bookmarkTagsChanged(int iBookmark);
 
 };
 
@@ -23,6 +23,7 @@
 #include "bookmarkstaglist.h"
 #include "bookmarks.h"
 #include <QColorDialog>
+#include <QHash>
 #include <stdio.h>
 #include <QMenu>
 #include <QHeaderView>
@@ -92,38 +93,35 @@ void BookmarksTagList::updateTags()
 {
     m_bUpdating = true;
 
-    // Remember which items were unchecked.
-    QStringList unchecked;
-    for(int i=0; i<rowCount(); i++)
+    // Get current List of Tags.
+    QHash<QString, TagInfo::sptr> newTags;
+    QList<TagInfo::sptr> tagList = Bookmarks::Get().getTagList();
+    for(int i=0; i<tagList.size(); ++i)
     {
-        if(item(i,1)->checkState()==Qt::Unchecked)
-            unchecked.append(item(i,1)->text());
+        if(m_bShowUntagged || tagList[i]->name.compare(TagInfo::strUntagged)!=0)
+            newTags.insert(tagList[i]->name, tagList[i]);
     }
 
-    // Get current List of Tags.
-    QList<TagInfo::sptr> newTags = Bookmarks::Get().getTagList();
-    if(!m_bShowUntagged)
+    // Update the rows in place, so their checked state is kept, and drop the
+    // rows of deleted tags.
+    setSortingEnabled(false);
+    for(int i=rowCount()-1; i>=0; i--)
     {
-        for(int i=0; i<newTags.size(); ++i)
+        QString name = item(i,1)->text();
+        auto it = newTags.find(name);
+        if(it == newTags.end())
         {
-            TagInfo::sptr taginfo = newTags[i];
-            if(taginfo->name.compare(TagInfo::strUntagged)==0)
-            {
-                newTags.removeAt(i);
-                break;
-            }
+            removeRow(i);
+            continue;
         }
+        item(i,0)->setBackground(QBrush((*it)->color));
+        newTags.erase(it);
     }
 
-    // Rebuild List in GUI.
-    clear();
-    setSortingEnabled(false);
-    setRowCount(0);
-    for(int i=0; i<newTags.count(); i++)
+    // Add the new tags.
+    for(auto it = newTags.constBegin(); it != newTags.constEnd(); ++it)
     {
-        AddTag(newTags[i]->name,
-                  ( unchecked.contains(newTags[i]->name) ? Qt::Unchecked : Qt::Checked ),
-                  newTags[i]->color);
+        AddTag((*it)->name, Qt::Checked, (*it)->color);
     }
     setSortingEnabled(true);
 
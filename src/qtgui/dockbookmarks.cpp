@@ -25,6 +25,7 @@
 #include <QComboBox>
 #include <QDialogButtonBox>
 #include <QDir>
+#include <QHeaderView>
 #include <QInputDialog>
 #include <QMenu>
 #include <QMessageBox>
@@ -51,6 +52,8 @@ DockBookmarks::DockBookmarks(QWidget *parent) :
     ui->tableViewFrequencyList->setSelectionBehavior(QAbstractItemView::SelectRows);
     ui->tableViewFrequencyList->setSelectionMode(QAbstractItemView::SingleSelection);
     ui->tableViewFrequencyList->installEventFilter(this);
+    // Fixed row heights let the view skip measuring rows it does not show.
+    ui->tableViewFrequencyList->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
 
     // Demod Selection in Frequency List Table.
     ComboBoxDelegateModulation* delegateModulation = new ComboBoxDelegateModulation(this);
@@ -87,12 +90,11 @@ DockBookmarks::DockBookmarks(QWidget *parent) :
             this, SLOT(activated(const QModelIndex &)));
     connect(ui->tableViewFrequencyList, SIGNAL(doubleClicked(const QModelIndex &)),
             this, SLOT(doubleClicked(const QModelIndex &)));
-    connect(bookmarksTableModel, SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &)),
-            this, SLOT(onDataChanged(const QModelIndex &, const QModelIndex &)));
     connect(&Bookmarks::Get(), SIGNAL(TagListChanged()),
             ui->tableWidgetTagList, SLOT(updateTags()));
+    // Rows are kept in sync by the model, only tag colours need a repaint.
     connect(&Bookmarks::Get(), SIGNAL(BookmarksChanged()),
-            bookmarksTableModel, SLOT(update()));
+            ui->tableViewFrequencyList->viewport(), SLOT(update()));
 }
 
 DockBookmarks::~DockBookmarks()
@@ -136,13 +138,6 @@ void DockBookmarks::updateBookmarks()
     bookmarksTableModel->update();
 }
 
-//Data has been edited
-void DockBookmarks::onDataChanged(const QModelIndex&, const QModelIndex &)
-{
-    updateTags();
-    Bookmarks::Get().save();
-}
-
 void DockBookmarks::on_tableWidgetTagList_itemChanged(QTableWidgetItem *item)
 {
     // we only want to react on changed by the user, not changes by the program itself.
@@ -190,7 +185,6 @@ bool DockBookmarks::DeleteSelectedBookmark()
     {
         int iIndex = bookmarksTableModel->GetBookmarksIndexForRow(selected.first().row());
         Bookmarks::Get().remove(iIndex);
-        bookmarksTableModel->update();
     }
     return true;
 }
@@ -272,15 +266,16 @@ void DockBookmarks::changeBookmarkTags(int row, int /*column*/)
             tags = taglist->getSelectedTags();
 
             // Change Tags of Bookmark
-            bmi.tags.clear();
+            QList<TagInfo::sptr> newTags;
             if (tags.size() == 0)
             {
-                bmi.tags.append(Bookmarks::Get().findOrAddTag("")); // "Untagged"
+                newTags.append(Bookmarks::Get().findOrAddTag("")); // "Untagged"
             }
             for (int i = 0; i < tags.size(); ++i)
             {
-                bmi.tags.append(Bookmarks::Get().findOrAddTag(tags[i]));
+                newTags.append(Bookmarks::Get().findOrAddTag(tags[i]));
             }
+            Bookmarks::Get().setBookmarkTags(iIdx, newTags);
             Bookmarks::Get().save();
         }
     }
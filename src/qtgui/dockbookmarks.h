@@ -74,7 +74,6 @@ public slots:
 
 private slots:
     void activated(const QModelIndex & index );
-    void onDataChanged (const QModelIndex & topLeft, const QModelIndex & bottomRight);
     //void on_addButton_clicked();
     //void on_delButton_clicked();
     void on_tableWidgetTagList_itemChanged(QTableWidgetItem* item);
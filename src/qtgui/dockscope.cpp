@@ -0,0 +1,145 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include "dockscope.h"
+#include "ui_dockscope.h"
+
+#define DEFAULT_SPAN_INDEX 4
+
+/* Time spans in seconds, from microseconds to a minute */
+static const double spans[] = {
+    10e-6, 100e-6, 1e-3, 10e-3, 100e-3, 1.0, 10.0, 60.0
+};
+static const char *span_names[] = {
+    "10 µs", "100 µs", "1 ms", "10 ms", "100 ms", "1 s", "10 s", "60 s"
+};
+
+DockScope::DockScope(QWidget *parent) :
+    QDockWidget(parent),
+    ui(new Ui::DockScope)
+{
+    ui->setupUi(this);
+
+    for (const char *name : span_names)
+        ui->spanCombo->addItem(QString::fromUtf8(name));
+    ui->spanCombo->setCurrentIndex(DEFAULT_SPAN_INDEX);
+    ui->levelSpin->setEnabled(false);
+}
+
+DockScope::~DockScope()
+{
+    delete ui;
+}
+
+int DockScope::source() const
+{
+    return ui->sourceCombo->currentIndex();
+}
+
+/** Time span in seconds. */
+double DockScope::span() const
+{
+    return spans[ui->spanCombo->currentIndex()];
+}
+
+/** Trigger mode, a scope_pyramid::trigger_mode. */
+int DockScope::triggerMode() const
+{
+    return ui->triggerCombo->currentIndex();
+}
+
+float DockScope::triggerLevel() const
+{
+    return (float)ui->levelSpin->value();
+}
+
+/** Number of columns to request, one per pixel. */
+int DockScope::pixels() const
+{
+    return qMax(ui->scope->width(), 1);
+}
+
+void DockScope::setData(const float *mins, const float *maxs, int n)
+{
+    ui->scope->setData(mins, maxs, n, span());
+}
+
+void DockScope::saveSettings(QSettings *settings)
+{
+    if (!settings)
+        return;
+
+    settings->beginGroup("scope");
+
+    if (ui->spanCombo->currentIndex() != DEFAULT_SPAN_INDEX)
+        settings->setValue("span", ui->spanCombo->currentIndex());
+    else
+        settings->remove("span");
+
+    if (triggerMode() != 0)
+        settings->setValue("trigger", triggerMode());
+    else
+        settings->remove("trigger");
+
+    settings->setValue("trigger_level", ui->levelSpin->value());
+
+    settings->endGroup();
+}
+
+void DockScope::readSettings(QSettings *settings)
+{
+    bool conv_ok;
+    int  intval;
+
+    if (!settings)
+        return;
+
+    settings->beginGroup("scope");
+
+    intval = settings->value("span", DEFAULT_SPAN_INDEX).toInt(&conv_ok);
+    if (conv_ok && intval >= 0 && intval < ui->spanCombo->count())
+        ui->spanCombo->setCurrentIndex(intval);
+
+    intval = settings->value("trigger", 0).toInt(&conv_ok);
+    if (conv_ok && intval >= 0 && intval < ui->triggerCombo->count())
+        ui->triggerCombo->setCurrentIndex(intval);
+
+    ui->levelSpin->setValue(settings->value("trigger_level", 0.1).toDouble());
+
+    settings->endGroup();
+}
+
+void DockScope::on_sourceCombo_currentIndexChanged(int index)
+{
+    emit sourceChanged(index);
+}
+
+void DockScope::on_triggerCombo_currentIndexChanged(int index)
+{
+    ui->levelSpin->setEnabled(index != 0);
+    ui->scope->setTrigger(index != 0, triggerLevel());
+}
+
+void DockScope::on_levelSpin_valueChanged(double value)
+{
+    ui->scope->setTrigger(triggerMode() != 0, (float)value);
+}
@@ -0,0 +1,65 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef DOCKSCOPE_H
+#define DOCKSCOPE_H
+
+#include <QDockWidget>
+#include <QSettings>
+
+namespace Ui {
+    class DockScope;
+}
+
+/*! \brief Dock widget with the time domain scope and its settings. */
+class DockScope : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DockScope(QWidget *parent = 0);
+    ~DockScope();
+
+    int     source() const;
+    double  span() const;
+    int     triggerMode() const;
+    float   triggerLevel() const;
+    int     pixels() const;
+
+    void setData(const float *mins, const float *maxs, int n);
+
+    void saveSettings(QSettings *settings);
+    void readSettings(QSettings *settings);
+
+signals:
+    void sourceChanged(int source);     /*! Signal to show changed, a receiver::scope_source. */
+
+private slots:
+    void on_sourceCombo_currentIndexChanged(int index);
+    void on_triggerCombo_currentIndexChanged(int index);
+    void on_levelSpin_valueChanged(double value);
+
+private:
+    Ui::DockScope *ui;        /*! The Qt designer UI file. */
+};
+
+#endif // DOCKSCOPE_H
@@ -0,0 +1,375 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QStandardPaths>
+#include <QStringList>
+
+#include "iq_catalog.h"
+
+#define CATALOG_CACHE_FILE  "iq_catalog.json"
+#define CATALOG_RESCAN_MS   250     /* delay to coalesce directory changes */
+
+
+IqCatalog::IqCatalog(QObject *parent) :
+    QAbstractListModel(parent),
+    m_cacheDirty(false)
+{
+    m_dir.setNameFilters(QStringList() << "*.raw" << "*.sigmf-data");
+    m_dir.setFilter(QDir::Files);
+    m_dir.setSorting(QDir::Unsorted);
+
+    m_rescanTimer.setSingleShot(true);
+    m_rescanTimer.setInterval(CATALOG_RESCAN_MS);
+    connect(&m_rescanTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+    connect(&m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(directoryChanged()));
+
+    QString cache_dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cache_dir.isEmpty() && QDir().mkpath(cache_dir))
+        m_cacheFile = cache_dir + "/" CATALOG_CACHE_FILE;
+
+    loadCache();
+}
+
+IqCatalog::~IqCatalog()
+{
+    saveCache();
+}
+
+/*! \brief Show the recordings in a new directory. */
+void IqCatalog::setDirectory(const QString &path)
+{
+    if (!m_watcher.directories().isEmpty())
+        m_watcher.removePaths(m_watcher.directories());
+    saveCache();
+
+    beginResetModel();
+    m_dir.setPath(path);
+    m_dir.refresh();
+    m_files.clear();
+
+    QFileInfoList infos = m_dir.entryInfoList();
+    m_files.reserve(infos.size());
+    for (const QFileInfo &info : infos)
+        m_files.append(scanFile(info));
+    std::sort(m_files.begin(), m_files.end(),
+              [](const IqRecording &a, const IqRecording &b) { return a.name < b.name; });
+    endResetModel();
+
+    // Entries of the previous directory are not needed any more
+    pruneCache();
+
+    m_watcher.addPath(m_dir.absolutePath());
+}
+
+int IqCatalog::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_files.size();
+}
+
+QVariant IqCatalog::data(const QModelIndex &index, int role) const
+{
+    const IqRecording *rec = recording(index.row());
+    if (!index.isValid() || !rec)
+        return QVariant();
+
+    if (role == Qt::DisplayRole)
+        return rec->name;
+
+    if (role == Qt::ToolTipRole)
+    {
+        QStringList lines;
+        if (rec->center_freq > 0)
+            lines << tr("Frequency: %1 kHz").arg(rec->center_freq / 1.0e3, 0, 'f', 3);
+        if (rec->sample_rate > 0)
+        {
+            qint64 len = rec->duration();
+            lines << tr("Sample rate: %1 ksps").arg(rec->sample_rate / 1.0e3, 0, 'f', 3);
+            lines << tr("Duration: %1:%2:%3")
+                     .arg(len / 3600, 2, 10, QChar('0'))
+                     .arg((len / 60) % 60, 2, 10, QChar('0'))
+                     .arg(len % 60, 2, 10, QChar('0'));
+        }
+        lines << tr("Size: %1 MB").arg(rec->size / 1048576.0, 0, 'f', 1);
+        if (!rec->datetime.isEmpty())
+            lines << tr("Recorded: %1").arg(rec->datetime);
+        if (!rec->hw.isEmpty())
+            lines << tr("Hardware: %1").arg(rec->hw);
+        if (!rec->description.isEmpty())
+            lines << rec->description;
+        return lines.join("\n");
+    }
+
+    return QVariant();
+}
+
+/*! \brief Recording in a row, or nullptr if the row is out of range. */
+const IqRecording *IqCatalog::recording(int row) const
+{
+    if (row < 0 || row >= m_files.size())
+        return nullptr;
+
+    return &m_files[row];
+}
+
+/*! \brief Row of a file name, or -1 if it is not in the list. */
+int IqCatalog::findRow(const QString &name) const
+{
+    auto it = std::lower_bound(m_files.begin(), m_files.end(), name,
+                               [](const IqRecording &rec, const QString &n) { return rec.name < n; });
+    if (it == m_files.end() || it->name != name)
+        return -1;
+
+    return (int)(it - m_files.begin());
+}
+
+/*! \brief Rescan the directory and update the rows that changed. */
+void IqCatalog::refresh()
+{
+    // QDir caches the listing and the file sizes and times
+    m_dir.refresh();
+    QFileInfoList infos = m_dir.entryInfoList();
+    std::sort(infos.begin(), infos.end(),
+              [](const QFileInfo &a, const QFileInfo &b) { return a.fileName() < b.fileName(); });
+
+    // Merge the sorted listing into the sorted rows
+    int row = 0;
+    int k = 0;
+    while (row < m_files.size() || k < infos.size())
+    {
+        if (k >= infos.size() || (row < m_files.size() && m_files[row].name < infos[k].fileName()))
+        {
+            beginRemoveRows(QModelIndex(), row, row);
+            m_files.remove(row);
+            endRemoveRows();
+        }
+        else if (row >= m_files.size() || infos[k].fileName() < m_files[row].name)
+        {
+            beginInsertRows(QModelIndex(), row, row);
+            m_files.insert(row, scanFile(infos[k]));
+            endInsertRows();
+            row++;
+            k++;
+        }
+        else
+        {
+            const IqRecording &rec = m_files[row];
+            if (rec.size != infos[k].size() ||
+                rec.mtime != infos[k].lastModified().toMSecsSinceEpoch())
+                updateRow(row, scanFile(infos[k]));
+            row++;
+            k++;
+        }
+    }
+}
+
+/*! \brief Update a single file, for example one being recorded. */
+void IqCatalog::refreshFile(const QString &name)
+{
+    int row = findRow(name);
+    QFileInfo info(m_dir, name);
+
+    if (row < 0 || !info.exists())
+    {
+        refresh();
+        return;
+    }
+
+    const IqRecording &rec = m_files[row];
+    if (rec.size != info.size() || rec.mtime != info.lastModified().toMSecsSinceEpoch())
+        updateRow(row, scanFile(info));
+}
+
+void IqCatalog::directoryChanged()
+{
+    m_rescanTimer.start();
+}
+
+/*! \brief Metadata of a file, from the cache if the file has not changed. */
+IqRecording IqCatalog::scanFile(const QFileInfo &info)
+{
+    const QString path = info.absoluteFilePath();
+    const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+
+    auto it = m_cache.constFind(path);
+    if (it != m_cache.constEnd() && it->size == info.size() && it->mtime == mtime)
+        return *it;
+
+    IqRecording rec;
+    rec.name = info.fileName();
+    rec.size = info.size();
+    rec.mtime = mtime;
+    parseFileName(rec);
+    if (rec.name.endsWith(".sigmf-data"))
+        parseSigMF(rec, path.left(path.length() - 4) + "meta");
+
+    m_cache.insert(path, rec);
+    m_cacheDirty = true;
+
+    return rec;
+}
+
+/*! \brief Extract sample rate and center frequency from the file name.
+ *
+ * gqrx_yyyyMMdd_hhmmss_freq_samprate_fc.raw
+ */
+void IqCatalog::parseFileName(IqRecording &rec) const
+{
+    QStringList list = rec.name.split('_');
+
+    if (list.size() < 5)
+        return;
+
+    bool   ok;
+    qint64 val;
+
+    val = list.at(4).toLongLong(&ok);
+    if (ok)
+        rec.sample_rate = val;
+    val = list.at(3).toLongLong(&ok);
+    if (ok)
+        rec.center_freq = val;
+}
+
+/*! \brief Read metadata from a SigMF meta file, overriding the file name. */
+void IqCatalog::parseSigMF(IqRecording &rec, const QString &meta_path) const
+{
+    QFile file(meta_path);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    QJsonObject global = root["global"].toObject();
+
+    if (global.contains("core:sample_rate"))
+        rec.sample_rate = (qint64)global["core:sample_rate"].toDouble();
+    rec.datatype = global["core:datatype"].toString();
+    rec.description = global["core:description"].toString();
+    rec.hw = global["core:hw"].toString();
+
+    // e.g. cf32_le, ci16_le, cu8
+    QRegularExpressionMatch m = QRegularExpression("^([cr])[fiu](\\d+)").match(rec.datatype);
+    if (m.hasMatch())
+        rec.bytes_per_sample = m.captured(2).toInt() / 8 * (m.captured(1) == "c" ? 2 : 1);
+    if (rec.bytes_per_sample <= 0)
+        rec.bytes_per_sample = 8;
+
+    QJsonArray captures = root["captures"].toArray();
+    if (!captures.isEmpty())
+    {
+        QJsonObject capture = captures.first().toObject();
+        if (capture.contains("core:frequency"))
+            rec.center_freq = (qint64)capture["core:frequency"].toDouble();
+        rec.datetime = capture["core:datetime"].toString();
+    }
+}
+
+void IqCatalog::updateRow(int row, const IqRecording &rec)
+{
+    m_files[row] = rec;
+    emit dataChanged(index(row), index(row));
+}
+
+void IqCatalog::loadCache()
+{
+    QFile file(m_cacheFile);
+    if (m_cacheFile.isEmpty() || !file.open(QIODevice::ReadOnly))
+        return;
+
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    for (auto it = root.constBegin(); it != root.constEnd(); ++it)
+    {
+        QJsonObject obj = it.value().toObject();
+        IqRecording rec;
+
+        rec.name = QFileInfo(it.key()).fileName();
+        rec.size = (qint64)obj["size"].toDouble();
+        rec.mtime = (qint64)obj["mtime"].toDouble();
+        rec.sample_rate = (qint64)obj["sample_rate"].toDouble();
+        rec.center_freq = (qint64)obj["center_freq"].toDouble();
+        rec.bytes_per_sample = obj["bytes_per_sample"].toInt(8);
+        rec.datatype = obj["datatype"].toString();
+        rec.datetime = obj["datetime"].toString();
+        rec.description = obj["description"].toString();
+        rec.hw = obj["hw"].toString();
+        m_cache.insert(it.key(), rec);
+    }
+}
+
+/*! \brief Drop cache entries of files that are not shown. */
+void IqCatalog::pruneCache()
+{
+    const QString dir = m_dir.absolutePath() + "/";
+
+    for (auto it = m_cache.begin(); it != m_cache.end(); )
+    {
+        if (it.key() == dir + it->name && findRow(it->name) >= 0)
+        {
+            ++it;
+        }
+        else
+        {
+            it = m_cache.erase(it);
+            m_cacheDirty = true;
+        }
+    }
+}
+
+/*! \brief Write the cache of the files shown in the current directory. */
+void IqCatalog::saveCache()
+{
+    if (!m_cacheDirty || m_cacheFile.isEmpty())
+        return;
+
+    const QString dir = m_dir.absolutePath() + "/";
+    QJsonObject root;
+    for (auto it = m_cache.constBegin(); it != m_cache.constEnd(); ++it)
+    {
+        const IqRecording &rec = it.value();
+        if (it.key() != dir + rec.name || findRow(rec.name) < 0)
+            continue;
+
+        root.insert(it.key(), QJsonObject {
+            {"size", rec.size},
+            {"mtime", rec.mtime},
+            {"sample_rate", rec.sample_rate},
+            {"center_freq", rec.center_freq},
+            {"bytes_per_sample", rec.bytes_per_sample},
+            {"datatype", rec.datatype},
+            {"datetime", rec.datetime},
+            {"description", rec.description},
+            {"hw", rec.hw},
+        });
+    }
+
+    QFile file(m_cacheFile);
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) < 0)
+        qDebug() << "Can not write I/Q catalog cache" << m_cacheFile;
+    else
+        m_cacheDirty = false;
+}
@@ -0,0 +1,111 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef IQ_CATALOG_H
+#define IQ_CATALOG_H
+
+#include <QAbstractListModel>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+
+/*! \brief Metadata of one I/Q recording. */
+struct IqRecording
+{
+    QString name;               /*!< File name relative to the directory. */
+    qint64  size = 0;           /*!< File size in bytes. */
+    qint64  mtime = 0;          /*!< Last modification, ms since epoch. */
+    qint64  sample_rate = 0;    /*!< Sample rate, 0 if unknown. */
+    qint64  center_freq = 0;    /*!< Center frequency, 0 if unknown. */
+    int     bytes_per_sample = 8;
+    QString datatype;           /*!< SigMF core:datatype. */
+    QString datetime;           /*!< SigMF core:datetime of the first capture. */
+    QString description;        /*!< SigMF core:description. */
+    QString hw;                 /*!< SigMF core:hw. */
+
+    /*! \brief Duration in seconds, 0 if the sample rate is unknown. */
+    qint64 duration() const
+    {
+        return sample_rate > 0 ? size / (sample_rate * bytes_per_sample) : 0;
+    }
+};
+
+
+/*! \brief List model of the I/Q recordings in a directory.
+ *
+ * The directory is watched with QFileSystemWatcher and rescanned only when
+ * it changes. Rows are inserted and removed individually, so views keep
+ * their selection and scroll position. Metadata parsed from file names and
+ * SigMF meta files is kept in a cache in the user cache directory, keyed by
+ * path, size and modification time, so files are parsed only once.
+ */
+class IqCatalog : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit IqCatalog(QObject *parent = nullptr);
+    ~IqCatalog() override;
+
+    void setDirectory(const QString &path);
+    QString directory() const { return m_dir.path(); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+
+    const IqRecording *recording(int row) const;
+    int findRow(const QString &name) const;
+
+public slots:
+    void refresh();
+    void refreshFile(const QString &name);
+
+private slots:
+    void directoryChanged();
+
+private:
+    IqRecording scanFile(const QFileInfo &info);
+    void parseFileName(IqRecording &rec) const;
+    void parseSigMF(IqRecording &rec, const QString &meta_path) const;
+    void updateRow(int row, const IqRecording &rec);
+
+    void loadCache();
+    void saveCache();
+    void pruneCache();
+
+    QDir                        m_dir;
+    QVector<IqRecording>        m_files;    /*!< Sorted by name. */
+    QFileSystemWatcher          m_watcher;
+    QTimer                      m_rescanTimer;  /*!< Coalesces watcher signals. */
+
+    QString                     m_cacheFile;
+    QHash<QString, IqRecording> m_cache;    /*!< Keyed by absolute path. */
+    bool                        m_cacheDirty;
+};
+
+#endif // IQ_CATALOG_H
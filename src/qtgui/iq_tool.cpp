@@ -28,7 +28,6 @@
 #include <QPalette>
 #include <QString>
 #include <QStringList>
-#include <QScrollBar>
 
 #include <math.h>
 
@@ -51,8 +50,12 @@ CIqTool::CIqTool(QWidget *parent) :
 
     //ui->recDirEdit->setText(QDir::currentPath());
 
-    recdir = new QDir(QDir::homePath(), "*.raw");
-    recdir->setNameFilters(recdir->nameFilters() << "*.sigmf-data");
+    recdir = new QDir(QDir::homePath());
+
+    catalog = new IqCatalog(this);
+    ui->listView->setModel(catalog);
+    connect(ui->listView->selectionModel(), SIGNAL(currentChanged(QModelIndex,QModelIndex)),
+            this, SLOT(selectionChanged(QModelIndex)));
 
     error_palette = new QPalette();
     error_palette->setColor(QPalette::Text, Qt::red);
@@ -87,18 +90,29 @@ void CIqTool::setSampleRate(qint64 sr)
 
 
 /*! \brief Slot activated when the user selects a file. */
-void CIqTool::on_listWidget_currentTextChanged(const QString &currentText)
+void CIqTool::selectionChanged(const QModelIndex &current)
 {
+    const IqRecording *rec = catalog->recording(current.row());
 
-    current_file = currentText;
-    QFileInfo info(*recdir, current_file);
+    if (!rec)
+    {
+        current_file.clear();
+        rec_len = 0;
+        refreshTimeWidgets();
+        return;
+    }
 
-    parseFileName(currentText);
-    rec_len = (int)(info.size() / (sample_rate * bytes_per_sample));
+    current_file = rec->name;
+    if (rec->sample_rate > 0)
+        sample_rate = rec->sample_rate;
+    if (rec->center_freq > 0)
+        center_freq = rec->center_freq;
+    bytes_per_sample = rec->bytes_per_sample;
+    datatype = rec->datatype;
+    rec_len = (int)(rec->size / (sample_rate * bytes_per_sample));
 
     // Get duration of selected recording and update label
     refreshTimeWidgets();
-
 }
 
 /*! \brief Start/stop playback */
@@ -112,7 +126,7 @@ void CIqTool::on_playButton_clicked(bool checked)
         {
             QMessageBox msg_box;
             msg_box.setIcon(QMessageBox::Critical);
-            if (ui->listWidget->count() == 0)
+            if (catalog->rowCount() == 0)
             {
                 msg_box.setText(tr("There are no I/Q files in the current directory."));
             }
@@ -126,16 +140,16 @@ void CIqTool::on_playButton_clicked(bool checked)
         }
         else
         {
-            ui->listWidget->setEnabled(false);
+            ui->listView->setEnabled(false);
             ui->recButton->setEnabled(false);
             emit startPlayback(recdir->absoluteFilePath(current_file),
-                               (float)sample_rate, center_freq);
+                               (float)sample_rate, center_freq, datatype);
         }
     }
     else
     {
         emit stopPlayback();
-        ui->listWidget->setEnabled(true);
+        ui->listView->setEnabled(true);
         ui->recButton->setEnabled(true);
         ui->slider->setValue(0);
     }
@@ -150,7 +164,7 @@ void CIqTool::on_playButton_clicked(bool checked)
 void CIqTool::cancelPlayback()
 {
     ui->playButton->setChecked(false);
-    ui->listWidget->setEnabled(true);
+    ui->listView->setEnabled(true);
     ui->recButton->setEnabled(true);
     is_playing = false;
 }
@@ -176,8 +190,9 @@ void CIqTool::on_recButton_clicked(bool checked)
         ui->playButton->setEnabled(false);
         emit startRecording(recdir->path(), ui->formatCombo->currentText());
 
-        refreshDir();
-        ui->listWidget->setCurrentRow(ui->listWidget->count()-1);
+        // select the new file
+        catalog->refresh();
+        ui->listView->setCurrentIndex(catalog->index(catalog->rowCount() - 1));
     }
     else
     {
@@ -218,7 +233,7 @@ void CIqTool::closeEvent(QCloseEvent *event)
 void CIqTool::showEvent(QShowEvent * event)
 {
     Q_UNUSED(event);
-    refreshDir();
+    catalog->refresh();
     refreshTimeWidgets();
     timer->start(1000);
 }
@@ -259,6 +274,7 @@ void CIqTool::on_recDirEdit_textChanged(const QString &dir)
         ui->recDirEdit->setPalette(QPalette());  // Clear custom color
         recdir->setPath(dir);
         recdir->cd(dir);
+        catalog->setDirectory(recdir->absolutePath());
         //emit newRecDirSelected(dir);
     }
     else
@@ -281,8 +297,6 @@ void CIqTool::on_recDirButton_clicked()
 
 void CIqTool::timeoutFunction(void)
 {
-    refreshDir();
-
     if (is_playing)
     {
         // advance slider with one second
@@ -295,33 +309,14 @@ void CIqTool::timeoutFunction(void)
             refreshTimeWidgets();
         }
     }
-    if (is_recording)
-        refreshTimeWidgets();
-}
-
-/*! \brief Refresh list of files in current working directory. */
-void CIqTool::refreshDir()
-{
-    int selection = ui->listWidget->currentRow();
-    QScrollBar * sc = ui->listWidget->verticalScrollBar();
-    int lastScroll = sc->sliderPosition();
-
-    recdir->refresh();
-    QStringList files = recdir->entryList();
-
-    ui->listWidget->blockSignals(true);
-    ui->listWidget->clear();
-    ui->listWidget->insertItems(0, files);
-    ui->listWidget->setCurrentRow(selection);
-    sc->setSliderPosition(lastScroll);
-    ui->listWidget->blockSignals(false);
-
     if (is_recording)
     {
-        // update rec_len; if the file being recorded is the one selected
-        // in the list, the length will update periodically
-        QFileInfo info(*recdir, current_file);
-        rec_len = (int)(info.size() / (sample_rate * bytes_per_sample));
+        // the length of the file being recorded is updated periodically
+        catalog->refreshFile(current_file);
+        const IqRecording *rec = catalog->recording(catalog->findRow(current_file));
+        if (rec)
+            rec_len = (int)(rec->size / (sample_rate * bytes_per_sample));
+        refreshTimeWidgets();
     }
 }
 
@@ -358,26 +353,3 @@ void CIqTool::refreshTimeWidgets(void)
                            .arg(ls, 2, 10, QChar('0')));
 }
 
-
-/*! \brief Extract sample rate and offset frequency from file name */
-void CIqTool::parseFileName(const QString &filename)
-{
-    bool   sr_ok;
-    qint64 sr;
-    bool   center_ok;
-    qint64 center;
-
-    QStringList list = filename.split('_');
-
-    if (list.size() < 5)
-        return;
-
-    // gqrx_yymmdd_hhmmss_freq_samprate_fc.raw
-    sr = list.at(4).toLongLong(&sr_ok);
-    center = list.at(3).toLongLong(&center_ok);
-
-    if (sr_ok)
-        sample_rate = sr;
-    if (center_ok)
-        center_freq = center;
-}
@@ -26,12 +26,15 @@
 #include <QCloseEvent>
 #include <QDialog>
 #include <QDir>
+#include <QModelIndex>
 #include <QPalette>
 #include <QSettings>
 #include <QShowEvent>
 #include <QString>
 #include <QTimer>
 
+#include "iq_catalog.h"
+
 namespace Ui {
     class CIqTool;
 }
@@ -64,7 +67,8 @@ public:
 signals:
     void startRecording(const QString recdir, const QString format);
     void stopRecording();
-    void startPlayback(const QString filename, float samprate, qint64 center_freq);
+    void startPlayback(const QString filename, float samprate, qint64 center_freq,
+                       const QString datatype);
     void stopPlayback();
     void seek(qint64 seek_pos);
 
@@ -78,22 +82,22 @@ private slots:
     void on_recButton_clicked(bool checked);
     void on_playButton_clicked(bool checked);
     void on_slider_valueChanged(int value);
-    void on_listWidget_currentTextChanged(const QString &currentText);
+    void selectionChanged(const QModelIndex &current);
     void timeoutFunction(void);
 
 private:
-    void refreshDir(void);
     void refreshTimeWidgets(void);
-    void parseFileName(const QString &filename);
 
 private:
     Ui::CIqTool *ui;
 
     QDir        *recdir;
+    IqCatalog   *catalog;       /*!< Recordings in recdir. */
     QTimer      *timer;
     QPalette    *error_palette; /*!< Palette used to indicate an error. */
 
     QString current_file;      /*!< Selected file in file browser. */
+    QString datatype;          /*!< SigMF datatype of current_file, empty for cf32. */
 
     bool    is_recording;
     bool    is_playing;
@@ -33,10 +33,14 @@
 #include <QDebug>
 #include <QFont>
 #include <QPainter>
+#include <QScreen>
 #include <QtGlobal>
+#include <QTimer>
 #include <QToolTip>
+#include <QWindow>
 #include "plotter.h"
 #include "bandplan.h"
+#include "interfaces/trace.h"
 #include "bookmarks.h"
 #include "dxc_spots.h"
 #include <volk/volk.h>
@@ -53,6 +57,8 @@ Q_LOGGING_CATEGORY(plotter, "plotter")
 
 #define FILTER_WIDTH_MIN_HZ 200
 
+#define WF_SHED_DECIM 2     // frames per waterfall line in auto mode while shedding load
+
 // Colors of type QRgb in 0xAARRGGBB format (unsigned int)
 #define PLOTTER_BGD_COLOR           0xFF1F1D1D
 #define PLOTTER_GRID_COLOR          0x80606060
@@ -123,6 +129,10 @@ CPlotter::CPlotter(QWidget *parent) : QFrame(parent)
     m_CursorCaptureDelta = CUR_CUT_DELTA;
     m_WaterfallMode = WATERFALL_MODE_MAX;
     m_PlotMode = PLOT_MODE_MAX;
+    m_UserPlotMode = PLOT_MODE_MAX;
+    m_UserPeakDetect = false;
+    m_LoadShed = 0;
+    m_wfShedCount = 0;
     m_PlotScale = PLOT_SCALE_DBFS;
     m_PlotPerHz = false;
 
@@ -147,7 +157,8 @@ CPlotter::CPlotter(QWidget *parent) : QFrame(parent)
     m_CursorCaptured = NOCAP;
     m_Running = false;
     m_DrawOverlay = true;
-    m_2DPixmap = QPixmap();
+    m_2DImage = QImage();
+    m_TraceAntialias = true;
     m_OverlayPixmap = QPixmap();
     m_WaterfallImage = QImage();
     m_Size = QSize(0,0);
@@ -167,6 +178,11 @@ CPlotter::CPlotter(QWidget *parent) : QFrame(parent)
     // always update waterfall
     tlast_wf_ms = 0;
     tlast_plot_drawn_ms = 0;
+    m_PlotDirty = false;
+    m_FrameScheduled = false;
+    m_PlotXmin = 0;
+    m_PlotXmax = 0;
+    m_HistBinsDisplayed = 0;
     tlast_wf_drawn_ms = 0;
     wf_valid_since_ms = 0;
     msec_per_wfline = 0;
@@ -608,7 +624,7 @@ quint64 CPlotter::getWfTimeRes() const
         return msec_per_wfline;
     else
         // Auto mode, interval is rounded down to nearest int div
-        return 1000 / fft_rate;
+        return (m_LoadShed & SHED_WATERFALL ? WF_SHED_DECIM : 1) * 1000 / fft_rate;
 }
 
 void CPlotter::setFftRate(int rate_hz)
@@ -689,7 +705,7 @@ void CPlotter::mousePressEvent(QMouseEvent * event)
                     {
                         // Find the data value of the click y()
 
-                        const qreal plotHeight = m_2DPixmap.height();
+                        const qreal plotHeight = m_2DImage.height();
                         const float panddBGainFactor = (float)plotHeight / fabsf(m_PandMaxdB - m_PandMindB);
                         const float vlog = m_PandMaxdB - py / panddBGainFactor;
                         const float v = powf(10.0f, vlog / 10.0f);
@@ -892,7 +908,11 @@ void CPlotter::zoomOnXAxis(float level)
 
 void CPlotter::setPlotMode(int mode)
 {
-    m_PlotMode = (ePlotMode)mode;
+    m_UserPlotMode = (ePlotMode)mode;
+    if ((m_LoadShed & SHED_HISTOGRAM_PEAKS) && m_UserPlotMode == PLOT_MODE_HISTOGRAM)
+        m_PlotMode = PLOT_MODE_AVG;
+    else
+        m_PlotMode = m_UserPlotMode;
     m_MaxHoldValid = false;
     m_MinHoldValid = false;
     // Do not need to invalidate IIR data when switching modes
@@ -1021,8 +1041,8 @@ void CPlotter::resizeEvent(QResizeEvent* )
         m_OverlayPixmap = QPixmap(w, plotHeight);
         m_OverlayPixmap.fill(Qt::transparent);
 
-        m_2DPixmap = QPixmap(w, plotHeight);
-        m_2DPixmap.fill(QColor::fromRgba(PLOTTER_BGD_COLOR));
+        m_2DImage = QImage(w, plotHeight, QImage::Format_RGB32);
+        m_2DImage.fill(QColor::fromRgba(PLOTTER_BGD_COLOR));
 
         // No waterfall, use null image
         if (wfHeight == 0)
@@ -1072,23 +1092,45 @@ void CPlotter::resizeEvent(QResizeEvent* )
 // Called by QT when screen needs to be redrawn
 void CPlotter::paintEvent(QPaintEvent *)
 {
+    // Render the plot here rather than for every FFT frame. Qt only paints
+    // exposed widgets, so nothing is rendered while the plotter is hidden,
+    // and renders are limited to the refresh rate of the screen.
+    if (m_PlotDirty && !m_2DImage.isNull())
+    {
+        const quint64 tnow_ms = QDateTime::currentMSecsSinceEpoch();
+        const quint64 frame_ms = frameInterval();
+
+        if (tnow_ms >= tlast_plot_drawn_ms + frame_ms)
+        {
+            drawPlot();
+        }
+        else if (!m_FrameScheduled)
+        {
+            m_FrameScheduled = true;
+            QTimer::singleShot(int(tlast_plot_drawn_ms + frame_ms - tnow_ms), this, [this]() {
+                m_FrameScheduled = false;
+                update();
+            });
+        }
+    }
+
     // Pixmap resolution scales with DPR. Here, they are rescaled to fit the
     // the CPlotter resolution.
 
     QPainter painter(this);
 
     int plotHeightT = 0;
-    if (!m_2DPixmap.isNull())
+    if (!m_2DImage.isNull())
     {
-        const int plotWidthS = m_2DPixmap.width();
-        const int plotHeightS = m_2DPixmap.height();
+        const int plotWidthS = m_2DImage.width();
+        const int plotHeightS = m_2DImage.height();
         const QRectF plotRectS(0.0, 0.0, plotWidthS, plotHeightS);
 
         const int plotWidthT = qRound((qreal)plotWidthS / m_DPR);
         plotHeightT = qRound((qreal)plotHeightS / m_DPR);
         const QRectF plotRectT(0.0, 0.0, plotWidthT, plotHeightT);
 
-        painter.drawPixmap(plotRectT, m_2DPixmap, plotRectS);
+        painter.drawImage(plotRectT, m_2DImage, plotRectS);
     }
 
     if (!m_WaterfallImage.isNull())
@@ -1097,17 +1139,152 @@ void CPlotter::paintEvent(QPaintEvent *)
     }
 }
 
+/*
+ * Direct raster rendering into the RGB32 plot image. Colors carry their own
+ * alpha, which is blended here since the image itself is opaque.
+ */
+struct RasterTarget
+{
+    QRgb   *bits;
+    int     stride;     // pixels per line
+    int     width;
+    int     height;
+};
+
+static inline QRgb blendRgb(QRgb dst, QRgb src, int alpha)
+{
+    const int a = alpha + (alpha >> 7);     // 0..256
+    return qRgb(qRed(dst) + (((qRed(src) - qRed(dst)) * a) >> 8),
+                qGreen(dst) + (((qGreen(src) - qGreen(dst)) * a) >> 8),
+                qBlue(dst) + (((qBlue(src) - qBlue(dst)) * a) >> 8));
+}
+
+// Fill rows [y0, y1) of column x
+static inline void fillSpan(const RasterTarget &rt, int x, int y0, int y1, QRgb color)
+{
+    const int alpha = qAlpha(color);
+
+    y0 = std::max(y0, 0);
+    y1 = std::min(y1, rt.height);
+    if (x < 0 || x >= rt.width || y0 >= y1 || alpha == 0)
+        return;
+
+    QRgb *p = rt.bits + y0 * rt.stride + x;
+    if (alpha == 255)
+    {
+        const QRgb opaque = color | 0xff000000;
+        for (int y = y0; y < y1; y++, p += rt.stride)
+            *p = opaque;
+    }
+    else
+    {
+        for (int y = y0; y < y1; y++, p += rt.stride)
+            *p = blendRgb(*p, color, alpha);
+    }
+}
+
+// Diagonal hatch in rows [y0, y1) of column x, like Qt::BDiagPattern
+static inline void hatchSpan(const RasterTarget &rt, int x, int y0, int y1, QRgb color)
+{
+    y0 = std::max(y0, 0);
+    y1 = std::min(y1, rt.height);
+    if (x < 0 || x >= rt.width)
+        return;
+
+    for (int y = y0 + ((8 - (x + y0) % 8) % 8); y < y1; y += 8)
+        rt.bits[y * rt.stride + x] = blendRgb(rt.bits[y * rt.stride + x], color, qAlpha(color));
+}
+
+static inline void blendPixel(const RasterTarget &rt, int x, int y, QRgb color, int alpha)
+{
+    if (x < 0 || x >= rt.width || y < 0 || y >= rt.height || alpha <= 0)
+        return;
+
+    rt.bits[y * rt.stride + x] = blendRgb(rt.bits[y * rt.stride + x], color, alpha);
+}
+
+/*
+ * Draw a trace of y values starting at column x0. Each column is a vertical
+ * span joining the previous value to the current one. With antialiasing the
+ * end pixels of a span are weighted by their coverage.
+ */
+static void drawTrace(const RasterTarget &rt, int x0, const float *y, int npts,
+                      QRgb color, bool antialias)
+{
+    const int alpha = qAlpha(color);
+    float yPrev = npts > 0 ? y[0] : 0.0f;
+
+    for (int i = 0; i < npts; i++)
+    {
+        const int x = x0 + i;
+        const float lo = std::min(yPrev, y[i]);
+        const float hi = std::max(yPrev, y[i]);
+        yPrev = y[i];
+
+        if (!antialias)
+        {
+            fillSpan(rt, x, qRound(lo), qRound(hi) + 1, color);
+            continue;
+        }
+
+        const int ilo = (int)lo;
+        const int ihi = (int)hi;
+        blendPixel(rt, x, ilo, color, qRound((1.0f - (lo - (float)ilo)) * (float)alpha));
+        fillSpan(rt, x, ilo + 1, ihi + 1, color);
+        blendPixel(rt, x, ihi + 1, color, qRound((hi - (float)ihi) * (float)alpha));
+    }
+}
+
+// Catch up with the FFT data received while hidden
+void CPlotter::showEvent(QShowEvent *event)
+{
+    QFrame::showEvent(event);
+
+    if (!m_IIRValid && m_fftDataSize > 0)
+    {
+        memcpy(m_fftIIR.data(), m_fftData.data(), m_fftDataSize * sizeof(float));
+        m_IIRValid = true;
+    }
+
+    // No waterfall lines were added while hidden, restart the line timing
+    // rather than catching up, and don't show times for the older lines.
+    const quint64 tnow = QDateTime::currentMSecsSinceEpoch();
+    wf_epoch = tnow;
+    wf_count = 0;
+    wf_avg_count = 0;
+    wf_valid_since_ms = tnow;
+    clearWaterfallBuf();
+
+    draw(false);
+}
+
+// Shortest time between two renders of the plot, one refresh of the screen
+quint64 CPlotter::frameInterval()
+{
+    const QWindow *win = window()->windowHandle();
+    const qreal rate = win && win->screen() ? win->screen()->refreshRate() : 0.0;
+
+    if (rate < 1.0)
+        return PLOTTER_UPDATE_LIMIT_MS;
+
+    return (quint64)std::max(qRound(1000.0 / rate) - 1, 1);
+}
+
 // Called to update spectrum data for displaying on the screen
 void CPlotter::draw(bool newData)
 {
+    TRACE_SCOPE("CPlotter::draw", "gui");
     qint32        i, j;
     float         histMax;
-    QFontMetricsF metrics(m_Font);
+
+    // Nothing is shown while hidden, showEvent() draws again
+    if (!isVisible())
+        return;
 
     // No fft data yet? Draw overlay if needed and return.
     if (m_fftDataSize == 0)
     {
-        if (!m_2DPixmap.isNull()) {
+        if (!m_2DImage.isNull()) {
             // Update the overlay if needed
             if (m_DrawOverlay)
             {
@@ -1116,8 +1293,8 @@ void CPlotter::draw(bool newData)
             }
 
             // Draw overlay over plot
-            m_2DPixmap.fill(QColor::fromRgba(PLOTTER_BGD_COLOR));
-            QPainter painter(&m_2DPixmap);
+            m_2DImage.fill(QColor::fromRgba(PLOTTER_BGD_COLOR));
+            QPainter painter(&m_2DImage);
             painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
             painter.drawPixmap(QPointF(0.0, 0.0), m_OverlayPixmap);
             update();
@@ -1126,18 +1303,11 @@ void CPlotter::draw(bool newData)
         return;
     }
 
-    QPointF avgLineBuf[MAX_SCREENSIZE];
-    QPointF maxLineBuf[MAX_SCREENSIZE];
-
     const quint64 tnow_ms = QDateTime::currentMSecsSinceEpoch();
 
     // Pixmaps might be null, so scale up m_Size to get width.
     const qreal w = m_Size.width() * m_DPR;
-    const qreal plotHeight = m_2DPixmap.height();
-    const qreal shadowOffset = metrics.height() / 20.0;
 
-    // Scale plotter for graph height
-    const float panddBGainFactor = (float)plotHeight / fabsf(m_PandMaxdB - m_PandMindB);
     // Scale waterfall and histogram for colormap
     const float wfdBGainFactor = 256.0f / fabsf(m_WfMaxdB - m_WfMindB);
 
@@ -1166,11 +1336,7 @@ void CPlotter::draw(bool newData)
     const float frameTime = 1.0f / (float)fft_rate;
 
     // Do plotter work only if visible.
-    const bool plotterVisible = (!m_2DPixmap.isNull());
-
-    // Limit plotter drawing rate.
-    const bool drawPlotter = (plotterVisible
-        && tnow_ms >= tlast_plot_drawn_ms + PLOTTER_UPDATE_LIMIT_MS);
+    const bool plotterVisible = (!m_2DImage.isNull());
 
     // Do not waste time with histogram calculations unless in this mode.
     const bool doHistogram = (plotterVisible && m_PlotMode == PLOT_MODE_HISTOGRAM && (!m_histIIRValid || newData));
@@ -1188,22 +1354,10 @@ void CPlotter::draw(bool newData)
     // Bins / dB
     const float histdBGainFactor = (float)histBinsDisplayed / fabsf(m_PandMaxdB - m_PandMindB);
 
-    // Show max and average highlights on histogram if it would not be too
-    // cluttered
-    const bool showHistHighlights = histBinsDisplayed >= MAX_HISTOGRAM_SIZE / 2;
-
     // Waterfall is advanced only if visible and running, and if there is new
     // data. Repaints for other reasons do not require any action here.
     const bool doWaterfall = !m_WaterfallImage.isNull() && m_Running && newData;
 
-    // Draw avg line, except in max mode. Suppress if it would clutter histogram.
-    const bool doAvgLine = m_PlotMode != PLOT_MODE_MAX
-                           && (m_PlotMode != PLOT_MODE_HISTOGRAM || showHistHighlights);
-
-    // Draw max line, except in avg and histogram modes
-    const bool doMaxLine = m_PlotMode != PLOT_MODE_AVG
-                           && m_PlotMode != PLOT_MODE_HISTOGRAM;
-
     // Initialize results
     if (doHistogram)
         memset(m_histogram, 0, sizeof(m_histogram));
@@ -1396,7 +1550,10 @@ void CPlotter::draw(bool newData)
         }
 
         // is it time to update waterfall? msec_per_wfline is 0 in auto mode.
-        if (tnow_ms - wf_epoch > wf_count * msec_per_wfline)
+        bool wfLineDue = tnow_ms - wf_epoch > wf_count * msec_per_wfline;
+        if (wfLineDue && msec_per_wfline == 0 && (m_LoadShed & SHED_WATERFALL))
+            wfLineDue = ++m_wfShedCount % WF_SHED_DECIM == 0;
+        if (wfLineDue)
         {
             ++wf_count;
 
@@ -1472,285 +1629,308 @@ void CPlotter::draw(bool newData)
         m_histMaxIIR = m_histMaxIIR * (1.0f - histMaxAlpha) + histMax * histMaxAlpha;
     }
 
-    // get/draw the 2D spectrum
-    if (drawPlotter)
-    {
-        tlast_plot_drawn_ms = tnow_ms;
+    // Remember the plot geometry for drawPlot()
+    m_PlotXmin = xmin;
+    m_PlotXmax = xmax;
+    m_HistBinsDisplayed = histBinsDisplayed;
 
-        m_2DPixmap.fill(QColor::fromRgba(PLOTTER_BGD_COLOR));
-        QPainter painter2(&m_2DPixmap);
-        painter2.translate(QPointF(0.5, 0.5));
+    // The 2D plot is rendered from paintEvent(), at most once per displayed
+    // frame, so FFT frames arriving faster than that are coalesced.
+    m_PlotDirty = true;
 
+    // trigger a new paintEvent
+    update();
+}
 
-        // draw the pandapter
-        QBrush fillBrush = QBrush(m_FftFillCol);
+// Render the 2D plot from the buffers prepared by draw()
+void CPlotter::drawPlot()
+{
+    TRACE_SCOPE("CPlotter::drawPlot", "gui");
+    qint32        i, j;
+    QFontMetricsF metrics(m_Font);
 
-        // Fill between max and avg
-        QColor maxFillCol = m_FftFillCol;
-        maxFillCol.setAlpha(80);
-        QBrush maxFillBrush = QBrush(maxFillCol);
+    float avgLineBuf[MAX_SCREENSIZE];
+    float maxLineBuf[MAX_SCREENSIZE];
 
-        // Diagonal fill for area between markers. Scale the pattern to DPR.
-        QColor abFillColor = QColor::fromRgba(PLOTTER_MARKER_COLOR);
-        abFillColor.setAlpha(128);
-        QBrush abFillBrush = QBrush(abFillColor, Qt::BDiagPattern);
+    const quint64 tnow_ms = QDateTime::currentMSecsSinceEpoch();
 
-        QColor maxLineColor = QColor(m_FftFillCol);
-        if (m_PlotMode == PLOT_MODE_FILLED)
-            maxLineColor.setAlpha(128);
-        else
-            maxLineColor.setAlpha(255);
+    const qreal plotHeight = m_2DImage.height();
+    const qreal shadowOffset = metrics.height() / 20.0;
 
-        QPen maxLinePen = QPen(maxLineColor);
+    // Scale plotter for graph height
+    const float panddBGainFactor = (float)plotHeight / fabsf(m_PandMaxdB - m_PandMindB);
 
-        // Same color as max in avg mode, different for filled mode
-        QPen avgLinePen;
-        if (m_PlotMode == PLOT_MODE_AVG || m_PlotMode == PLOT_MODE_HISTOGRAM)
-        {
-            QColor avgLineCol = m_FftFillCol;
-            avgLineCol.setAlpha(255);
-            avgLinePen = QPen(avgLineCol);
-        }
-        else {
-            QColor avgLineCol = QColor(Qt::cyan);
-            avgLineCol.setAlpha(192);
-            avgLinePen = QPen(avgLineCol);
-        }
+    const qint32 xmin = m_PlotXmin;
+    const int npts = m_PlotXmax - m_PlotXmin;
+    const int histBinsDisplayed = m_HistBinsDisplayed;
 
-        // The m_Marker{AB}X values are one cycle old, which makes for a laggy
-        // effect, so get fresh values here.
-        const int ax = xFromFreq(m_MarkerFreqA);
-        const int bx = xFromFreq(m_MarkerFreqB);
-        bool fillMarkers = (m_MarkersEnabled && m_MarkerFreqA != MARKER_OFF
-                                             && m_MarkerFreqB != MARKER_OFF);
-        const int minMarker = std::min(ax, bx);
-        const int maxMarker = std::max(ax, bx);
+    // Show max and average highlights on histogram if it would not be too
+    // cluttered
+    const bool showHistHighlights = histBinsDisplayed >= MAX_HISTOGRAM_SIZE / 2;
 
-        const float binSizeY = (float)plotHeight / (float)histBinsDisplayed;
-        for (i = 0; i < npts; i++)
-        {
-            const int ix = i + xmin;
-            const qreal ixPlot = (qreal)ix;
-            const qreal yMaxD = (qreal)std::max(std::min(
-                panddBGainFactor * (m_PandMaxdB - 10.0f * log10f(m_fftMaxBuf[ix])),
-                (float)plotHeight), 0.0f);
-            const qreal yAvgD = (qreal)std::max(std::min(
-                panddBGainFactor * (m_PandMaxdB - 10.0f * log10f(m_fftAvgBuf[ix])),
-                (float)plotHeight), 0.0f);
+    // Draw avg line, except in max mode. Suppress if it would clutter histogram.
+    const bool doAvgLine = m_PlotMode != PLOT_MODE_MAX
+                           && (m_PlotMode != PLOT_MODE_HISTOGRAM || showHistHighlights);
 
-            if (m_PlotMode == PLOT_MODE_HISTOGRAM)
-            {
-                const float *histData = m_histIIR[(ix)];
-                qreal topBin = plotHeight;
-                for (j = 0; j < histBinsDisplayed; ++j)
-                {
-                    qint32 cidx = qRound(histData[j] / m_histMaxIIR * 255.0f * .7f);
-                    if (cidx > 0) {
-                        cidx += 65;  // 255 * 0.7 = 178, + 65 = 243
-                        // Histogram IIR can cause out-of-range cidx
-                        cidx = std::max(std::min(cidx, 255), 0);
-                        QColor c = m_ColorTbl[cidx];
-                        // Paint rectangle
-                        const qreal binY = (qreal)binSizeY * j;
-                        topBin = std::min(topBin, binY);
-                        const qreal binH = (qreal)binSizeY * (j + 1) - binY;
-                        painter2.fillRect(QRectF(ixPlot, binY, 1.0, binH), c);
-                    }
-                }
-                // Highlight the top bin, if it isn't too crowded
-                if (topBin != plotHeight && showHistHighlights) {
-                    painter2.fillRect(QRectF(ixPlot, topBin, 1.0, (qreal)binSizeY), maxLineColor);
-                }
-            }
+    // Draw max line, except in avg and histogram modes
+    const bool doMaxLine = m_PlotMode != PLOT_MODE_AVG
+                           && m_PlotMode != PLOT_MODE_HISTOGRAM;
 
-            // Add max, average points if they will be drawn
-            if (doMaxLine)
-                maxLineBuf[i] = QPointF(ixPlot, yMaxD);
-            if (doAvgLine)
-                avgLineBuf[i] = QPointF(ixPlot, yAvgD);
+    m_PlotDirty = false;
+    tlast_plot_drawn_ms = tnow_ms;
 
-            // Fill area between markers, even if they are off screen
-            qreal yFill = m_PlotMode == PLOT_MODE_MAX ? yMaxD : yAvgD;
-            if (fillMarkers && (ix) > minMarker && (ix) < maxMarker) {
-                painter2.fillRect(QRectF(ixPlot, yFill + 1.0, 1.0, plotHeight - yFill), abFillBrush);
-            }
-            if (m_FftFill && m_PlotMode != PLOT_MODE_HISTOGRAM)
+    m_2DImage.fill(QColor::fromRgba(PLOTTER_BGD_COLOR));
+
+    // Fills, traces and histogram are written directly into the image one
+    // column at a time. QPainter is only used for peaks and the overlay.
+    const RasterTarget rt = { (QRgb *)m_2DImage.bits(), m_2DImage.bytesPerLine() / 4,
+                              m_2DImage.width(), m_2DImage.height() };
+
+    const QRgb fftFillRgb = m_FftFillCol.rgba();
+
+    // Fill between max and avg
+    QColor maxFillCol = m_FftFillCol;
+    maxFillCol.setAlpha(80);
+    const QRgb maxFillRgb = maxFillCol.rgba();
+
+    // Diagonal hatch for area between markers
+    QColor abFillColor = QColor::fromRgba(PLOTTER_MARKER_COLOR);
+    abFillColor.setAlpha(128);
+    const QRgb abFillRgb = abFillColor.rgba();
+
+    QColor maxLineColor = QColor(m_FftFillCol);
+    if (m_PlotMode == PLOT_MODE_FILLED)
+        maxLineColor.setAlpha(128);
+    else
+        maxLineColor.setAlpha(255);
+    const QRgb maxLineRgb = maxLineColor.rgba();
+
+    // Same color as max in avg mode, different for filled mode
+    QColor avgLineCol;
+    if (m_PlotMode == PLOT_MODE_AVG || m_PlotMode == PLOT_MODE_HISTOGRAM)
+    {
+        avgLineCol = m_FftFillCol;
+        avgLineCol.setAlpha(255);
+    }
+    else {
+        avgLineCol = QColor(Qt::cyan);
+        avgLineCol.setAlpha(192);
+    }
+    const QRgb avgLineRgb = avgLineCol.rgba();
+
+    // The m_Marker{AB}X values are one cycle old, which makes for a laggy
+    // effect, so get fresh values here.
+    const int ax = xFromFreq(m_MarkerFreqA);
+    const int bx = xFromFreq(m_MarkerFreqB);
+    bool fillMarkers = (m_MarkersEnabled && m_MarkerFreqA != MARKER_OFF
+                                         && m_MarkerFreqB != MARKER_OFF);
+    const int minMarker = std::min(ax, bx);
+    const int maxMarker = std::max(ax, bx);
+
+    const float binSizeY = (float)plotHeight / (float)histBinsDisplayed;
+    for (i = 0; i < npts; i++)
+    {
+        const int ix = i + xmin;
+        const float yMaxD = std::max(std::min(
+            panddBGainFactor * (m_PandMaxdB - 10.0f * log10f(m_fftMaxBuf[ix])),
+            (float)plotHeight), 0.0f);
+        const float yAvgD = std::max(std::min(
+            panddBGainFactor * (m_PandMaxdB - 10.0f * log10f(m_fftAvgBuf[ix])),
+            (float)plotHeight), 0.0f);
+
+        if (m_PlotMode == PLOT_MODE_HISTOGRAM)
+        {
+            const float *histData = m_histIIR[(ix)];
+            float topBin = plotHeight;
+            for (j = 0; j < histBinsDisplayed; ++j)
             {
-                painter2.fillRect(QRectF(ixPlot, yFill + 1.0, 1.0, plotHeight - yFill), m_FftFillCol);
+                qint32 cidx = qRound(histData[j] / m_histMaxIIR * 255.0f * .7f);
+                if (cidx > 0) {
+                    cidx += 65;  // 255 * 0.7 = 178, + 65 = 243
+                    // Histogram IIR can cause out-of-range cidx
+                    cidx = std::max(std::min(cidx, 255), 0);
+                    const float binY = binSizeY * j;
+                    topBin = std::min(topBin, binY);
+                    fillSpan(rt, ix, qRound(binY), qRound(binSizeY * (j + 1)),
+                             m_ColorTbl[cidx].rgb());
+                }
             }
-            if (m_PlotMode == PLOT_MODE_FILLED)
-            {
-                painter2.fillRect(QRectF(ixPlot, yMaxD + 1.0, 1.0, yAvgD - yMaxD), maxFillBrush);
+            // Highlight the top bin, if it isn't too crowded
+            if (topBin != plotHeight && showHistHighlights) {
+                fillSpan(rt, ix, qRound(topBin), qRound(topBin + binSizeY), maxLineRgb);
             }
         }
 
-        if (doMaxLine) {
-            // NOT scaling to DPR due to performance
-            painter2.setPen(maxLinePen);
-            painter2.drawPolyline(maxLineBuf, npts);
+        maxLineBuf[i] = yMaxD;
+        avgLineBuf[i] = yAvgD;
+
+        // Fill area between markers, even if they are off screen
+        const int yFill = qRound((m_PlotMode == PLOT_MODE_MAX ? yMaxD : yAvgD) + 1.0f);
+        if (fillMarkers && (ix) > minMarker && (ix) < maxMarker) {
+            hatchSpan(rt, ix, yFill, rt.height, abFillRgb);
         }
-        if (doAvgLine) {
-            // NOT scaling to DPR due to performance
-            painter2.setPen(avgLinePen);
-            painter2.drawPolyline(avgLineBuf, npts);
+        if (m_FftFill && m_PlotMode != PLOT_MODE_HISTOGRAM)
+        {
+            fillSpan(rt, ix, yFill, rt.height, fftFillRgb);
         }
-
-        // Max hold
-        if (m_MaxHoldActive)
+        if (m_PlotMode == PLOT_MODE_FILLED)
         {
-            // Show max(max) except when showing only avg on screen
-            for (i = 0; i < npts; i++)
-            {
-                const int ix = i + xmin;
-                const qreal ixPlot = (qreal)ix;
-                const qreal yMaxHoldD = (qreal)std::max(std::min(
-                    panddBGainFactor * (m_PandMaxdB - 10.0f * log10f(m_fftMaxHoldBuf[ix])),
-                    (float)plotHeight), 0.0f);
-                maxLineBuf[i] = QPointF(ixPlot, yMaxHoldD);
-            }
-            // NOT scaling to DPR due to performance
-            painter2.setPen(m_MaxHoldColor);
-            painter2.drawPolyline(maxLineBuf, npts);
+            fillSpan(rt, ix, qRound(yMaxD + 1.0f), qRound(yAvgD + 1.0f), maxFillRgb);
+        }
+    }
+
+    if (doMaxLine)
+        drawTrace(rt, xmin, maxLineBuf, npts, maxLineRgb, m_TraceAntialias);
+    if (doAvgLine)
+        drawTrace(rt, xmin, avgLineBuf, npts, avgLineRgb, m_TraceAntialias);
 
-            m_MaxHoldValid = true;
+    // Max hold
+    if (m_MaxHoldActive)
+    {
+        // Show max(max) except when showing only avg on screen
+        for (i = 0; i < npts; i++)
+        {
+            const int ix = i + xmin;
+            maxLineBuf[i] = std::max(std::min(
+                panddBGainFactor * (m_PandMaxdB - 10.0f * log10f(m_fftMaxHoldBuf[ix])),
+                (float)plotHeight), 0.0f);
         }
+        drawTrace(rt, xmin, maxLineBuf, npts, m_MaxHoldColor.rgba(), m_TraceAntialias);
 
-        // Min hold
-        if (m_MinHoldActive)
+        m_MaxHoldValid = true;
+    }
+
+    // Min hold
+    if (m_MinHoldActive)
+    {
+        // Show min(avg) except when showing only max on scree
+        for (i = 0; i < npts; i++)
         {
-            // Show min(avg) except when showing only max on scree
-            for (i = 0; i < npts; i++)
-            {
+            const int ix = i + xmin;
+            maxLineBuf[i] = std::max(std::min(
+                panddBGainFactor * (m_PandMaxdB - 10.0f * log10f(m_fftMinHoldBuf[ix])),
+                (float)plotHeight), 0.0f);
+        }
+        drawTrace(rt, xmin, maxLineBuf, npts, m_MinHoldColor.rgba(), m_TraceAntialias);
+
+        m_MinHoldValid = true;
+    }
+
+    QPainter painter2(&m_2DImage);
+    painter2.translate(QPointF(0.5, 0.5));
+
+    // Peak detection
+    if (m_PeakDetectActive)
+    {
+        const int pw = PEAK_WINDOW_HALF_WIDTH;
+
+        // Use data source appropriate for current display mode
+        float *_detectSource;
+        if (m_MaxHoldActive)
+            _detectSource = m_fftMaxHoldBuf;
+        else if (m_PlotMode == PLOT_MODE_AVG)
+            _detectSource = m_fftAvgBuf;
+        else
+            _detectSource = m_fftMaxBuf;
+        const float *detectSource = _detectSource;
+
+        // Run peak detection periodically. If overlay will be redrawn, run
+        // peak detection since zoom/pan may have changed.
+        if (tnow_ms > tlast_peaks_ms + PEAK_UPDATE_PERIOD || m_DrawOverlay) {
+            tlast_peaks_ms = tnow_ms;
+            m_Peaks.clear();
+
+            // Narrow peaks
+            for (i = pw; i < npts - pw; ++i) {
                 const int ix = i + xmin;
-                const qreal ixPlot = (qreal)ix;
-                const qreal yMinHoldD = (qreal)std::max(std::min(
-                    panddBGainFactor * (m_PandMaxdB - 10.0f * log10f(m_fftMinHoldBuf[ix])),
-                    (float)plotHeight), 0.0f);
-                maxLineBuf[i] = QPointF(ixPlot, yMinHoldD);
+                const float vi = detectSource[ix];
+                float sumV = 0;
+                float minV = vi;
+                float maxV = 0;
+                for (j = -pw; j <= pw; ++j) {
+                    const float vj = detectSource[ix + j];
+                    minV = std::min(minV, vj);
+                    maxV = std::max(maxV, vj);
+                    sumV += vj;
+                }
+                const float avgV = sumV / (float)(pw * 2 + 1);
+                m_peakSmoothBuf[ix] = avgV;
+                if (vi == maxV && (vi > 2.0f * avgV) && (vi > 4.0f * minV))
+                {
+                    const qreal y = (qreal)std::max(std::min(
+                        panddBGainFactor * (m_PandMaxdB - 10.0f * log10f(vi)),
+                        (float)plotHeight - 0.0f), 0.0f);
+                    m_Peaks[ix] = y;
+                }
             }
-            // NOT scaling to DPR due to performance
-            painter2.setPen(m_MinHoldColor);
-            painter2.drawPolyline(maxLineBuf, npts);
 
-            m_MinHoldValid = true;
-        }
+            // Use the smoothed curve to find wider peaks
+            const int pw2 = pw * 5;
+            for (i = pw2; i < npts - pw2; ++i) {
+                const int ix = i + xmin;
+                const float vi = m_peakSmoothBuf[ix];
+                float sumV = 0;
+                float minV = vi;
+                float maxV = 0;
+                for (j = -pw2; j <= pw2; ++j) {
+                    const float vj = m_peakSmoothBuf[ix + j];
+                    minV = std::min(minV, vj);
+                    maxV = std::max(maxV, vj);
+                    sumV += vj;
+                }
+                const float avgV = sumV / (float)(pw2 * 2);
+                if (vi == maxV && (vi > 2.0f * avgV) && (vi > 4.0f * minV))
+                {
+                    const qreal y = (qreal)std::max(std::min(
+                        panddBGainFactor * (m_PandMaxdB - 10.0f * log10f(vi)),
+                        (float)plotHeight - 0.0f), 0.0f);
 
-        // Peak detection
-        if (m_PeakDetectActive)
-        {
-            const int pw = PEAK_WINDOW_HALF_WIDTH;
-
-            // Use data source appropriate for current display mode
-            float *_detectSource;
-            if (m_MaxHoldActive)
-                _detectSource = m_fftMaxHoldBuf;
-            else if (m_PlotMode == PLOT_MODE_AVG)
-                _detectSource = m_fftAvgBuf;
-            else
-                _detectSource = m_fftMaxBuf;
-            const float *detectSource = _detectSource;
-
-            // Run peak detection periodically. If overlay will be redrawn, run
-            // peak detection since zoom/pan may have changed.
-            if (tnow_ms > tlast_peaks_ms + PEAK_UPDATE_PERIOD || m_DrawOverlay) {
-                tlast_peaks_ms = tnow_ms;
-                m_Peaks.clear();
-
-                // Narrow peaks
-                for (i = pw; i < npts - pw; ++i) {
-                    const int ix = i + xmin;
-                    const float vi = detectSource[ix];
-                    float sumV = 0;
-                    float minV = vi;
-                    float maxV = 0;
+                    // Show the wider peak only if there is no very close narrow peak
+                    bool found = false;
                     for (j = -pw; j <= pw; ++j) {
-                        const float vj = detectSource[ix + j];
-                        minV = std::min(minV, vj);
-                        maxV = std::max(maxV, vj);
-                        sumV += vj;
+                        auto it = m_Peaks.find(ix + j);
+                        if (it != m_Peaks.end()) {
+                            found = true;
+                            break;
+                        }
                     }
-                    const float avgV = sumV / (float)(pw * 2 + 1);
-                    m_peakSmoothBuf[ix] = avgV;
-                    if (vi == maxV && (vi > 2.0f * avgV) && (vi > 4.0f * minV))
-                    {
-                        const qreal y = (qreal)std::max(std::min(
-                            panddBGainFactor * (m_PandMaxdB - 10.0f * log10f(vi)),
-                            (float)plotHeight - 0.0f), 0.0f);
+                    if (!found) {
                         m_Peaks[ix] = y;
                     }
                 }
-
-                // Use the smoothed curve to find wider peaks
-                const int pw2 = pw * 5;
-                for (i = pw2; i < npts - pw2; ++i) {
-                    const int ix = i + xmin;
-                    const float vi = m_peakSmoothBuf[ix];
-                    float sumV = 0;
-                    float minV = vi;
-                    float maxV = 0;
-                    for (j = -pw2; j <= pw2; ++j) {
-                        const float vj = m_peakSmoothBuf[ix + j];
-                        minV = std::min(minV, vj);
-                        maxV = std::max(maxV, vj);
-                        sumV += vj;
-                    }
-                    const float avgV = sumV / (float)(pw2 * 2);
-                    if (vi == maxV && (vi > 2.0f * avgV) && (vi > 4.0f * minV))
-                    {
-                        const qreal y = (qreal)std::max(std::min(
-                            panddBGainFactor * (m_PandMaxdB - 10.0f * log10f(vi)),
-                            (float)plotHeight - 0.0f), 0.0f);
-
-                        // Show the wider peak only if there is no very close narrow peak
-                        bool found = false;
-                        for (j = -pw; j <= pw; ++j) {
-                            auto it = m_Peaks.find(ix + j);
-                            if (it != m_Peaks.end()) {
-                                found = true;
-                                break;
-                            }
-                        }
-                        if (!found) {
-                            m_Peaks[ix] = y;
-                        }
-                    }
-                }
-            }
-
-            // Paint peaks with shadow
-            QPen peakPen(m_maxFftColor, m_DPR);
-            QPen peakShadowPen(Qt::black, m_DPR);
-            peakPen.setWidthF(m_DPR);
-            for(auto peakx : m_Peaks.keys()) {
-                const qreal peakxPlot = (qreal)peakx;
-                const qreal peakv = m_Peaks.value(peakx);
-                painter2.setPen(peakShadowPen);
-                painter2.drawEllipse(
-                    QRectF(peakxPlot - 5.0 * m_DPR + shadowOffset,
-                           peakv - 5.0 * m_DPR + shadowOffset,
-                           10.0 * m_DPR, 10.0 * m_DPR));
-                painter2.setPen(peakPen);
-                painter2.drawEllipse(
-                    QRectF(peakxPlot - 5.0 * m_DPR,
-                           peakv - 5.0 * m_DPR,
-                           10.0 * m_DPR, 10.0 * m_DPR));
             }
         }
 
-        // Update the overlay if needed
-        if (m_DrawOverlay)
-        {
-            drawOverlay();
-            m_DrawOverlay = false;
+        // Paint peaks with shadow
+        QPen peakPen(m_maxFftColor, m_DPR);
+        QPen peakShadowPen(Qt::black, m_DPR);
+        peakPen.setWidthF(m_DPR);
+        for(auto peakx : m_Peaks.keys()) {
+            const qreal peakxPlot = (qreal)peakx;
+            const qreal peakv = m_Peaks.value(peakx);
+            painter2.setPen(peakShadowPen);
+            painter2.drawEllipse(
+                QRectF(peakxPlot - 5.0 * m_DPR + shadowOffset,
+                       peakv - 5.0 * m_DPR + shadowOffset,
+                       10.0 * m_DPR, 10.0 * m_DPR));
+            painter2.setPen(peakPen);
+            painter2.drawEllipse(
+                QRectF(peakxPlot - 5.0 * m_DPR,
+                       peakv - 5.0 * m_DPR,
+                       10.0 * m_DPR, 10.0 * m_DPR));
         }
+    }
 
-        // Draw overlay over plot
-        painter2.setCompositionMode(QPainter::CompositionMode_SourceOver);
-        painter2.drawPixmap(QPointF(0.0, 0.0), m_OverlayPixmap);
+    // Update the overlay if needed
+    if (m_DrawOverlay)
+    {
+        drawOverlay();
+        m_DrawOverlay = false;
     }
 
-    // trigger a new paintEvent
-    update();
+    // Draw overlay over plot
+    painter2.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter2.drawPixmap(QPointF(0.0, 0.0), m_OverlayPixmap);
 }
 
 void CPlotter::setRunningState(bool running)
@@ -1831,6 +2011,15 @@ void CPlotter::setNewFftData(const float *fftData, int size)
     for (int i = 0; i < size; ++i)
         m_fftData[i] = std::max(fftData[i] * pwr_scale, fmin);
 
+    // Skip the IIRs while hidden. They restart from the latest data when
+    // the plotter is shown again.
+    if (!isVisible())
+    {
+        m_IIRValid = false;
+        m_histIIRValid = false;
+        return;
+    }
+
     // Update IIR. If IIR is invalid, set alpha to use latest value. Since the
     // IIR is linear data and users would like to see symmetric attack/decay on
     // the logarithmic y-axis, IIR is in terms of multiplication rather than
@@ -1899,6 +2088,7 @@ void CPlotter::setWaterfallRange(float min, float max)
 // does not need to be recreated every fft data update.
 void CPlotter::drawOverlay()
 {
+    TRACE_SCOPE("CPlotter::drawOverlay", "gui");
     if (m_OverlayPixmap.isNull())
         return;
 
@@ -2417,7 +2607,24 @@ void CPlotter::enableMinHold(bool enabled)
  */
 void CPlotter::enablePeakDetect(bool enabled)
 {
-    m_PeakDetectActive = enabled;
+    m_UserPeakDetect = enabled;
+    m_PeakDetectActive = enabled && !(m_LoadShed & SHED_HISTOGRAM_PEAKS);
+}
+
+/**
+ * Give up some of the drawing work while the CPU is overloaded. The modes
+ * set by the user are kept and restored when the flags are cleared.
+ * @param flags A combination of eLoadShed flags.
+ */
+void CPlotter::setLoadShed(int flags)
+{
+    if (flags == m_LoadShed)
+        return;
+
+    m_LoadShed = flags;
+    m_wfShedCount = 0;
+    setPlotMode(m_UserPlotMode);
+    enablePeakDetect(m_UserPeakDetect);
 }
 
 void CPlotter::enableBandPlan(bool enabled)
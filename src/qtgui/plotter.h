@@ -8,6 +8,7 @@
 #include <QImage>
 #include <vector>
 #include <QMap>
+#include "interfaces/large_buffer.h"
 
 #define HORZ_DIVS_MAX 12    //50
 #define VERT_DIVS_MIN 5
@@ -18,7 +19,7 @@
 #define PEAK_CLICK_MAX_V_DISTANCE 20 //Maximum vertical distance of clicked point from peak
 #define PEAK_WINDOW_HALF_WIDTH    10
 #define PEAK_UPDATE_PERIOD       100 // msec
-#define PLOTTER_UPDATE_LIMIT_MS   16 // 16ms = 62.5 Hz
+#define PLOTTER_UPDATE_LIMIT_MS   16 // 16ms = 62.5 Hz, if the screen rate is unknown
 
 #define MARKER_OFF std::numeric_limits<qint64>::min()
 
@@ -26,10 +27,21 @@ class CPlotter : public QFrame
 {
     Q_OBJECT
 
+    friend class CPlotterBench;
+
 public:
     explicit CPlotter(QWidget *parent = nullptr);
     ~CPlotter() override;
 
+    // The histogram and trace arrays make this object several megabytes.
+    static void *operator new(size_t size) {
+        void *ptr = large_buffer::alloc(size);
+        if (!ptr)
+            throw std::bad_alloc();
+        return ptr;
+    }
+    static void operator delete(void *ptr, size_t size) { large_buffer::dealloc(ptr, size); }
+
     QSize minimumSizeHint() const override;
     QSize sizeHint() const override;
 
@@ -44,6 +56,7 @@ public:
     void setBookmarksEnabled(bool enabled) { m_BookmarksEnabled = enabled; }
     void setInvertScrolling(bool enabled) { m_InvertScrolling = enabled; }
     void setDXCSpotsEnabled(bool enabled) { m_DXCSpotsEnabled = enabled; }
+    void setTraceAntialiasing(bool enabled) { m_TraceAntialias = enabled; }
 
     void setNewFftData(const float *fftData, int size);
 
@@ -146,6 +159,13 @@ public:
         WATERFALL_MODE_SYNC = 2
     };
 
+    /* Work given up while the CPU is overloaded, see setLoadShed(). */
+    enum eLoadShed {
+        SHED_HISTOGRAM_PEAKS = 0x1,  /*!< Histogram shown as average, no peak detection. */
+        SHED_WATERFALL       = 0x2   /*!< Auto waterfall adds a line every other frame. */
+    };
+    void    setLoadShed(int flags);
+
 signals:
     void newDemodFreq(qint64 freq, qint64 delta); /* delta is the offset from the center */
     void newLowCutFreq(int f);
@@ -195,6 +215,7 @@ protected:
     //re-implemented widget event handlers
     void paintEvent(QPaintEvent *event) override;
     void resizeEvent(QResizeEvent* event) override;
+    void showEvent(QShowEvent *event) override;
     void mouseMoveEvent(QMouseEvent * event) override;
     void mousePressEvent(QMouseEvent * event) override;
     void mouseReleaseEvent(QMouseEvent * event) override;
@@ -214,6 +235,8 @@ private:
     };
 
     void        drawOverlay();
+    void        drawPlot();
+    quint64     frameInterval();
     void        makeFrequencyStrs();
     int         xFromFreq(qint64 freq);
     qint64      freqFromX(int x);
@@ -234,6 +257,7 @@ private:
     bool        m_MinHoldActive;
     bool        m_MinHoldValid;
     bool        m_PeakDetectActive;
+    bool        m_UserPeakDetect;
     bool        m_IIRValid;
     bool        m_histIIRValid;
     float       m_fftMaxBuf[MAX_SCREENSIZE]{};
@@ -243,9 +267,9 @@ private:
     float       m_histogram[MAX_SCREENSIZE][MAX_HISTOGRAM_SIZE]{};
     float       m_histIIR[MAX_SCREENSIZE][MAX_HISTOGRAM_SIZE]{};
     float       m_histMaxIIR;
-    std::vector<float> m_fftIIR;
-    std::vector<float> m_fftData;
-    std::vector<float> m_X;                // scratch array of matching size for local calculation
+    large_buffer::vector<float> m_fftIIR;
+    large_buffer::vector<float> m_fftData;
+    large_buffer::vector<float> m_X;       // scratch array of matching size for local calculation
     float      m_wfbuf[MAX_SCREENSIZE]{}; // used for accumulating waterfall data at high time spans
     float       m_fftMaxHoldBuf[MAX_SCREENSIZE]{};
     float       m_fftMinHoldBuf[MAX_SCREENSIZE]{};
@@ -257,7 +281,7 @@ private:
     qreal       m_YAxisWidth{};
 
     eCapturetype    m_CursorCaptured;
-    QPixmap     m_2DPixmap;         // Composite of everything displayed in the 2D plotter area
+    QImage      m_2DImage;          // Composite of everything displayed in the 2D plotter area
     QPixmap     m_OverlayPixmap;    // Grid, axes ... things that need to be drawn infrequently
     QImage      m_WaterfallImage;
     QColor      m_ColorTbl[256];
@@ -266,6 +290,12 @@ private:
     QString     m_HDivText[HORZ_DIVS_MAX+1];
     bool        m_Running;
     bool        m_DrawOverlay;
+    bool        m_TraceAntialias;   // weight trace end pixels by coverage
+    bool        m_PlotDirty;        // 2D plot needs rendering on next paint
+    bool        m_FrameScheduled;   // delayed repaint pending
+    qint32      m_PlotXmin;         // plot geometry from the last draw()
+    qint32      m_PlotXmax;
+    int         m_HistBinsDisplayed;
     qint64      m_CenterFreq;       // The HW frequency
     qint64      m_FftCenter;        // Center freq in the -span ... +span range
     qint64      m_DemodCenterFreq;
@@ -314,6 +344,9 @@ private:
     qreal       m_ClickResolution;
     qreal       m_FilterClickResolution;
     ePlotMode   m_PlotMode;
+    ePlotMode   m_UserPlotMode;  /*!< Mode set by the user, m_PlotMode may be reduced. */
+    int         m_LoadShed;      /*!< eLoadShed flags. */
+    int         m_wfShedCount;   /*!< Frames since the last waterfall line while shedding. */
     ePlotScale  m_PlotScale;
     bool        m_PlotPerHz;
     eWaterfallMode m_WaterfallMode;
@@ -0,0 +1,167 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <algorithm>
+#include <cmath>
+#include <QPainter>
+#include "scope.h"
+
+#define SCOPE_DIVS      10
+#define RANGE_DECAY     0.02f   // part of the unused range given up per frame
+
+CScope::CScope(QWidget *parent) : QFrame(parent)
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+
+    m_Span = 0.0;
+    m_Lo = 0.0f;
+    m_Hi = 1.0f;
+    m_TrigEnabled = false;
+    m_TrigLevel = 0.0f;
+}
+
+QSize CScope::minimumSizeHint() const
+{
+    return QSize(100, 60);
+}
+
+QSize CScope::sizeHint() const
+{
+    return QSize(400, 150);
+}
+
+/**
+ * Set new envelope data.
+ * @param mins Minimum of each column, NaN where there is no data.
+ * @param maxs Maximum of each column, NaN where there is no data.
+ * @param n Number of columns, normally the width of the widget.
+ * @param span_s The time span of the data in seconds.
+ */
+void CScope::setData(const float *mins, const float *maxs, int n, double span_s)
+{
+    float lo = 0.0f;
+    float hi = 0.0f;
+
+    m_Mins.resize(n);
+    m_Maxs.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+        m_Mins[i] = mins[i];
+        m_Maxs[i] = maxs[i];
+        if (!std::isnan(mins[i]))
+        {
+            lo = std::min(lo, mins[i]);
+            hi = std::max(hi, maxs[i]);
+        }
+    }
+    m_Span = span_s;
+
+    // symmetric around zero if the signal goes negative
+    if (lo < 0.0f)
+    {
+        hi = std::max(hi, -lo);
+        lo = -hi;
+    }
+    hi = std::max(hi, 1e-6f);
+
+    m_Hi = hi > m_Hi ? hi : m_Hi - RANGE_DECAY * (m_Hi - hi);
+    m_Lo = lo < m_Lo ? lo : m_Lo - RANGE_DECAY * (m_Lo - lo);
+
+    update();
+}
+
+void CScope::setTrigger(bool enabled, float level)
+{
+    m_TrigEnabled = enabled;
+    m_TrigLevel = level;
+    update();
+}
+
+void CScope::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    const qreal w = width();
+    const qreal h = height();
+    const qreal range = (qreal)(m_Hi - m_Lo) * 1.1;
+    const qreal top = (qreal)m_Hi + 0.05 * (qreal)(m_Hi - m_Lo);
+
+    painter.fillRect(rect(), QColor(0x1F, 0x1D, 0x1D));
+
+    // grid
+    painter.setPen(QPen(QColor(0xF0, 0xF0, 0xF0, 0x30), 1, Qt::DotLine));
+    for (int i = 1; i < SCOPE_DIVS; i++)
+    {
+        qreal x = w * i / SCOPE_DIVS;
+        painter.drawLine(QLineF(x, 0, x, h));
+    }
+    for (int i = 1; i < 4; i++)
+    {
+        qreal y = h * i / 4;
+        painter.drawLine(QLineF(0, y, w, y));
+    }
+
+    auto ypos = [&](float v) { return (top - (qreal)v) * h / range; };
+
+    // envelope, one line per column
+    const int n = m_Mins.size();
+    painter.setPen(QPen(QColor(0x97, 0xD0, 0x97), 1));
+    for (int i = 0; i < n; i++)
+    {
+        if (std::isnan(m_Mins[i]))
+            continue;
+
+        qreal x = (i + 0.5) * w / n;
+        qreal y0 = ypos(m_Maxs[i]);
+        qreal y1 = std::max(ypos(m_Mins[i]), y0 + 1.0);
+        painter.drawLine(QLineF(x, y0, x, y1));
+    }
+
+    if (m_TrigEnabled)
+    {
+        qreal y = ypos(m_TrigLevel);
+        painter.setPen(QPen(Qt::yellow, 1, Qt::DashLine));
+        painter.drawLine(QLineF(0, y, w, y));
+    }
+
+    // time per division and vertical range
+    if (m_Span > 0.0)
+    {
+        double div = m_Span / SCOPE_DIVS;
+        QString unit = "s";
+
+        if (div < 1e-3)
+        {
+            div *= 1e6;
+            unit = "µs";
+        }
+        else if (div < 1.0)
+        {
+            div *= 1e3;
+            unit = "ms";
+        }
+
+        painter.setPen(QColor(0xDA, 0xDA, 0xDA));
+        painter.drawText(QPointF(4, h - 4),
+                         QString("%1 %2/div   %3 .. %4").arg(div, 0, 'g', 3).arg(unit)
+                         .arg(m_Lo, 0, 'g', 3).arg(m_Hi, 0, 'g', 3));
+    }
+}
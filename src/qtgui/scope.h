@@ -0,0 +1,58 @@
+/* -*- c++ -*- */
+/*
+ * Gqrx SDR: Software defined radio receiver powered by GNU Radio and Qt
+ *           https://gqrx.dk/
+ *
+ * Copyright 2026 Gqrx contributors.
+ *
+ * Gqrx is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gqrx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Gqrx; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include <QFrame>
+#include <QVector>
+
+/*! \brief Oscilloscope display of a min/max envelope.
+ *
+ * Each column is drawn as a vertical line from the minimum to the maximum
+ * of the samples it covers. The vertical range follows the signal: it grows
+ * at once and shrinks slowly.
+ */
+class CScope : public QFrame
+{
+    Q_OBJECT
+
+public:
+    explicit CScope(QWidget *parent = 0);
+
+    QSize minimumSizeHint() const;
+    QSize sizeHint() const;
+
+    void setData(const float *mins, const float *maxs, int n, double span_s);
+    void setTrigger(bool enabled, float level);
+
+protected:
+    void paintEvent(QPaintEvent *event);
+
+private:
+    QVector<float>  m_Mins;
+    QVector<float>  m_Maxs;
+    double          m_Span;
+    float           m_Lo;
+    float           m_Hi;
+    bool            m_TrigEnabled;
+    float           m_TrigLevel;
+};
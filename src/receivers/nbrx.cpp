@@ -26,7 +26,7 @@
 #include "receivers/nbrx.h"
 
 // NB: Remember to adjust filter ranges in MainWindow
-#define PREF_QUAD_RATE  96000.f
+#define PREF_QUAD_RATE  NBRX_QUAD_RATE
 
 nbrx_sptr make_nbrx(float quad_rate, float audio_rate)
 {
@@ -82,13 +82,11 @@ nbrx::nbrx(float quad_rate, float audio_rate)
     {
         connect(demod, 0, audio_rr0, 0);
 
-        connect(audio_rr0, 0, self(), 0); // left  channel
-        connect(audio_rr0, 0, self(), 1); // right channel
+        connect(audio_rr0, 0, self(), 0);
     }
     else
     {
         connect(demod, 0, self(), 0);
-        connect(demod, 0, self(), 1);
     }
 }
 
@@ -218,7 +216,6 @@ void nbrx::set_demod(int rx_demod)
             disconnect(demod, 0, audio_rr0, 0);
 
             disconnect(audio_rr0, 0, self(), 0);
-            disconnect(audio_rr0, 0, self(), 1);
         }
     }
     else
@@ -231,7 +228,6 @@ void nbrx::set_demod(int rx_demod)
         else
         {
             disconnect(demod, 0, self(), 0);
-            disconnect(demod, 0, self(), 1);
         }
     }
 
@@ -280,7 +276,6 @@ void nbrx::set_demod(int rx_demod)
             connect(demod, 0, audio_rr0, 0);
 
             connect(audio_rr0, 0, self(), 0);
-            connect(audio_rr0, 0, self(), 1);
         }
     }
     else
@@ -293,11 +288,16 @@ void nbrx::set_demod(int rx_demod)
         else
         {
             connect(demod, 0, self(), 0);
-            connect(demod, 0, self(), 1);
         }
     }
 }
 
+/*! \brief Raw I/Q output is two channels, demodulated audio is mono. */
+int nbrx::audio_channels()
+{
+    return (d_demod == NBRX_DEMOD_NONE) ? 2 : 1;
+}
+
 void nbrx::set_fm_maxdev(float maxdev_hz)
 {
     demod_fm->set_max_dev(maxdev_hz);
@@ -37,6 +37,9 @@
 //#include "dsp/resampler_ff.h"
 #include "dsp/resampler_xx.h"
 
+/*! \brief Internal sample rate of the narrow band demodulators. */
+#define NBRX_QUAD_RATE  96000.f
+
 class nbrx;
 
 #if GNURADIO_VERSION < 0x030900
@@ -100,6 +103,7 @@ public:
     void set_agc_manual_gain(int gain);
 
     void set_demod(int demod);
+    int  audio_channels();
 
     /* FM parameters */
     bool has_fm() { return true; }
@@ -64,6 +64,12 @@ public:
 
     virtual void set_demod(int demod) = 0;
 
+    /*! \brief Number of audio outputs used by the current demodulator.
+     *
+     * Mono receivers only connect output 0, stereo ones outputs 0 and 1.
+     */
+    virtual int audio_channels() = 0;
+
     /* the rest is optional */
 
     /* Noise blanker */
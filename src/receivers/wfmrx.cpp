@@ -26,7 +26,7 @@
 #include <QDebug>
 #include "receivers/wfmrx.h"
 
-#define PREF_QUAD_RATE   240e3f // Nominal channel spacing is 200 kHz
+#define PREF_QUAD_RATE  WFMRX_QUAD_RATE
 
 wfmrx_sptr make_wfmrx(float quad_rate, float audio_rate)
 {
@@ -63,8 +63,7 @@ wfmrx::wfmrx(float quad_rate, float audio_rate)
     connect(filter, 0, sql, 0);
     connect(sql, 0, demod_fm, 0);
     connect(demod_fm, 0, mono, 0);
-    connect(mono, 0, self(), 0); // left  channel
-    connect(mono, 1, self(), 1); // right channel
+    connect(mono, 0, self(), 0);
 }
 
 wfmrx::~wfmrx()
@@ -188,8 +187,7 @@ void wfmrx::set_demod(int demod)
     case WFMRX_DEMOD_MONO:
     default:
         disconnect(demod_fm, 0, mono, 0);
-        disconnect(mono, 0, self(), 0); // left  channel
-        disconnect(mono, 1, self(), 1); // right channel
+        disconnect(mono, 0, self(), 0);
         break;
 
     case WFMRX_DEMOD_STEREO:
@@ -210,8 +208,7 @@ void wfmrx::set_demod(int demod)
     case WFMRX_DEMOD_MONO:
     default:
         connect(demod_fm, 0, mono, 0);
-        connect(mono, 0, self(), 0); // left  channel
-        connect(mono, 1, self(), 1); // right channel
+        connect(mono, 0, self(), 0);
         break;
 
     case WFMRX_DEMOD_STEREO:
@@ -232,6 +229,11 @@ void wfmrx::set_demod(int demod)
     unlock();
 }
 
+int wfmrx::audio_channels()
+{
+    return (d_demod == WFMRX_DEMOD_MONO) ? 1 : 2;
+}
+
 void wfmrx::set_fm_maxdev(float maxdev_hz)
 {
     demod_fm->set_max_dev(maxdev_hz);
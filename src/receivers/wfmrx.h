@@ -36,6 +36,9 @@
 #include "dsp/rds/decoder.h"
 #include "dsp/rds/parser.h"
 
+/*! \brief Internal sample rate of the WFM demodulator. Nominal channel spacing is 200 kHz. */
+#define WFMRX_QUAD_RATE  240e3f
+
 class wfmrx;
 
 #if GNURADIO_VERSION < 0x030900
@@ -96,6 +99,7 @@ public:
     void set_agc_manual_gain(int gain);*/
 
     void set_demod(int demod);
+    int  audio_channels();
 
     /* FM parameters */
     bool has_fm() {return true; }